@@ -0,0 +1,90 @@
+#include "alloc_counter.hpp"
+
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+namespace bench {
+
+namespace {
+
+std::atomic<std::uint64_t> allocations_count { 0u };
+
+void* allocate(std::size_t size) {
+  allocations_count.fetch_add(1u, std::memory_order_relaxed);
+
+  if (void* ptr = std::malloc(size ? size : 1u)) {
+    return ptr;
+  }
+
+  throw std::bad_alloc();
+}
+
+void* allocate(std::size_t size, std::align_val_t alignment) {
+  allocations_count.fetch_add(1u, std::memory_order_relaxed);
+
+  const auto align = static_cast<std::size_t>(alignment);
+  
+  // aligned_alloc требует размер, кратный выравниванию
+  if (void* ptr = std::aligned_alloc(align, (size + align - 1) / align * align)) {
+    return ptr;
+  }
+
+  throw std::bad_alloc();
+}
+
+} // namespace
+
+std::uint64_t allocations() noexcept {
+  return allocations_count.load(std::memory_order_relaxed);
+}
+
+} // namespace bench
+
+void* operator new(std::size_t size) {
+  return bench::allocate(size);
+}
+
+void* operator new[](std::size_t size) {
+  return bench::allocate(size);
+}
+
+void* operator new(std::size_t size, std::align_val_t alignment) {
+  return bench::allocate(size, alignment);
+}
+
+void* operator new[](std::size_t size, std::align_val_t alignment) {
+  return bench::allocate(size, alignment);
+}
+
+void operator delete(void* ptr) noexcept {
+  std::free(ptr);
+}
+
+void operator delete[](void* ptr) noexcept {
+  std::free(ptr);
+}
+
+void operator delete(void* ptr, std::size_t) noexcept {
+  std::free(ptr);
+}
+
+void operator delete[](void* ptr, std::size_t) noexcept {
+  std::free(ptr);
+}
+
+void operator delete(void* ptr, std::align_val_t) noexcept {
+  std::free(ptr);
+}
+
+void operator delete[](void* ptr, std::align_val_t) noexcept {
+  std::free(ptr);
+}
+
+void operator delete(void* ptr, std::size_t, std::align_val_t) noexcept {
+  std::free(ptr);
+}
+
+void operator delete[](void* ptr, std::size_t, std::align_val_t) noexcept {
+  std::free(ptr);
+}
@@ -0,0 +1,34 @@
+#pragma once
+
+#include <cstdint>
+
+#include <benchmark/benchmark.h>
+
+namespace bench {
+
+// Количество выделений памяти через operator new с момента запуска
+[[nodiscard]] std::uint64_t allocations() noexcept;
+
+// Добавляет к результату бенчмарка счётчик allocs - среднее количество
+// выделений памяти за итерацию. Создаётся непосредственно перед циклом измерений
+class AllocationCounter final {
+public:
+  explicit AllocationCounter(benchmark::State& state) noexcept
+    : state_(state)
+    , start_(allocations()) {
+  }
+
+  ~AllocationCounter() {
+    state_.counters["allocs"] = benchmark::Counter(
+      static_cast<double>(allocations() - start_), benchmark::Counter::kAvgIterations);
+  }
+
+  AllocationCounter(const AllocationCounter&) = delete;
+  AllocationCounter& operator=(const AllocationCounter&) = delete;
+
+private:
+  benchmark::State& state_;
+  std::uint64_t start_;
+};
+
+} // namespace bench
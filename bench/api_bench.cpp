@@ -0,0 +1,126 @@
+#include "alloc_counter.hpp"
+#include "fixtures.hpp"
+
+#include "../src/endpoint.hpp"
+#include "../src/mux.hpp"
+#include "../src/player.hpp"
+#include "../src/response.hpp"
+#include "../src/action_parser.hpp"
+
+#include <array>
+
+namespace {
+
+using namespace std::literals;
+
+// Маршруты в том же порядке, что и в приложении
+mux::Router make_router() {
+  mux::Router router;
+
+  router.set_route(endpoint::GetIndex().route());
+  router.set_route(endpoint::GetFile().route());
+  router.set_route(endpoint::GetMapsList().route());
+  router.set_route(endpoint::GameJoin().route());
+  router.set_route(endpoint::GetPlayers().route());
+  router.set_route(endpoint::GetMapInfo().route());
+  router.set_route(endpoint::GetGameState().route());
+  router.set_route(endpoint::PlayerAction().route());
+  router.set_route(endpoint::GetRecords().route());
+
+  return router;
+}
+
+void BM_RouterProcess(benchmark::State& state) {
+  const auto router = make_router();
+
+  constexpr std::array targets {
+    "/api/v1/game/state"sv,
+    "/api/v1/game/player/action"sv,
+    "/api/v1/maps/map1"sv,
+    "/index.html"sv
+  };
+
+  std::size_t i = 0;
+
+  bench::AllocationCounter allocs(state);
+
+  for (auto _ : state) {
+    common::http_string_request_t req { common::http::verb::get, targets[i++ % targets.size()], 11 };
+
+    auto match = router.process(req);
+    benchmark::DoNotOptimize(match);
+  }
+
+  state.SetItemsProcessed(state.iterations());
+}
+
+void BM_GameStateResponse(benchmark::State& state) {
+  const auto players = static_cast<std::size_t>(state.range(0));
+
+  bench::net::io_context io;
+  const bench::GridMap grid(16u);
+  const auto session = bench::make_session(io, grid, players, players);
+
+  std::int64_t bytes = 0;
+
+  bench::AllocationCounter allocs(state);
+
+  for (auto _ : state) {
+    response::GameState fields(11, true, *session);
+
+    bytes += static_cast<std::int64_t>(fields.body().size());
+    benchmark::DoNotOptimize(fields);
+  }
+
+  state.SetItemsProcessed(state.iterations() * static_cast<std::int64_t>(players));
+  state.SetBytesProcessed(bytes);
+}
+
+// Разбор тела действия и поиск игрока по заголовку Authorization
+void BM_PlayerActionDecode(benchmark::State& state) {
+  bench::net::io_context io;
+  const bench::GridMap grid(16u);
+  const auto session = bench::make_session(io, grid, 1u, 0u);
+
+  const auto token = "0123456789abcdef0123456789abcdef"s;
+  const auto& [id, character] = *session->characters().begin();
+
+  app::Players::instance().add_player(token, std::make_unique<app::Player>(id, character, *session));
+
+  const auto header = "Bearer "s + token;
+  const auto body = R"({"move":"L"})"s;
+
+  bench::AllocationCounter allocs(state);
+
+  for (auto _ : state) {
+    const auto direct = action_parser::parse_move(body);
+    const auto player = app::Players::instance().find_by_token(app::extract_token(header));
+
+    benchmark::DoNotOptimize(direct);
+    benchmark::DoNotOptimize(player);
+  }
+
+  state.SetItemsProcessed(state.iterations());
+
+  app::Players::instance().remove(*character);
+}
+
+void BM_PlayerTokenGetNew(benchmark::State& state) {
+  app::PlayerToken token;
+
+  bench::AllocationCounter allocs(state);
+
+  for (auto _ : state) {
+    auto value = token.get_new();
+    benchmark::DoNotOptimize(value);
+  }
+
+  state.SetItemsProcessed(state.iterations());
+}
+
+} // namespace
+
+BENCHMARK(BM_RouterProcess);
+BENCHMARK(BM_GameStateResponse)->ArgName("players")->Arg(1)->Arg(8)->Arg(64);
+BENCHMARK(BM_PlayerActionDecode);
+BENCHMARK(BM_PlayerTokenGetNew);
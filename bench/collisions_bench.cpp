@@ -0,0 +1,120 @@
+#include "alloc_counter.hpp"
+#include "fixtures.hpp"
+
+#include "../src/collisions.hpp"
+
+namespace {
+
+// Провайдер с players собирателями и loot предметами на карте grid
+collisions::LootCharacterProvider make_provider(const bench::GridMap& grid, std::size_t players, std::size_t loot) {
+  collisions::LootCharacterProvider provider;
+  util::Xoshiro256 rng(42u);
+
+  for (std::size_t i = 0; i < loot; i++) {
+    provider.add_object(collisions::Item(grid.road_position(rng), model::Loot::WIDTH, static_cast<model::LootPool::Handle>(i)));
+  }
+
+  for (std::size_t i = 0; i < players; i++) {
+    const auto start = grid.road_position(rng);
+    const geom::Position end { start.x + bench::GridMap::STEP / 2.0, start.y };
+
+    provider.add_gatherer({ .start_pos = start, .end_pos = end, .width = 0.6, .id = i });
+  }
+
+  return provider;
+}
+
+void BM_FindGatherEvents(benchmark::State& state) {
+  const auto players = static_cast<std::size_t>(state.range(0));
+  const auto loot = static_cast<std::size_t>(state.range(1));
+
+  const bench::GridMap grid(16u);
+  const auto provider = make_provider(grid, players, loot);
+
+  bench::AllocationCounter allocs(state);
+
+  for (auto _ : state) {
+    auto events = collisions::find_gather_events(provider);
+    benchmark::DoNotOptimize(events);
+  }
+
+  // Пары "собиратель - предмет", проверенные за итерацию
+  state.SetItemsProcessed(state.iterations() * static_cast<std::int64_t>(players * loot));
+}
+
+// Один собиратель против objects объектов: скалярная проверка через try_collect_point
+void BM_CollectScalar(benchmark::State& state) {
+  const auto count = static_cast<std::size_t>(state.range(0));
+
+  const bench::GridMap grid(16u);
+  const auto provider = make_provider(grid, 1u, count);
+  const auto& gatherer = provider.get_gatherer(0);
+
+  std::size_t hits = 0;
+
+  bench::AllocationCounter allocs(state);
+
+  for (auto _ : state) {
+    for (std::size_t i = 0; i < count; i++) {
+      const auto& object = provider.get_object(i);
+      const auto result = collisions::try_collect_point(gatherer.start_pos, gatherer.end_pos, object.position);
+
+      hits += result.is_collected(gatherer.width + object.width);
+    }
+  }
+
+  benchmark::DoNotOptimize(hits);
+  state.SetItemsProcessed(state.iterations() * static_cast<std::int64_t>(count));
+}
+
+// То же для пакетной проверки реализацией, заданной первым аргументом
+void BM_CollectBatch(benchmark::State& state) {
+  const auto kernel = static_cast<collisions::Kernel>(state.range(0));
+  const auto count = static_cast<std::size_t>(state.range(1));
+
+  if (!collisions::is_supported(kernel)) {
+    state.SkipWithError("kernel is not supported by the CPU");
+    return;
+  }
+
+  const bench::GridMap grid(16u);
+  const auto provider = make_provider(grid, 1u, count);
+  const auto& gatherer = provider.get_gatherer(0);
+
+  collisions::ObjectsBatch objects;
+
+  for (std::size_t i = 0; i < count; i++) {
+    objects.add(provider.get_object(i).position, provider.get_object(i).width);
+  }
+
+  collisions::HitMask hits;
+
+  bench::AllocationCounter allocs(state);
+
+  for (auto _ : state) {
+    collisions::find_hits(gatherer, objects, hits, kernel);
+    benchmark::DoNotOptimize(hits.data());
+  }
+
+  state.SetItemsProcessed(state.iterations() * static_cast<std::int64_t>(count));
+}
+
+} // namespace
+
+BENCHMARK(BM_CollectScalar)->ArgName("objects")->Arg(64)->Arg(1024);
+
+BENCHMARK(BM_CollectBatch)
+  ->ArgNames({ "kernel", "objects" })
+  ->ArgsProduct({ 
+    { static_cast<int>(collisions::Kernel::scalar), static_cast<int>(collisions::Kernel::sse2), static_cast<int>(collisions::Kernel::avx2) }, 
+    { 64, 1024 } 
+  });
+
+BENCHMARK(BM_FindGatherEvents)
+  ->ArgNames({ "players", "loot" })
+  ->Args({ 1, 1 })
+  ->Args({ 8, 8 })
+  ->Args({ 8, 64 })
+  ->Args({ 64, 64 })
+  ->Args({ 64, 512 })
+  ->Args({ 256, 1024 });
@@ -0,0 +1,89 @@
+#pragma once
+
+#include "../src/game.hpp"
+#include "../src/random.hpp"
+
+#include <memory>
+#include <string>
+
+#include <boost/asio/io_context.hpp>
+#include <boost/asio/strand.hpp>
+
+namespace bench {
+
+namespace net = boost::asio;
+
+// Квадратная сетка из size горизонтальных и size вертикальных дорог с шагом STEP
+class GridMap final {
+public:
+  constexpr static geom::Coord STEP { 10.0 };
+
+  explicit GridMap(std::size_t size)
+    : map_(model::Map::Id("grid"), "Grid") {
+    const auto end = STEP * static_cast<geom::Coord>(size - 1);
+
+    for (std::size_t i = 0; i < size; i++) {
+      const auto offset = STEP * static_cast<geom::Coord>(i);
+
+      map_.add_road(model::Road(model::Road::HORIZONTAL, { 0.0, offset }, end));
+      map_.add_road(model::Road(model::Road::VERTICAL, { offset, 0.0 }, end));
+    }
+
+    map_.add_office(model::Office(model::Office::Id("office"), { 0.0, 0.0 }, { 0, 0 }));
+    map_.add_loot_type("key", 10u);
+    map_.add_loot_type("wallet", 30u);
+  }
+
+  [[nodiscard]] const model::Map& map() const noexcept {
+    return map_;
+  }
+
+  // Случайная точка на одной из дорог
+  [[nodiscard]] geom::Position road_position(util::Xoshiro256& rng) const {
+    const auto& roads = map_.get_roads();
+    const auto& road = roads[rng() % roads.size()];
+
+    const auto t = static_cast<double>(rng() % 1000u) / 1000.0;
+
+    return {
+      road.get_start().x + (road.get_end().x - road.get_start().x) * t,
+      road.get_start().y + (road.get_end().y - road.get_start().y) * t
+    };
+  }
+
+private:
+  model::Map map_;
+};
+
+// Сессия с players персонажами, у каждого из которых в рюкзаке 
+// по одному предмету, и loot потерянными предметами на карте
+inline std::shared_ptr<model::GameSession> make_session(net::io_context& io, const GridMap& grid, std::size_t players, std::size_t loot) {
+  model::GameSessionConfig cfg;
+
+  cfg.randomize_spawn = true;
+  cfg.seed = 42u;
+  cfg.max_players = static_cast<std::uint16_t>(players);
+  cfg.characters_speed = 1.0;
+
+  auto session = std::make_shared<model::GameSession>(1u, cfg, grid.map(), net::make_strand(io));
+  util::Xoshiro256 rng(cfg.seed);
+
+  model::Loot::Id loot_id = 1u;
+
+  for (std::size_t i = 0; i < players; i++) {
+    auto dog = model::create_character<model::Dog>("dog" + std::to_string(i), cfg.bag_capacity);
+
+    dog->position(grid.road_position(rng));
+    dog->bagpack.add({ .id = loot_id++, .type = 0u, .value = 10u, .position = {} });
+
+    session->restore_character(i, std::move(dog));
+  }
+
+  for (std::size_t i = 0; i < loot; i++) {
+    session->restore_lost_object({ .id = loot_id++, .type = 1u, .value = 30u, .position = grid.road_position(rng) });
+  }
+
+  return session;
+}
+
+} // namespace bench
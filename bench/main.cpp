@@ -0,0 +1,7 @@
+// Бенчмарки горячих путей сервера.
+// Результат в формате JSON: --benchmark_format=json или
+// --benchmark_out=<file> --benchmark_out_format=json
+
+#include <benchmark/benchmark.h>
+
+BENCHMARK_MAIN();
@@ -0,0 +1,64 @@
+#include "alloc_counter.hpp"
+#include "fixtures.hpp"
+
+#include "../src/core.hpp"
+
+#include <vector>
+
+namespace {
+
+constexpr std::size_t POSITIONS_COUNT { 1024u };
+
+std::vector<geom::Position> make_positions(const bench::GridMap& grid) {
+  std::vector<geom::Position> positions;
+  positions.reserve(POSITIONS_COUNT);
+
+  util::Xoshiro256 rng(42u);
+
+  for (std::size_t i = 0; i < POSITIONS_COUNT; i++) {
+    positions.push_back(grid.road_position(rng));
+  }
+
+  return positions;
+}
+
+void BM_CalculateObjectPosition(benchmark::State& state) {
+  const bench::GridMap grid(static_cast<std::size_t>(state.range(0)));
+  const core::GameEngine engine(grid.map());
+
+  const auto positions = make_positions(grid);
+  const geom::Speed speed { 1.0, 0.0 };
+
+  std::size_t i = 0;
+
+  bench::AllocationCounter allocs(state);
+
+  for (auto _ : state) {
+    auto position = engine.calculate_object_position(positions[i++ % POSITIONS_COUNT], speed, 100);
+    benchmark::DoNotOptimize(position);
+  }
+
+  state.SetItemsProcessed(state.iterations());
+}
+
+void BM_GetRoadByPosition(benchmark::State& state) {
+  const bench::GridMap grid(static_cast<std::size_t>(state.range(0)));
+  const auto positions = make_positions(grid);
+
+  std::size_t i = 0;
+
+  bench::AllocationCounter allocs(state);
+
+  for (auto _ : state) {
+    auto road = grid.map().get_road_by_position(positions[i++ % POSITIONS_COUNT]);
+    benchmark::DoNotOptimize(road);
+  }
+
+  state.SetItemsProcessed(state.iterations());
+}
+
+} // namespace
+
+// Аргумент - количество дорог каждого направления
+BENCHMARK(BM_CalculateObjectPosition)->ArgName("roads")->Arg(4)->Arg(16)->Arg(64);
+BENCHMARK(BM_GetRoadByPosition)->ArgName("roads")->Arg(4)->Arg(16)->Arg(64);
@@ -0,0 +1,69 @@
+#include "alloc_counter.hpp"
+#include "fixtures.hpp"
+
+#include "../src/serialization.hpp"
+
+#include <sstream>
+
+namespace {
+
+std::string save(const model::GameSession& session) {
+  std::ostringstream ss;
+
+  {
+    serialization::OutputArchive oa { ss };
+    oa << serialization::GameStateSerializer({ serialization::SessionSerializer(session, 1u) }, {}, 1u);
+  }
+
+  return ss.str();
+}
+
+void BM_SnapshotSave(benchmark::State& state) {
+  const auto players = static_cast<std::size_t>(state.range(0));
+
+  bench::net::io_context io;
+  const bench::GridMap grid(16u);
+  const auto session = bench::make_session(io, grid, players, players);
+
+  std::int64_t bytes = 0;
+
+  bench::AllocationCounter allocs(state);
+
+  for (auto _ : state) {
+    const auto data = save(*session);
+
+    bytes += static_cast<std::int64_t>(data.size());
+    benchmark::DoNotOptimize(data.data());
+  }
+
+  state.SetItemsProcessed(state.iterations() * static_cast<std::int64_t>(players));
+  state.SetBytesProcessed(bytes);
+}
+
+void BM_SnapshotLoad(benchmark::State& state) {
+  const auto players = static_cast<std::size_t>(state.range(0));
+
+  bench::net::io_context io;
+  const bench::GridMap grid(16u);
+  const auto data = save(*bench::make_session(io, grid, players, players));
+
+  bench::AllocationCounter allocs(state);
+
+  for (auto _ : state) {
+    std::istringstream ss(data);
+    serialization::InputArchive ia { ss };
+
+    serialization::GameStateSerializer snapshot;
+    ia >> snapshot;
+
+    benchmark::DoNotOptimize(snapshot);
+  }
+
+  state.SetItemsProcessed(state.iterations() * static_cast<std::int64_t>(players));
+  state.SetBytesProcessed(state.iterations() * static_cast<std::int64_t>(data.size()));
+}
+
+} // namespace
+
+BENCHMARK(BM_SnapshotSave)->ArgName("players")->Arg(1)->Arg(8)->Arg(64);
+BENCHMARK(BM_SnapshotLoad)->ArgName("players")->Arg(1)->Arg(8)->Arg(64);
@@ -0,0 +1,72 @@
+#pragma once
+
+#include "character.hpp"
+
+#include <optional>
+#include <string_view>
+
+namespace action_parser {
+
+using namespace std::literals;
+
+using Direct = model::Character::Direction::Direct;
+
+namespace detail {
+
+constexpr bool is_space(char c) noexcept {
+  return c == ' ' || c == '\t' || c == '\n' || c == '\r';
+}
+
+constexpr void skip_spaces(std::string_view& str) noexcept {
+  while (!str.empty() && is_space(str.front())) {
+    str.remove_prefix(1);
+  }
+}
+
+constexpr bool consume(std::string_view& str, std::string_view token) noexcept {
+  skip_spaces(str);
+
+  if (!str.starts_with(token)) {
+    return false;
+  }
+
+  str.remove_prefix(token.size());
+  return true;
+}
+
+} // namespace detail
+
+// Разбирает тело вида {"move": "X"} без выделения памяти. Если тело
+// не совпадает со схемой буквально (другие поля, экранированные символы,
+// неизвестное направление), возвращает std::nullopt: такое тело
+// разбирается общим JSON-парсером
+[[nodiscard]] constexpr std::optional<Direct> parse_move(std::string_view body) noexcept {
+  using detail::consume;
+
+  if (!consume(body, "{"sv) || !consume(body, "\"move\""sv) || !consume(body, ":"sv) || !consume(body, "\""sv)) {
+    return std::nullopt;
+  }
+
+  const auto end = body.find('"');
+
+  if (end == std::string_view::npos) {
+    return std::nullopt;
+  }
+
+  const auto letter = body.substr(0, end);
+  body.remove_prefix(end + 1);
+
+  if (!consume(body, "}"sv)) {
+    return std::nullopt;
+  }
+
+  detail::skip_spaces(body);
+
+  if (!body.empty()) {
+    return std::nullopt;
+  }
+
+  return model::Character::Direction::from_letter(letter);
+}
+
+} // namespace action_parser
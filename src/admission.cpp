@@ -0,0 +1,222 @@
+#include "admission.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+#include <utility>
+
+namespace admission {
+
+using namespace std::literals;
+
+Ticket::Ticket(Controller* controller, const Key& key) noexcept
+  : controller_(controller)
+  , key_(key) {
+}
+
+Ticket::Ticket(Ticket&& other) noexcept
+  : controller_(std::exchange(other.controller_, nullptr))
+  , key_(other.key_) {
+}
+
+Ticket& Ticket::operator=(Ticket&& other) noexcept {
+  if (this != &other) {
+    reset();
+
+    controller_ = std::exchange(other.controller_, nullptr);
+    key_ = other.key_;
+  }
+
+  return *this;
+}
+
+Ticket::~Ticket() {
+  reset();
+}
+
+bool Ticket::allow_request(Clock::time_point now) {
+  return !controller_ || controller_->take_token(key_, now);
+}
+
+Ticket::operator bool() const noexcept {
+  return controller_ != nullptr;
+}
+
+void Ticket::reset() noexcept {
+  if (controller_) {
+    controller_->release(key_);
+    controller_ = nullptr;
+  }
+}
+
+std::size_t Controller::KeyHasher::operator()(const Ticket::Key& key) const noexcept {
+  std::uint64_t hi, lo;
+
+  std::memcpy(&hi, key.data(), sizeof(hi));
+  std::memcpy(&lo, key.data() + sizeof(hi), sizeof(lo));
+
+  // Перемешивание из splitmix64: младшие биты хеша используются для выбора шарда
+  auto h = hi ^ (lo + 0x9e3779b97f4a7c15ull + (hi << 6) + (hi >> 2));
+
+  h = (h ^ (h >> 30)) * 0xbf58476d1ce4e5b9ull;
+  h = (h ^ (h >> 27)) * 0x94d049bb133111ebull;
+
+  return static_cast<std::size_t>(h ^ (h >> 31));
+}
+
+Controller::Controller(Limits limits)
+  : limits_(limits) {
+
+  if (limits_.requests_per_second < 0.0 || limits_.request_burst < 0.0) {
+    throw std::invalid_argument("Invalid request rate limit"s);
+  }
+
+  // Без явной ёмкости корзина вмещает запросы за одну секунду
+  if (limits_.requests_per_second > 0.0 && limits_.request_burst < 1.0) {
+    limits_.request_burst = std::max(limits_.requests_per_second, 1.0);
+  }
+}
+
+std::pair<Verdict, Ticket> Controller::admit(const net::ip::address& address, Clock::time_point now) {
+  // Место резервируется до проверки адреса, чтобы предел не превышался при одновременных вызовах
+  const auto connections = connections_.fetch_add(1u) + 1u;
+
+  if (limits_.max_connections && connections > limits_.max_connections) {
+    connections_.fetch_sub(1u);
+    rejected_busy_++;
+
+    return { Verdict::server_busy, Ticket{} };
+  }
+
+  const auto key = make_key(address);
+  auto& shard = this->shard(key);
+
+  {
+    std::lock_guard lock(shard.mutex);
+
+    auto [it, inserted] = shard.entries.try_emplace(key);
+    auto& entry = it->second;
+
+    if (inserted) {
+      entry.tokens = limits_.request_burst;
+      entry.refilled = now;
+    }
+
+    if (limits_.max_connections_per_ip && entry.connections >= limits_.max_connections_per_ip) {
+      connections_.fetch_sub(1u);
+      rejected_per_ip_++;
+
+      return { Verdict::too_many_connections, Ticket{} };
+    }
+
+    entry.connections++;
+  }
+
+  accepted_++;
+
+  return { Verdict::accepted, Ticket(this, key) };
+}
+
+void Controller::prune(Clock::time_point now) {
+  for (auto& shard : shards_) {
+    std::lock_guard lock(shard.mutex);
+
+    for (auto it = shard.entries.begin(); it != shard.entries.end();) {
+      auto& entry = it->second;
+      refill(entry, now);
+
+      if (entry.connections == 0u && entry.tokens >= limits_.request_burst) {
+        it = shard.entries.erase(it);
+      } else {
+        ++it;
+      }
+    }
+  }
+}
+
+Controller::Stats Controller::stats() const {
+  Stats stats;
+
+  stats.connections = connections_.load();
+  stats.accepted = accepted_.load();
+  stats.rejected_busy = rejected_busy_.load();
+  stats.rejected_per_ip = rejected_per_ip_.load();
+  stats.rejected_requests = rejected_requests_.load();
+
+  for (const auto& shard : shards_) {
+    std::lock_guard lock(shard.mutex);
+    stats.addresses += shard.entries.size();
+  }
+
+  return stats;
+}
+
+const Limits& Controller::limits() const noexcept {
+  return limits_;
+}
+
+Ticket::Key Controller::make_key(const net::ip::address& address) {
+  if (address.is_v4()) {
+    return net::ip::make_address_v6(net::ip::v4_mapped, address.to_v4()).to_bytes();
+  }
+
+  return address.to_v6().to_bytes();
+}
+
+Controller::Shard& Controller::shard(const Ticket::Key& key) noexcept {
+  return shards_[KeyHasher{}(key) % SHARDS];
+}
+
+bool Controller::take_token(const Ticket::Key& key, Clock::time_point now) {
+  if (limits_.requests_per_second <= 0.0) {
+    return true;
+  }
+
+  auto& shard = this->shard(key);
+  std::lock_guard lock(shard.mutex);
+
+  const auto it = shard.entries.find(key);
+
+  if (it == shard.entries.end()) {
+    return true;
+  }
+
+  auto& entry = it->second;
+  refill(entry, now);
+
+  if (entry.tokens < 1.0) {
+    rejected_requests_++;
+    return false;
+  }
+
+  entry.tokens -= 1.0;
+
+  return true;
+}
+
+void Controller::refill(Entry& entry, Clock::time_point now) const noexcept {
+  if (now <= entry.refilled) {
+    return;
+  }
+
+  const std::chrono::duration<double> elapsed = now - entry.refilled;
+
+  entry.tokens = std::min(limits_.request_burst, entry.tokens + elapsed.count() * limits_.requests_per_second);
+  entry.refilled = now;
+}
+
+void Controller::release(const Ticket::Key& key) noexcept {
+  auto& shard = this->shard(key);
+
+  {
+    std::lock_guard lock(shard.mutex);
+
+    if (const auto it = shard.entries.find(key); it != shard.entries.end() && it->second.connections > 0u) {
+      it->second.connections--;
+    }
+  }
+
+  connections_.fetch_sub(1u);
+}
+
+} // namespace admission
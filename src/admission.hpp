@@ -0,0 +1,149 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <mutex>
+#include <unordered_map>
+
+#include <boost/asio/ip/address.hpp>
+
+namespace admission {
+
+namespace net = boost::asio;
+
+using Clock = std::chrono::steady_clock;
+
+struct Limits {
+  // Нулевое значение снимает ограничение
+  std::size_t max_connections { 0u };
+  std::size_t max_connections_per_ip { 0u };
+
+  // Корзина запросов одного адреса: скорость пополнения и ёмкость
+  double requests_per_second { 0.0 };
+  double request_burst { 0.0 };
+
+  // Без пределов допуск не проверяется и соединения не учитываются
+  [[nodiscard]] bool enabled() const noexcept {
+    return max_connections != 0u || max_connections_per_ip != 0u || requests_per_second > 0.0;
+  }
+};
+
+enum class Verdict : std::uint8_t {
+  accepted,
+  server_busy,          // достигнут общий предел соединений
+  too_many_connections  // достигнут предел соединений с адреса
+};
+
+class Controller;
+
+// Место соединения в Controller, освобождается при уничтожении.
+// Controller должен существовать дольше всех выданных мест
+class Ticket {
+public:
+  using Key = std::array<unsigned char, 16>;
+
+  Ticket() = default;
+
+  Ticket(const Ticket&) = delete;
+  Ticket& operator=(const Ticket&) = delete;
+
+  Ticket(Ticket&& other) noexcept;
+  Ticket& operator=(Ticket&& other) noexcept;
+
+  ~Ticket();
+
+  // Забирает токен из корзины запросов адреса. Без Controller всегда разрешает
+  [[nodiscard]] bool allow_request(Clock::time_point now = Clock::now());
+
+  explicit operator bool() const noexcept;
+
+private:
+  friend class Controller;
+
+  Ticket(Controller* controller, const Key& key) noexcept;
+
+  void reset() noexcept;
+
+private:
+  Controller* controller_ { nullptr };
+  Key key_ {};
+};
+
+/*
+ * Контроль допуска соединений.
+ *
+ * Общее число соединений ограничивается атомарным счётчиком. Для каждого
+ * адреса хранятся число его соединений и корзина токенов для запросов.
+ * Записи адресов распределены по шардам с отдельными мьютексами, поэтому
+ * соединения с разных адресов редко конкурируют за одну блокировку.
+ * IPv4-адреса хранятся как IPv4-mapped IPv6, ключ занимает 16 байт.
+ */
+class Controller {
+public:
+  struct Stats {
+    std::size_t connections { 0u };
+    std::size_t addresses { 0u };
+
+    std::uint64_t accepted { 0u };
+    std::uint64_t rejected_busy { 0u };
+    std::uint64_t rejected_per_ip { 0u };
+    std::uint64_t rejected_requests { 0u };
+  };
+
+  explicit Controller(Limits limits = {});
+
+  Controller(const Controller&) = delete;
+  Controller& operator=(const Controller&) = delete;
+
+  // Учитывает новое соединение с адреса address. При отказе Ticket пуст
+  [[nodiscard]] std::pair<Verdict, Ticket> admit(const net::ip::address& address, Clock::time_point now = Clock::now());
+
+  // Удаляет записи адресов без соединений, корзины которых успели заполниться
+  void prune(Clock::time_point now = Clock::now());
+
+  [[nodiscard]] Stats stats() const;
+  [[nodiscard]] const Limits& limits() const noexcept;
+
+private:
+  friend class Ticket;
+
+  static constexpr std::size_t SHARDS = 64u;
+
+  struct KeyHasher {
+    std::size_t operator()(const Ticket::Key& key) const noexcept;
+  };
+
+  struct Entry {
+    std::size_t connections { 0u };
+    double tokens { 0.0 };
+    Clock::time_point refilled;
+  };
+
+  struct Shard {
+    mutable std::mutex mutex;
+    std::unordered_map<Ticket::Key, Entry, KeyHasher> entries;
+  };
+
+  [[nodiscard]] static Ticket::Key make_key(const net::ip::address& address);
+
+  [[nodiscard]] Shard& shard(const Ticket::Key& key) noexcept;
+  [[nodiscard]] bool take_token(const Ticket::Key& key, Clock::time_point now);
+  void refill(Entry& entry, Clock::time_point now) const noexcept;
+  void release(const Ticket::Key& key) noexcept;
+
+private:
+  Limits limits_;
+
+  std::array<Shard, SHARDS> shards_;
+
+  std::atomic<std::size_t> connections_ { 0u };
+
+  std::atomic<std::uint64_t> accepted_ { 0u };
+  std::atomic<std::uint64_t> rejected_busy_ { 0u };
+  std::atomic<std::uint64_t> rejected_per_ip_ { 0u };
+  std::atomic<std::uint64_t> rejected_requests_ { 0u };
+};
+
+} // namespace admission
@@ -5,10 +5,27 @@
 #include "ticker.hpp"
 #include "loot.hpp"
 #include "serialization.hpp"
+#include "player.hpp"
+#include "state.hpp"
+#include "handoff.hpp"
+#include "tracing.hpp"
 
+#include <algorithm>
+#include <functional>
+#include <iterator>
+#include <utility>
 #include <vector>
 
 #include <boost/asio/signal_set.hpp>
+#include <boost/asio/steady_timer.hpp>
+#include <boost/system/system_error.hpp>
+
+#include <cerrno>
+#include <cstring>
+
+#include <pthread.h>
+#include <sched.h>
+#include <unistd.h>
 
 namespace app {
 
@@ -17,7 +34,88 @@ namespace sys = boost::system;
 
 using namespace std::literals;
 
-mux::Router App::get_router() const {
+namespace {
+
+// Сервер продолжает работать без закрепления, но потоки могут оказаться на одном ядре
+void log_pin_failure(unsigned index, int error) {
+  LOG_WARN << JSON_DATA(
+    {"thread"sv, index},
+    {"text"sv, std::strerror(error)}
+  )
+  << "failed to pin thread to a core"sv;
+}
+
+// Закрепляет текущий поток за index-м по счёту ядром из доступных процессу
+void pin_thread(unsigned index) {
+  cpu_set_t allowed;
+  CPU_ZERO(&allowed);
+
+  if (::sched_getaffinity(0, sizeof(allowed), &allowed) != 0) {
+    return log_pin_failure(index, errno);
+  }
+
+  if (CPU_COUNT(&allowed) == 0) {
+    return;
+  }
+
+  auto target = index % static_cast<unsigned>(CPU_COUNT(&allowed));
+
+  for (int cpu = 0; cpu < CPU_SETSIZE; cpu++) {
+    if (CPU_ISSET(cpu, &allowed) && target-- == 0) {
+      cpu_set_t set;
+      CPU_ZERO(&set);
+      CPU_SET(cpu, &set);
+
+      // pthread_setaffinity_np возвращает код ошибки, а не записывает его в errno
+      if (const auto error = ::pthread_setaffinity_np(::pthread_self(), sizeof(set), &set); error != 0) {
+        log_pin_failure(index, error);
+      }
+
+      return;
+    }
+  }
+}
+
+// Ждёт отправки ответов на обрабатываемые запросы, но не дольше deadline
+void await_drain(std::shared_ptr<net::steady_timer> timer, net::steady_timer::time_point deadline, std::function<void()> done) {
+  if (http_server::Drain::instance().in_flight() == 0u || net::steady_timer::clock_type::now() >= deadline) {
+    return done();
+  }
+
+  timer->expires_after(10ms);
+  timer->async_wait([timer, deadline, done = std::move(done)](const sys::error_code&) mutable {
+    await_drain(std::move(timer), deadline, std::move(done));
+  });
+}
+
+// Перечитывает параметры игры на потоках контекста io вне strand'ов,
+// поэтому запросы и тики не ждут окончания разбора файла
+void post_reload(net::io_context& io) {
+  net::post(io, [] {
+    try {
+      config::reload_game();
+      LOG_INFO << "game config reloaded"sv;
+    } catch (const std::exception& e) {
+      LOG_ERROR << JSON_DATA({"what"sv, e.what()}) << "failed to reload game config"sv;
+    }
+  });
+}
+
+// Перечитывает параметры игры по каждому SIGHUP
+void await_reload(net::signal_set& signals, net::io_context& io) {
+  signals.async_wait([&signals, &io](const sys::error_code& ec, int) {
+    if (ec) {
+      return;
+    }
+
+    post_reload(io);
+    await_reload(signals, io);
+  });
+}
+
+} // namespace
+
+mux::Router App::get_router(net::io_context& io) const {
   mux::Router router;
 
   router.set_route(endpoint::GetIndex().route());
@@ -28,11 +126,23 @@ mux::Router App::get_router() const {
   router.set_route(endpoint::GetMapInfo().route());
   router.set_route(endpoint::GetGameState().route());
   router.set_route(endpoint::PlayerAction().route());
+  router.set_route(endpoint::PlayerActionsBatch().route());
+  router.set_route(endpoint::GetRecords().route());
   
   if (cfg_.env == config::AppEnv::test) {
     router.set_route(endpoint::Tick().route());
   }
 
+  if (cfg_.server.admin_api) {
+    router.set_route(endpoint::GetPlacementStats().route());
+    router.set_route(endpoint::GetAdmissionStats().route());
+    router.set_route(endpoint::GetTraceStats().route());
+    router.set_route(endpoint::GetTraceEvents().route());
+    router.set_route(endpoint::Profile().route());
+    router.set_route(endpoint::GetProfileStacks().route());
+    router.set_route(endpoint::GameParameters([&io] { post_reload(io); }).route());
+  }
+
   return router;
 }
 
@@ -40,45 +150,152 @@ template <typename Fn>
 void App::run_threads(const unsigned num, const Fn& fn) const {
   const auto max_threads = std::thread::hardware_concurrency(); 
   
-  auto n = (num > max_threads) ? max_threads : num;
+  const auto n = std::max((num > max_threads) ? max_threads : num, 1u);
 
   std::vector<std::jthread> threads;
   threads.reserve(n-1);
 
   auto stop_token = stop_source_.get_token();
 
-  while (n--) {
-    threads.emplace_back(fn, stop_token);
+  for (unsigned i = 1; i < n; i++) {
+    threads.emplace_back(fn, i, stop_token);
   }
 
-  fn(stop_token);
+  fn(0u, stop_token);
 }
 
 void App::run() {  
-  const unsigned num_threads = std::thread::hardware_concurrency(); 
-  net::io_context io { static_cast<int>(num_threads) };
+  // Новый процесс забирает слушающие сокеты у работающего. Вызов возвращается, когда
+  // предыдущий процесс сохранил состояние и завершился, а ожидающие соединения
+  // всё это время остаются в очереди сокетов
+  std::vector<int> inherited;
+
+  if (cfg_.server.takeover_socket) {
+    inherited = handoff::take_over(*cfg_.server.takeover_socket);
+
+    LOG_INFO << JSON_DATA({"sockets"sv, inherited.size()}) << "listening sockets taken over"sv;
+  }
+
+  if (cfg_.server.trace_capacity) {
+    tracing::Tracer::instance().enable(*cfg_.server.trace_capacity);
+  }
+
+  const unsigned num_threads = std::max(std::thread::hardware_concurrency(), 1u); 
+
+  // В режиме io_per_core каждый поток работает со своим io_context, и очередь
+  // планировщика не разделяется между ядрами. Иначе все потоки обслуживают один контекст
+  const unsigned num_contexts = cfg_.server.io_per_core ? num_threads : 1u;
+  const int concurrency_hint = cfg_.server.io_per_core ? 1 : static_cast<int>(num_threads);
+
+  std::vector<std::unique_ptr<net::io_context>> contexts;
+  std::vector<net::io_context*> game_contexts;
+
+  // Контекст без слушающих сокетов всё равно обслуживает strand'ы игровых сессий,
+  // поэтому ни один контекст не должен завершаться до остановки сервера
+  std::vector<net::executor_work_guard<net::io_context::executor_type>> work_guards;
+
+  for (unsigned i = 0; i < num_contexts; i++) {
+    contexts.push_back(std::make_unique<net::io_context>(concurrency_hint));
+    game_contexts.push_back(contexts.back().get());
+    work_guards.push_back(net::make_work_guard(*contexts.back()));
+  }
+
+  // Сигналы, таймеры и сохранение состояния обслуживаются первым контекстом
+  auto& io = *contexts.front();
   
-  net::signal_set signals(io, SIGINT, SIGTERM);
-  signals.async_wait([this, &io](const sys::error_code& ec, int signal_number) {
+  http_server::Listeners listeners;
+  bool shutting_down = false;
+
+  const auto stop = [this, &contexts, &work_guards] {
+    stop_source_.request_stop();
+
+    for (auto& guard : work_guards) {
+      guard.reset();
+    }
+
+    for (const auto& context : contexts) {
+      context->stop();
+    }
+  };
+
+  // Без таймаута контексты останавливаются сразу. Иначе сервер перестаёт принимать
+  // соединения и ждёт отправки ответов на начатые запросы. Состояние сохраняется
+  // после остановки потоков. Вызывается на strand'е первого контекста
+  const auto shutdown = [&listeners, &shutting_down, stop](std::optional<std::chrono::milliseconds> timeout, net::io_context& io) {
+    if (std::exchange(shutting_down, true)) {
+      return;
+    }
+
+    if (!timeout) {
+      return stop();
+    }
+
+    for (const auto& listener : listeners) {
+      listener->stop();
+    }
+
+    http_server::Drain::instance().start();
+
+    LOG_INFO << JSON_DATA(
+      {"inFlight"sv, http_server::Drain::instance().in_flight()},
+      {"timeout"sv, timeout->count()}
+    )
+    << "draining requests"sv;
+
+    await_drain(std::make_shared<net::steady_timer>(io), net::steady_timer::clock_type::now() + *timeout, [stop] {
+      LOG_INFO << JSON_DATA({"inFlight"sv, http_server::Drain::instance().in_flight()}) << "drain finished"sv;
+      stop();
+    });
+  };
+
+  auto control_strand = net::make_strand(io);
+
+  net::signal_set signals(control_strand, SIGINT, SIGTERM);
+  signals.async_wait([this, &io, shutdown](const sys::error_code& ec, int signal_number) {
     if (!ec) {
       LOG_INFO << JSON_DATA({"signal"sv, signal_number}) 
         << "signal received"sv; 
 
-      stop_source_.request_stop();
-      io.stop();
+      shutdown(cfg_.server.drain_timeout, io);
     }
   });
 
-  auto api_strand = net::make_strand(io);
-  auto handler = std::make_shared<http_handler::RequestHandler>(api_strand, std::move(get_router()));
+  net::signal_set reload_signals(control_strand, SIGHUP);
+  await_reload(reload_signals, io);
 
-  const auto endpoint = http_server::tcp::endpoint(cfg_.server.addr, cfg_.server.port);
+  // Каждая игровая сессия получает собственный strand на одном из контекстов
+  cfg_.game->io_contexts(std::move(game_contexts));
 
-  http_handler::LoggingRequestHandler logging_handler {
-    [handler](auto&& req, auto&& send) {
-      return (*handler)(std::forward<decltype(req)>(req), std::forward<decltype(send)>(send));
-    }
-  };
+  // Сессии восстанавливаются после назначения io_context, так как каждой нужен strand
+  std::unique_ptr<state::StateManager> state;
+
+  if (cfg_.server.state_file) {
+    state = std::make_unique<state::StateManager>(*cfg_.game, *cfg_.server.state_file, cfg_.server.wal_file, cfg_.server.wal_fsync_interval);
+    state->recover();
+
+    state->error_handler([](const std::exception& e) {
+      LOG_ERROR << JSON_DATA({"what"sv, e.what()}) << "failed to persist game state"sv;
+    });
+  }
+
+  cfg_.game->retire_handler([this](const model::GameSession& session, const model::Character& character) {
+    app::Players::instance().remove(character);
+
+    cfg_.leaderboard->push({
+      .name = std::string(character.name()),
+      .score = character.score(),
+      .play_time = character.play_time()
+    });
+
+    LOG_INFO << JSON_DATA(
+      {"name"sv, character.name()},
+      {"score"sv, character.score()},
+      {"playTime"sv, character.play_time().count()}
+    )
+    << "player retired"sv;
+  });
+
+  auto api_strand = net::make_strand(io);
 
   if (cfg_.env != config::AppEnv::test) {
     auto ticker = std::make_shared<gstime::Ticker>(api_strand, *cfg_.server.tick_period, [this](std::chrono::milliseconds delta) {
@@ -89,16 +306,130 @@ void App::run() {
     ticker->start();
   }
 
-  http_server::serve_http(io, std::move(endpoint), logging_handler);
+  // Записи вышедших игроков переносятся в таблицу рекордов пачками
+  auto records_ticker = std::make_shared<gstime::Ticker>(net::make_strand(io), cfg_.server.records_flush_period, [this](std::chrono::milliseconds) {
+    cfg_.leaderboard->flush();
+  });
+
+  records_ticker->start();
+
+  // Записи адресов без соединений удаляются, когда их корзины запросов заполнятся
+  if (cfg_.server.admission.enabled()) {
+    auto admission_ticker = std::make_shared<gstime::Ticker>(net::make_strand(io), cfg_.server.admission_prune_period, [this](std::chrono::milliseconds) {
+      cfg_.admission->prune();
+    });
+
+    admission_ticker->start();
+  }
+
+  std::shared_ptr<gstime::Ticker> state_ticker;
+
+  if (state && cfg_.server.state_save_period) {
+    auto state_strand = net::make_strand(io);
+
+    state_ticker = std::make_shared<gstime::Ticker>(state_strand, *cfg_.server.state_save_period, [&state, state_strand](std::chrono::milliseconds) {
+      state->save_async(state_strand);
+    });
+
+    state_ticker->start();
+  }
+
+  const auto endpoint = http_server::tcp::endpoint(cfg_.server.addr, cfg_.server.port);
+
+  // Каждый контекст принимает соединения на своих сокетах с SO_REUSEPORT, поэтому соединение
+  // обслуживается одним ядром. На другое ядро запрос переходит, только если
+  // strand его игровой сессии принадлежит другому контексту
+  auto listener_cfg = cfg_.server.listener;
+  listener_cfg.reuse_port = num_contexts > 1u;
+
+  // Пока пределы не заданы, соединения принимаются без обращения к контролю допуска
+  const auto admission = cfg_.server.admission.enabled() ? cfg_.admission.get() : nullptr;
+
+  for (std::size_t index = 0; index < contexts.size(); index++) {
+    auto& context = *contexts[index];
+
+    const auto strand = (index == 0u) ? api_strand : net::make_strand(context);
+    auto handler = std::make_shared<http_handler::RequestHandler>(strand, std::move(get_router(io)));
+
+    http_handler::LoggingRequestHandler logging_handler {
+      [handler](auto&& req, tracing::Span& span, auto&& send) {
+        (*handler)(std::forward<decltype(req)>(req), span, std::forward<decltype(send)>(send));
+      }
+    };
+
+    http_server::Listeners context_listeners;
+
+    if (!inherited.empty()) {
+      // Полученные сокеты распределяются между контекстами по кругу
+      std::vector<int> sockets;
+
+      for (auto i = index; i < inherited.size(); i += contexts.size()) {
+        sockets.push_back(inherited[i]);
+      }
+
+      // Предыдущий процесс мог передать меньше сокетов, чем здесь контекстов. Тогда контекст
+      // принимает соединения на копии дескриптора: очередь сокета разделяется между контекстами
+      if (sockets.empty()) {
+        const auto fd = ::dup(inherited[index % inherited.size()]);
+
+        if (fd < 0) {
+          throw sys::system_error(errno, sys::system_category(), "dup"s);
+        }
+
+        sockets.push_back(fd);
+      }
+
+      context_listeners = http_server::serve_http(context, sockets, listener_cfg, admission, logging_handler);
+    } else {
+      context_listeners = http_server::serve_http(context, endpoint, listener_cfg, admission, logging_handler);
+    }
+
+    std::ranges::move(context_listeners, std::back_inserter(listeners));
+  }
+
+  std::shared_ptr<handoff::Server> handoff_server;
+
+  if (cfg_.server.handoff_socket) {
+    handoff_server = std::make_shared<handoff::Server>(io, *cfg_.server.handoff_socket, 
+      [&listeners] {
+        std::vector<int> sockets;
+
+        for (const auto& listener : listeners) {
+          sockets.push_back(listener->native_handle());
+        }
+
+        return sockets;
+      },
+      [this, &io, control_strand, shutdown] {
+        // Сокеты уже принимает новый процесс, поэтому начатые запросы дорабатываются всегда
+        net::post(control_strand, [this, &io, shutdown] {
+          LOG_INFO << "listening sockets handed off"sv;
+          shutdown(cfg_.server.drain_timeout.value_or(std::chrono::duration_cast<std::chrono::milliseconds>(cfg_.server.write_timeout)), io);
+        });
+      });
+
+    handoff_server->error_handler([](const std::exception& e) {
+      LOG_ERROR << JSON_DATA({"what"sv, e.what()}) << "failed to hand off listening sockets"sv;
+    });
+
+    handoff_server->run();
+  }
 
   LOG_INFO << JSON_DATA(
     {"port"sv, cfg_.server.port},
-    {"address"sv, cfg_.server.addr.to_string()}
+    {"address"sv, cfg_.server.addr.to_string()},
+    {"listeners"sv, cfg_.server.listener.acceptors},
+    {"ioContexts"sv, num_contexts},
+    {"seed"sv, cfg_.game->config()->seed}
   )
   << "server started"sv; 
 
-  run_threads(num_threads, [&io](std::stop_token token) { 
-    io.run(); 
+  run_threads(num_threads, [this, &contexts](unsigned index, std::stop_token token) { 
+    if (cfg_.server.io_per_core) {
+      pin_thread(index);
+    }
+
+    contexts[index % contexts.size()]->run(); 
 
     if (token.stop_requested()) {      
       LOG_INFO << "thread #0x"sv << std::hex 
@@ -107,6 +438,10 @@ void App::run() {
       return;
     }     
   });
+
+  if (state) {
+    state->save();
+  }
 }
 
 } // namespace app
\ No newline at end of file
@@ -5,6 +5,8 @@
 
 #include <thread>
 
+#include <boost/asio/io_context.hpp>
+
 namespace app {
 
 class App {
@@ -22,7 +24,7 @@ private:
   template <typename Fn>
   void run_threads(const unsigned num, const Fn& fn) const;
 
-  mux::Router get_router() const;
+  mux::Router get_router(boost::asio::io_context& io) const;
 
 private: 
   const config::AppConfig& cfg_;
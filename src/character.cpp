@@ -5,24 +5,8 @@ namespace model {
 
 using namespace std::literals;
 
-const std::unordered_map<Character::Direction::Direct, std::string> direct_to_letter_ = {
-  { Character::Direction::nomove, "" },
-  { Character::Direction::north,  "U" },
-  { Character::Direction::south,  "D" },
-  { Character::Direction::east,   "R" },
-  { Character::Direction::west,   "L" },
-};
-
-const std::unordered_map<std::string, Character::Direction::Direct> letter_to_direct_ = {
-  { "",  Character::Direction::nomove }, 
-  { "U", Character::Direction::north },
-  { "D", Character::Direction::south },
-  { "R", Character::Direction::east },
-  { "L", Character::Direction::west },
-};
-
 std::size_t Bagpack::capacity() const noexcept {
-  return (bag_.max_load_factor() * bag_.bucket_count()); 
+  return capacity_;
 }
 
 std::size_t Bagpack::size() const noexcept {
@@ -33,21 +17,21 @@ void Bagpack::clear() noexcept {
   bag_.clear();
 }
 
-void Bagpack::add(Loot::Id id, std::shared_ptr<Loot> loot) {
+void Bagpack::add(const Loot& loot) {
   if (is_full()) {
     return;
   }
 
-  bag_[id] = std::move(loot);
+  bag_.push_back(loot);
 }
 
 void Bagpack::capacity(const std::uint64_t capacity) {
+  capacity_ = capacity;
   bag_.reserve(capacity);
 }
 
 bool Bagpack::is_full() const noexcept {
-  const auto capacity = (bag_.max_load_factor() * bag_.bucket_count());    
-  return (bag_.size() == capacity);
+  return bag_.size() >= capacity_;
 }
 
 const Bagpack::BagType& Bagpack::get() const noexcept {
@@ -62,6 +46,24 @@ Character::Points Character::score() const noexcept {
   return points_;
 }
 
+std::chrono::milliseconds Character::idle_time() const noexcept {
+  return idle_time_;
+}
+
+std::chrono::milliseconds Character::play_time() const noexcept {
+  return play_time_;
+}
+
+void Character::update_activity(std::chrono::milliseconds delta) noexcept {
+  play_time_ += delta;
+
+  if (speed_ == geom::Speed{0.0, 0.0}) {
+    idle_time_ += delta;
+  } else {
+    idle_time_ = std::chrono::milliseconds::zero();
+  }
+}
+
 void Character::add_points(const Points points) noexcept {
   points_ += points;
 }
@@ -79,25 +81,19 @@ const Character::Direction& Character::direction() const noexcept {
 }
 
 Character::Direction::Direction(std::string_view letter_direct) {
-  if (!letter_direct.empty()) {
-    const auto pos = letter_direct.find_first_of("LRUD"sv);
+  const auto direct = from_letter(letter_direct);
 
-    if (letter_direct.length() > 1 || (pos == std::string::npos)) {
-      throw std::invalid_argument("Invalid direction letter"s);
-    }
+  if (!direct) {
+    throw std::invalid_argument("Invalid direction letter"s);
   }
 
-  direct_ = letter_to_direct_.at(std::string(letter_direct));
+  direct_ = *direct;
 }
 
 Character::Direction::Direct Character::Direction::value() const noexcept {
   return direct_;
 }
 
-const std::string& Character::Direction::as_letter() const noexcept {
-  return direct_to_letter_.at(direct_);
-}
-
 void Character::move(Direction direction, const double speed) noexcept {
   switch (direction.direct_) {
     case Direction::nomove :
@@ -3,22 +3,31 @@
 #include "map.hpp"
 #include "loot.hpp"
 
+#include <chrono>
 #include <string>
 #include <memory>
+#include <optional>
+#include <string_view>
+
+#include <boost/container/small_vector.hpp>
 
 namespace model {
 
+// Рюкзак хранит копии собранных предметов. Предметы небольшого
+// рюкзака размещаются прямо в объекте персонажа, без выделения памяти
 class Bagpack {
 public:
-  using BagType = std::unordered_map<Loot::Id, std::shared_ptr<Loot>>;
+  constexpr static std::size_t INLINE_CAPACITY { 3u };
+
+  using BagType = boost::container::small_vector<Loot, INLINE_CAPACITY>;
 
   Bagpack() = default;
 
   explicit Bagpack(const std::size_t capacity) {
-    bag_.reserve(capacity);
+    this->capacity(capacity);
   }
 
-  void add(Loot::Id id, std::shared_ptr<Loot> loot);
+  void add(const Loot& loot);
   void capacity(const std::uint64_t capacity);
   void clear() noexcept;
   
@@ -28,7 +37,8 @@ public:
   [[nodiscard]] std::size_t size() const noexcept;
 
 private:
-  BagType bag_;   
+  BagType bag_;
+  std::size_t capacity_ { 0u };
 }; 
 
 class Character {
@@ -48,13 +58,43 @@ public:
       east
     }; 
 
-    Direction(const Direct direct)
+    constexpr Direction(const Direct direct)
       : direct_(direct) {
     }
 
     Direction(std::string_view letter_direct);
 
-    [[nodiscard]] const std::string& as_letter() const noexcept;
+    // Направление по букве: пустая строка означает остановку
+    [[nodiscard]] static constexpr std::optional<Direct> from_letter(std::string_view letter) noexcept {
+      if (letter.empty()) {
+        return nomove;
+      }
+
+      if (letter.size() > 1) {
+        return std::nullopt;
+      }
+
+      switch (letter.front()) {
+        case 'U' : return north;
+        case 'D' : return south;
+        case 'L' : return west;
+        case 'R' : return east;
+        default  : return std::nullopt;
+      }
+    }
+
+    [[nodiscard]] constexpr std::string_view as_letter() const noexcept {
+      using namespace std::literals;
+
+      switch (direct_) {
+        case north : return "U"sv;
+        case south : return "D"sv;
+        case west  : return "L"sv;
+        case east  : return "R"sv;
+        default    : return ""sv;
+      }
+    }
+
     [[nodiscard]] Direct value() const noexcept;
 
   private:
@@ -82,6 +122,12 @@ public:
   [[nodiscard]] const geom::Position& position() const noexcept;
   [[nodiscard]] const Direction& direction() const noexcept;
   [[nodiscard]] Points score() const noexcept;
+  [[nodiscard]] std::chrono::milliseconds idle_time() const noexcept;
+  [[nodiscard]] std::chrono::milliseconds play_time() const noexcept;
+
+  // Учитывает время, прошедшее с предыдущего тика. Время бездействия 
+  // накапливается, пока персонаж стоит на месте, и сбрасывается при движении
+  void update_activity(std::chrono::milliseconds delta) noexcept;
 
   void name(std::string_view name) noexcept;
   void position(const geom::Position pos) noexcept;
@@ -105,6 +151,9 @@ protected:
   geom::Speed speed_ {0.0, 0.0};
   Direction direction_ { Direction::north };
 
+  std::chrono::milliseconds idle_time_ { 0 };
+  std::chrono::milliseconds play_time_ { 0 };
+
   std::string name_;
 };
 
@@ -16,8 +16,14 @@ std::optional<Args> parse(int argc, char** const argv) {
   try {
     po::options_description desc{"Allowed options"s};
 
-    std::size_t tick, save_state_period;
-    fs::path state_file_path;
+    std::size_t tick, save_state_period, wal_fsync_interval, drain_timeout;
+    std::uint64_t random_seed;
+    unsigned listeners, tcp_defer_accept;
+    int listen_backlog;
+    std::size_t max_connections, max_connections_per_ip, trace_requests;
+    double ip_request_rate, ip_request_burst;
+    fs::path state_file_path, wal_file_path, records_file_path, replay_journal_path;
+    fs::path handoff_socket_path, takeover_socket_path;
 
     desc.add_options()
       (
@@ -51,6 +57,98 @@ std::optional<Args> parse(int argc, char** const argv) {
         "save-state-period", 
         po::value(&save_state_period)->value_name("save period (ms)"), 
         "set a period for automatic game state saving"
+      )
+      (
+        "wal-file", 
+        po::value(&wal_file_path)->value_name("file"), 
+        "set file path of the journal of game state changes made between saves"
+      )
+      (
+        "wal-fsync-interval", 
+        po::value(&wal_fsync_interval)->value_name("milliseconds"), 
+        "set a maximum delay before journaled changes are flushed to disk"
+      )
+      (
+        "records-file", 
+        po::value(&records_file_path)->value_name("file"), 
+        "set file path where records of retired players are stored"
+      )
+      (
+        "replay-journal", 
+        po::value(&replay_journal_path)->value_name("file"), 
+        "record inputs of game sessions to a journal for game_replay"
+      )
+      (
+        "random-seed", 
+        po::value(&random_seed)->value_name("seed"), 
+        "set a seed for game sessions random generators"
+      )
+      (
+        "io-per-core", 
+        "run a separate io_context with its own listener on each CPU core"
+      )
+      (
+        "listeners", 
+        po::value(&listeners)->value_name("count"), 
+        "set a number of acceptors sharing the port with SO_REUSEPORT"
+      )
+      (
+        "listen-backlog", 
+        po::value(&listen_backlog)->value_name("size"), 
+        "set a maximum length of the queue of pending connections"
+      )
+      (
+        "tcp-nodelay", 
+        "disable Nagle's algorithm on accepted connections"
+      )
+      (
+        "tcp-defer-accept", 
+        po::value(&tcp_defer_accept)->value_name("seconds"), 
+        "accept connections only after data has arrived (TCP_DEFER_ACCEPT)"
+      )
+      (
+        "max-connections", 
+        po::value(&max_connections)->value_name("count"), 
+        "reject new connections with 503 when this many are open"
+      )
+      (
+        "max-connections-per-ip", 
+        po::value(&max_connections_per_ip)->value_name("count"), 
+        "reject new connections from an address with 429 when it has this many open"
+      )
+      (
+        "ip-request-rate", 
+        po::value(&ip_request_rate)->value_name("requests/s"), 
+        "limit the rate of requests from one address, excess requests get 429"
+      )
+      (
+        "ip-request-burst", 
+        po::value(&ip_request_burst)->value_name("requests"), 
+        "set how many requests from one address may exceed the rate at once"
+      )
+      (
+        "drain-timeout", 
+        po::value(&drain_timeout)->value_name("milliseconds"), 
+        "on SIGTERM stop accepting and wait this long for in-flight requests"
+      )
+      (
+        "handoff-socket", 
+        po::value(&handoff_socket_path)->value_name("file"), 
+        "hand listening sockets to a new server process connecting to this Unix socket"
+      )
+      (
+        "takeover", 
+        po::value(&takeover_socket_path)->value_name("file"), 
+        "take listening sockets over from a running server through its handoff socket"
+      )
+      (
+        "trace-requests", 
+        po::value(&trace_requests)->value_name("count"), 
+        "trace request stages and keep this many recent requests for /api/v1/admin/trace"
+      )
+      (
+        "enable-admin-api", 
+        "enable /api/v1/admin/* monitoring endpoints"
       );
 
     po::variables_map vm;
@@ -71,6 +169,9 @@ std::optional<Args> parse(int argc, char** const argv) {
     }
 
     args.randomize_spawn = vm.contains("randomize-spawn-points");
+    args.enable_admin_api = vm.contains("enable-admin-api");
+    args.tcp_nodelay = vm.contains("tcp-nodelay");
+    args.io_per_core = vm.contains("io-per-core");
 
     if (vm.contains("tick-period")) {
       args.tick_period = tick;
@@ -80,6 +181,74 @@ std::optional<Args> parse(int argc, char** const argv) {
       args.state_file = state_file_path;
     }
 
+    if (vm.contains("wal-file")) {
+      if (!vm.contains("state-file")) {
+        throw std::runtime_error("Journal file requires a state file"s);
+      }
+
+      args.wal_file = wal_file_path;
+    }
+
+    if (vm.contains("wal-fsync-interval")) {
+      args.wal_fsync_interval = wal_fsync_interval;
+    }
+
+    if (vm.contains("records-file")) {
+      args.records_file = records_file_path;
+    }
+
+    if (vm.contains("replay-journal")) {
+      args.replay_journal = replay_journal_path;
+    }
+
+    if (vm.contains("random-seed")) {
+      args.random_seed = random_seed;
+    }
+
+    if (vm.contains("listeners")) {
+      args.listeners = listeners;
+    }
+
+    if (vm.contains("listen-backlog")) {
+      args.listen_backlog = listen_backlog;
+    }
+
+    if (vm.contains("tcp-defer-accept")) {
+      args.tcp_defer_accept = tcp_defer_accept;
+    }
+
+    if (vm.contains("max-connections")) {
+      args.max_connections = max_connections;
+    }
+
+    if (vm.contains("max-connections-per-ip")) {
+      args.max_connections_per_ip = max_connections_per_ip;
+    }
+
+    if (vm.contains("ip-request-rate")) {
+      args.ip_request_rate = ip_request_rate;
+    }
+
+    if (vm.contains("ip-request-burst")) {
+      args.ip_request_burst = ip_request_burst;
+    }
+
+    if (vm.contains("drain-timeout")) {
+      args.drain_timeout = drain_timeout;
+    }
+
+    if (vm.contains("handoff-socket")) {
+      args.handoff_socket = handoff_socket_path;
+    }
+
+    if (vm.contains("takeover")) {
+      args.takeover_socket = takeover_socket_path;
+    }
+
+    if (vm.contains("trace-requests")) {
+      args.trace_requests = trace_requests;
+    }
+
     if (vm.contains("save-state-period") && vm.contains("state-file")) {
       args.save_state_period = save_state_period;
     }
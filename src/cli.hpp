@@ -1,5 +1,6 @@
 #pragma once 
 
+#include <cstdint>
 #include <optional>
 #include <filesystem>
 
@@ -9,10 +10,29 @@ namespace fs = std::filesystem;
 
 struct Args {
   bool randomize_spawn;
+  bool enable_admin_api;
+  bool tcp_nodelay;
+  bool io_per_core;
 
   std::optional<std::size_t> tick_period { std::nullopt };
   std::optional<std::size_t> save_state_period { std::nullopt };
   std::optional<fs::path> state_file { std::nullopt };
+  std::optional<fs::path> wal_file { std::nullopt };
+  std::optional<std::size_t> wal_fsync_interval { std::nullopt };
+  std::optional<fs::path> records_file { std::nullopt };
+  std::optional<fs::path> replay_journal { std::nullopt };
+  std::optional<std::uint64_t> random_seed { std::nullopt };
+  std::optional<unsigned> listeners { std::nullopt };
+  std::optional<int> listen_backlog { std::nullopt };
+  std::optional<unsigned> tcp_defer_accept { std::nullopt };
+  std::optional<std::size_t> max_connections { std::nullopt };
+  std::optional<std::size_t> max_connections_per_ip { std::nullopt };
+  std::optional<double> ip_request_rate { std::nullopt };
+  std::optional<double> ip_request_burst { std::nullopt };
+  std::optional<std::size_t> drain_timeout { std::nullopt };
+  std::optional<fs::path> handoff_socket { std::nullopt };
+  std::optional<fs::path> takeover_socket { std::nullopt };
+  std::optional<std::size_t> trace_requests { std::nullopt };
 
   fs::path config_file;
   fs::path www_root;
@@ -2,6 +2,7 @@
 
 #include <cassert>
 #include <algorithm>
+#include <bit>
 #include <stdexcept>
 
 namespace collisions {
@@ -78,6 +79,19 @@ void LootCharacterProvider::clear_gatherers() noexcept {
 GatheringEvents find_gather_events(const ItemGathererProvider& provider) {
   GatheringEvents detected_events;
 
+  // Буферы переиспользуются между вызовами в одном потоке
+  thread_local ObjectsBatch objects;
+  thread_local HitMask hits;
+
+  objects.clear();
+
+  for (std::size_t i = 0; i < provider.objects_count(); i++) {
+    decltype(auto) obj = provider.get_object(i);
+    objects.add(obj.position, obj.width);
+  }
+
+  const auto kernel = best_kernel();
+
   for (std::size_t g = 0; g < provider.gatherers_count(); g++) {
     decltype(auto) gatherer = provider.get_gatherer(g);
 
@@ -86,12 +100,15 @@ GatheringEvents find_gather_events(const ItemGathererProvider& provider) {
       continue;
     }
 
-    for (std::size_t i = 0; i < provider.objects_count(); i++) {
-      decltype(auto) obj = provider.get_object(i);
+    find_hits(gatherer, objects, hits, kernel);
+
+    for (std::size_t word = 0; word < hits.size(); word++) {
+      for (auto bits = hits[word]; bits != 0; bits &= bits - 1) {
+        const auto i = word * 64 + static_cast<std::size_t>(std::countr_zero(bits));
 
-      const auto collect_result = try_collect_point(gatherer.start_pos, gatherer.end_pos, obj.position);
+        // Подобранных объектов мало, поэтому значения для события пересчитываются
+        const auto collect_result = try_collect_point(gatherer.start_pos, gatherer.end_pos, provider.get_object(i).position);
 
-      if (collect_result.is_collected(gatherer.width + obj.width)) {
         GatheringEvent evt {
           .object_idx = i,
           .gatherer_idx = g,
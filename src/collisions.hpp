@@ -42,12 +42,13 @@ public:
 }; 
 
 struct Item final : public Object {
-  model::Loot::Id id;
+  // Handle предмета в пуле потерянных предметов сессии
+  model::LootPool::Handle id;
 
 public:
   Item() = default;
 
-  Item(geom::Position position, double width, model::Loot::Id id)
+  Item(geom::Position position, double width, model::LootPool::Handle id)
     : Object(position, width)
     , id(id) {
   }
@@ -92,6 +93,8 @@ class LootCharacterProvider final : public ItemGathererProvider {
 public: 
   using Gatherers = std::vector<Gatherer>;
   using Objects = std::vector<std::unique_ptr<Object>>;
+
+  LootCharacterProvider() = default;
   
   [[nodiscard]] virtual std::size_t objects_count() const noexcept override;
   [[nodiscard]] virtual const Object& get_object(const std::size_t idx) const override;
@@ -111,9 +114,6 @@ public:
 
   static LootCharacterProvider& instance() noexcept;
 
-private:
-  LootCharacterProvider() = default;
-
 private:
   Gatherers gatherers_;
   Objects objects_; 
@@ -129,6 +129,44 @@ struct GatheringEvent {
 
 using GatheringEvents = std::vector<GatheringEvent>;
 
+// Координаты и ширина объектов в отдельных непрерывных массивах 
+// для пакетной проверки столкновений
+struct ObjectsBatch {
+  std::vector<double> x;
+  std::vector<double> y;
+  std::vector<double> width;
+
+  void add(geom::Position position, double object_width);
+  void clear() noexcept;
+
+  [[nodiscard]] std::size_t size() const noexcept;
+};
+
+// Бит i установлен, если объект i подобран. Слово k содержит объекты [64k, 64k + 64)
+using HitMask = std::vector<std::uint64_t>;
+
+// Реализации пакетной проверки. Векторные обрабатывают 
+// по 2 (SSE2) или 4 (AVX2) объекта за одну итерацию
+enum class Kernel : std::uint8_t {
+  scalar,
+  sse2,
+  avx2
+};
+
+[[nodiscard]] bool is_supported(Kernel kernel) noexcept;
+
+// Наиболее быстрая реализация, поддерживаемая процессором
+[[nodiscard]] Kernel best_kernel() noexcept;
+
+/*
+ * Проверяет все объекты пакета для одного отрезка движения собирателя.
+ * Результат совпадает с проверкой каждого объекта через try_collect_point и
+ * CollectionResult::is_collected: выражения вычисляются в том же порядке
+ * и без объединения умножения со сложением.
+ * Отрезок движения должен быть ненулевым
+ */
+void find_hits(const Gatherer& gatherer, const ObjectsBatch& objects, HitMask& hits, Kernel kernel = best_kernel());
+
 // Функция возвращает вектор событий, идущих в хронологическом порядке
 [[nodiscard]] GatheringEvents find_gather_events(const ItemGathererProvider& provider);
 
@@ -0,0 +1,195 @@
+#include "collisions.hpp"
+
+#include <cassert>
+
+#if defined(__GNUC__) && defined(__x86_64__)
+  #define COLLISIONS_X86_KERNELS 1
+  #include <immintrin.h>
+#endif
+
+namespace collisions {
+
+namespace {
+
+// Параметры отрезка движения, общие для всех объектов
+struct Segment {
+  double a_x, a_y;
+  double v_x, v_y;
+  double v_len2;
+  double width;
+};
+
+Segment make_segment(const Gatherer& gatherer) noexcept {
+  const double v_x = gatherer.end_pos.x - gatherer.start_pos.x;
+  const double v_y = gatherer.end_pos.y - gatherer.start_pos.y;
+
+  return {
+    .a_x = gatherer.start_pos.x,
+    .a_y = gatherer.start_pos.y,
+    .v_x = v_x,
+    .v_y = v_y,
+    .v_len2 = v_x * v_x + v_y * v_y,
+    .width = gatherer.width
+  };
+}
+
+// Операции над значениями повторяют try_collect_point и CollectionResult::is_collected
+bool is_hit(const Segment& s, double x, double y, double width) noexcept {
+  const double u_x = x - s.a_x;
+  const double u_y = y - s.a_y;
+  const double u_dot_v = u_x * s.v_x + u_y * s.v_y;
+  const double u_len2 = u_x * u_x + u_y * u_y;
+  const double proj_ratio = u_dot_v / s.v_len2;
+  const double sq_distance = u_len2 - (u_dot_v * u_dot_v) / s.v_len2;
+  const double radius = s.width + width;
+
+  return proj_ratio >= 0 && proj_ratio <= 1 && sq_distance <= radius * radius;
+}
+
+void find_hits_scalar(const Segment& s, const ObjectsBatch& objects, std::size_t first, std::uint64_t* hits) noexcept {
+  for (std::size_t i = first; i < objects.size(); i++) {
+    if (is_hit(s, objects.x[i], objects.y[i], objects.width[i])) {
+      hits[i / 64] |= std::uint64_t(1) << (i % 64);
+    }
+  }
+}
+
+#ifdef COLLISIONS_X86_KERNELS
+
+// SSE2 входит в базовый набор инструкций x86-64
+std::size_t find_hits_sse2(const Segment& s, const ObjectsBatch& objects, std::uint64_t* hits) noexcept {
+  const __m128d a_x = _mm_set1_pd(s.a_x);
+  const __m128d a_y = _mm_set1_pd(s.a_y);
+  const __m128d v_x = _mm_set1_pd(s.v_x);
+  const __m128d v_y = _mm_set1_pd(s.v_y);
+  const __m128d v_len2 = _mm_set1_pd(s.v_len2);
+  const __m128d width = _mm_set1_pd(s.width);
+  const __m128d zero = _mm_setzero_pd();
+  const __m128d one = _mm_set1_pd(1.0);
+
+  const std::size_t count = objects.size() / 2 * 2;
+
+  for (std::size_t i = 0; i < count; i += 2) {
+    const __m128d u_x = _mm_sub_pd(_mm_loadu_pd(objects.x.data() + i), a_x);
+    const __m128d u_y = _mm_sub_pd(_mm_loadu_pd(objects.y.data() + i), a_y);
+    const __m128d u_dot_v = _mm_add_pd(_mm_mul_pd(u_x, v_x), _mm_mul_pd(u_y, v_y));
+    const __m128d u_len2 = _mm_add_pd(_mm_mul_pd(u_x, u_x), _mm_mul_pd(u_y, u_y));
+    const __m128d proj_ratio = _mm_div_pd(u_dot_v, v_len2);
+    const __m128d sq_distance = _mm_sub_pd(u_len2, _mm_div_pd(_mm_mul_pd(u_dot_v, u_dot_v), v_len2));
+    const __m128d radius = _mm_add_pd(width, _mm_loadu_pd(objects.width.data() + i));
+
+    const __m128d hit = _mm_and_pd(
+      _mm_and_pd(_mm_cmpge_pd(proj_ratio, zero), _mm_cmple_pd(proj_ratio, one)),
+      _mm_cmple_pd(sq_distance, _mm_mul_pd(radius, radius)));
+
+    // i чётно, поэтому оба бита попадают в одно слово
+    hits[i / 64] |= static_cast<std::uint64_t>(_mm_movemask_pd(hit)) << (i % 64);
+  }
+
+  return count;
+}
+
+__attribute__((target("avx2")))
+std::size_t find_hits_avx2(const Segment& s, const ObjectsBatch& objects, std::uint64_t* hits) noexcept {
+  const __m256d a_x = _mm256_set1_pd(s.a_x);
+  const __m256d a_y = _mm256_set1_pd(s.a_y);
+  const __m256d v_x = _mm256_set1_pd(s.v_x);
+  const __m256d v_y = _mm256_set1_pd(s.v_y);
+  const __m256d v_len2 = _mm256_set1_pd(s.v_len2);
+  const __m256d width = _mm256_set1_pd(s.width);
+  const __m256d zero = _mm256_setzero_pd();
+  const __m256d one = _mm256_set1_pd(1.0);
+
+  const std::size_t count = objects.size() / 4 * 4;
+
+  for (std::size_t i = 0; i < count; i += 4) {
+    const __m256d u_x = _mm256_sub_pd(_mm256_loadu_pd(objects.x.data() + i), a_x);
+    const __m256d u_y = _mm256_sub_pd(_mm256_loadu_pd(objects.y.data() + i), a_y);
+    const __m256d u_dot_v = _mm256_add_pd(_mm256_mul_pd(u_x, v_x), _mm256_mul_pd(u_y, v_y));
+    const __m256d u_len2 = _mm256_add_pd(_mm256_mul_pd(u_x, u_x), _mm256_mul_pd(u_y, u_y));
+    const __m256d proj_ratio = _mm256_div_pd(u_dot_v, v_len2);
+    const __m256d sq_distance = _mm256_sub_pd(u_len2, _mm256_div_pd(_mm256_mul_pd(u_dot_v, u_dot_v), v_len2));
+    const __m256d radius = _mm256_add_pd(width, _mm256_loadu_pd(objects.width.data() + i));
+
+    // Упорядоченные сравнения дают false для NaN, как и в скалярной версии
+    const __m256d hit = _mm256_and_pd(
+      _mm256_and_pd(_mm256_cmp_pd(proj_ratio, zero, _CMP_GE_OQ), _mm256_cmp_pd(proj_ratio, one, _CMP_LE_OQ)),
+      _mm256_cmp_pd(sq_distance, _mm256_mul_pd(radius, radius), _CMP_LE_OQ));
+
+    // i кратно 4, поэтому все четыре бита попадают в одно слово
+    hits[i / 64] |= static_cast<std::uint64_t>(_mm256_movemask_pd(hit)) << (i % 64);
+  }
+
+  return count;
+}
+
+#endif // COLLISIONS_X86_KERNELS
+
+} // namespace
+
+void ObjectsBatch::add(geom::Position position, double object_width) {
+  x.push_back(position.x);
+  y.push_back(position.y);
+  width.push_back(object_width);
+}
+
+void ObjectsBatch::clear() noexcept {
+  x.clear();
+  y.clear();
+  width.clear();
+}
+
+std::size_t ObjectsBatch::size() const noexcept {
+  return x.size();
+}
+
+bool is_supported(Kernel kernel) noexcept {
+  switch (kernel) {
+    case Kernel::scalar :
+      return true;
+#ifdef COLLISIONS_X86_KERNELS
+    case Kernel::sse2 :
+      return true;
+    case Kernel::avx2 :
+      return __builtin_cpu_supports("avx2");
+#endif
+    default :
+      return false;
+  }
+}
+
+Kernel best_kernel() noexcept {
+  static const Kernel kernel = [] {
+    for (const auto k : { Kernel::avx2, Kernel::sse2 }) {
+      if (is_supported(k)) {
+        return k;
+      }
+    }
+
+    return Kernel::scalar;
+  }();
+
+  return kernel;
+}
+
+void find_hits(const Gatherer& gatherer, const ObjectsBatch& objects, HitMask& hits, Kernel kernel) {
+  assert(gatherer.start_pos.x != gatherer.end_pos.x || gatherer.start_pos.y != gatherer.end_pos.y);
+
+  hits.assign((objects.size() + 63) / 64, 0u);
+
+  const auto segment = make_segment(gatherer);
+  std::size_t processed = 0;
+
+#ifdef COLLISIONS_X86_KERNELS
+  if (kernel == Kernel::avx2 && is_supported(Kernel::avx2)) {
+    processed = find_hits_avx2(segment, objects, hits.data());
+  } else if (kernel == Kernel::sse2) {
+    processed = find_hits_sse2(segment, objects, hits.data());
+  }
+#endif
+
+  // Оставшиеся объекты, не заполнившие векторный регистр
+  find_hits_scalar(segment, objects, processed, hits.data());
+}
+
+} // namespace collisions
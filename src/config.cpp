@@ -25,6 +25,8 @@ void init(cli::Args args) {
     }  
 
     cfg.server.www_root = std::move(args.www_root);    
+    cfg.server.admin_api = args.enable_admin_api;
+    cfg.server.io_per_core = args.io_per_core;
 
     if (args.tick_period.has_value()) {
       cfg.env = AppEnv::prod;
@@ -39,7 +41,77 @@ void init(cli::Args args) {
       cfg.server.state_file = std::move(*args.state_file);
     }
 
-    cfg.game = std::make_unique<model::Game>(json_loader::load_game(std::move(args.config_file), args.randomize_spawn));
+    if (args.wal_file.has_value()) {
+      cfg.server.wal_file = std::move(*args.wal_file);
+    }
+
+    if (args.wal_fsync_interval.has_value()) {
+      cfg.server.wal_fsync_interval = std::chrono::milliseconds(*args.wal_fsync_interval);
+    }
+
+    if (args.listeners.has_value()) {
+      if (*args.listeners == 0u) {
+        throw std::invalid_argument("Number of listeners must be positive"s);
+      }
+
+      cfg.server.listener.acceptors = *args.listeners;
+    }
+
+    if (args.listen_backlog.has_value()) {
+      cfg.server.listener.backlog = *args.listen_backlog;
+    }
+
+    if (args.tcp_defer_accept.has_value()) {
+      cfg.server.listener.defer_accept = std::chrono::seconds(*args.tcp_defer_accept);
+    }
+
+    cfg.server.listener.tcp_nodelay = args.tcp_nodelay;
+
+    if (args.max_connections.has_value()) {
+      cfg.server.admission.max_connections = *args.max_connections;
+    }
+
+    if (args.max_connections_per_ip.has_value()) {
+      cfg.server.admission.max_connections_per_ip = *args.max_connections_per_ip;
+    }
+
+    if (args.ip_request_rate.has_value()) {
+      cfg.server.admission.requests_per_second = *args.ip_request_rate;
+    }
+
+    if (args.ip_request_burst.has_value()) {
+      cfg.server.admission.request_burst = *args.ip_request_burst;
+    }
+
+    if (args.drain_timeout.has_value()) {
+      cfg.server.drain_timeout = std::chrono::milliseconds(*args.drain_timeout);
+    }
+
+    if (args.handoff_socket.has_value()) {
+      cfg.server.handoff_socket = std::move(*args.handoff_socket);
+    }
+
+    if (args.takeover_socket.has_value()) {
+      cfg.server.takeover_socket = std::move(*args.takeover_socket);
+    }
+
+    if (args.trace_requests.has_value()) {
+      if (*args.trace_requests == 0u) {
+        throw std::invalid_argument("Number of traced requests must be positive"s);
+      }
+
+      cfg.server.trace_capacity = *args.trace_requests;
+    }
+
+    cfg.admission = std::make_unique<admission::Controller>(cfg.server.admission);
+
+    cfg.leaderboard = std::make_unique<leaderboard::Leaderboard>(std::move(args.records_file));
+    cfg.server.game_config_file = std::move(args.config_file);
+    cfg.game = std::make_unique<model::Game>(json_loader::load_game(cfg.server.game_config_file, args.randomize_spawn, args.random_seed));
+
+    if (args.replay_journal.has_value()) {
+      cfg.game->recorder(std::make_shared<replay::Recorder>(*args.replay_journal, args.randomize_spawn));
+    }
 
     if (const auto addr = std::getenv("GAME_SERVER_HTTP_ADDR")) {
       cfg.server.addr = net::ip::make_address(addr);
@@ -60,4 +132,8 @@ void init(cli::Args args) {
   });
 }
 
+std::shared_ptr<const model::GameConfig> reload_game() {
+  return cfg.game->reload(json_loader::load_game_config(cfg.server.game_config_file, *cfg.game));
+}
+
 } // namespace config
\ No newline at end of file
@@ -2,6 +2,8 @@
 
 #include "game.hpp"
 #include "cli.hpp"
+#include "leaderboard.hpp"
+#include "admission.hpp"
 
 #include <boost/asio/ip/tcp.hpp>
 #include <chrono>
@@ -15,6 +17,20 @@ namespace fs = std::filesystem;
 using clock = std::chrono::steady_clock;
 using namespace std::literals;
 
+// Параметры принимающих сокетов
+struct ListenerConfig {
+  // Число acceptor'ов на одном адресе. Если их больше одного, сокеты
+  // открываются с SO_REUSEPORT и ядро распределяет соединения между ними
+  unsigned acceptors { 1u };
+  bool reuse_port { false };
+  int backlog { net::socket_base::max_listen_connections };
+
+  bool tcp_nodelay { false };
+
+  // Соединение передаётся acceptor'у, только когда пришли данные
+  std::optional<std::chrono::seconds> defer_accept;
+};
+
 struct ServerConfig {
   net::ip::port_type port { 8080u };
   net::ip::address addr { net::ip::make_address("0.0.0.0"sv) };
@@ -22,11 +38,38 @@ struct ServerConfig {
   clock::duration read_timeout  { 15s };
   clock::duration write_timeout { 15s };
 
+  ListenerConfig listener;
+  admission::Limits admission;
+  std::chrono::milliseconds admission_prune_period { 10s };
+
+  // Время на завершение начатых запросов при остановке. Без него сервер останавливается сразу
+  std::optional<std::chrono::milliseconds> drain_timeout;
+
+  // Unix-сокет, через который слушающие сокеты передаются новому процессу сервера
+  std::optional<fs::path> handoff_socket;
+  // Unix-сокет работающего сервера, у которого забираются слушающие сокеты при запуске
+  std::optional<fs::path> takeover_socket;
+
   fs::path www_root;
+  // Конфигурационный файл игры, из которого перечитываются её параметры
+  fs::path game_config_file;
+
+  bool admin_api { false };
+
+  // Число последних запросов, трассы которых хранятся в памяти. Без него трассировка выключена
+  std::optional<std::size_t> trace_capacity;
+
+  // Отдельный io_context на каждое ядро вместо общего для всех потоков
+  bool io_per_core { false };
 
   std::optional<fs::path> state_file;
   std::optional<std::chrono::milliseconds> tick_period;
   std::optional<std::chrono::milliseconds> state_save_period;
+
+  std::optional<fs::path> wal_file;
+  std::chrono::milliseconds wal_fsync_interval { 100ms };
+
+  std::chrono::milliseconds records_flush_period { 1s };
 };
 
 enum class AppEnv : std::uint8_t {
@@ -39,12 +82,18 @@ struct AppConfig {
   std::string_view log_level { "DEBUG"sv };
   
   mutable std::unique_ptr<model::Game> game;
+  mutable std::unique_ptr<leaderboard::Leaderboard> leaderboard;
+  mutable std::unique_ptr<admission::Controller> admission;
 
   ServerConfig server;
 };
 
 void init(cli::Args args);
 
+// Перечитывает параметры игры из конфигурационного файла. Они вступают в силу 
+// на границе следующего тика. При ошибке в файле действующие параметры не меняются
+std::shared_ptr<const model::GameConfig> reload_game();
+
 [[nodiscard]] const AppConfig& get() noexcept;
 
 } // namespace config
\ No newline at end of file
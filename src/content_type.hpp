@@ -1,19 +1,25 @@
-#pragma once 
+#pragma once
 
+#include <array>
+#include <stdexcept>
 #include <string>
+#include <string_view>
+#include <utility>
 
 namespace content_type {
 
+using namespace std::literals;
+
 enum Type {
   // text/...
   text_plain,
-  text_html, 
+  text_html,
   text_css,
   text_javascript,
-  
+
   // application/...
-  app_json, 
-  app_xml, 
+  app_json,
+  app_xml,
   app_octet_stream,
 
   // image/...
@@ -29,7 +35,107 @@ enum Type {
   audio_mpeg
 };
 
-[[nodiscard]] std::string_view get_as_text(const Type type);
-[[nodiscard]] Type get_ext_as_type(std::string_view extension);
+[[nodiscard]] constexpr std::string_view get_as_text(const Type type) {
+  switch (type) {
+    // text/...
+    case Type::text_plain      : return "text/plain"sv;
+    case Type::text_html       : return "text/html"sv;
+    case Type::text_css        : return "text/css"sv;
+    case Type::text_javascript : return "text/javascript"sv;
+
+    // application/...
+    case Type::app_json         : return "application/json"sv;
+    case Type::app_xml          : return "application/xml"sv;
+    case Type::app_octet_stream : return "application/octet-stream"sv;
+
+    // image/...
+    case Type::img_png  : return "image/png"sv;
+    case Type::img_jpeg : return "image/jpeg"sv;
+    case Type::img_gif  : return "image/gif"sv;
+    case Type::img_bmp  : return "image/bmp"sv;
+    case Type::img_ico  : return "image/vnd.microsoft.icon"sv;
+    case Type::img_tiff : return "image/tiff"sv;
+    case Type::img_svg  : return "image/svg+xml"sv;
+
+    // audio/...
+    case Type::audio_mpeg : return "audio/mpeg"sv;
+  }
+
+  throw std::invalid_argument("Unknown content type"s);
+}
+
+namespace detail {
+
+// Расширения хранятся в нижнем регистре
+inline constexpr std::array<std::pair<std::string_view, Type>, 19> file_ext {{
+  // text
+  { "htm"sv,  Type::text_html },
+  { "html"sv, Type::text_html },
+  { "css"sv,  Type::text_css },
+  { "txt"sv,  Type::text_plain },
+  { "js"sv,   Type::text_javascript },
+
+  // application
+  { "json"sv, Type::app_json },
+  { "xml"sv,  Type::app_xml },
+
+  // image
+  { "png"sv,  Type::img_png },
+  { "jpg"sv,  Type::img_jpeg },
+  { "jpe"sv,  Type::img_jpeg },
+  { "jpeg"sv, Type::img_jpeg },
+  { "gif"sv,  Type::img_gif },
+  { "bmp"sv,  Type::img_bmp },
+  { "ico"sv,  Type::img_ico },
+  { "tiff"sv, Type::img_tiff },
+  { "tif"sv,  Type::img_tiff },
+  { "svg"sv,  Type::img_svg },
+  { "svgz"sv, Type::img_svg },
+
+  // audio
+  { "mp3"sv, Type::audio_mpeg },
+}};
+
+constexpr char to_lower(const char c) noexcept {
+  return (c >= 'A' && c <= 'Z') ? static_cast<char>(c - 'A' + 'a') : c;
+}
+
+// Сравнивает строку с расширением из таблицы без учёта регистра
+constexpr bool equals_lower(std::string_view str, std::string_view lower) noexcept {
+  if (str.size() != lower.size()) {
+    return false;
+  }
+
+  for (std::size_t i = 0; i < str.size(); ++i) {
+    if (to_lower(str[i]) != lower[i]) {
+      return false;
+    }
+  }
+
+  return true;
+}
+
+} // namespace detail
+
+// Тип содержимого по расширению файла (с точкой или без). Регистр не учитывается,
+// неизвестные расширения считаются двоичными данными
+[[nodiscard]] constexpr Type get_ext_as_type(std::string_view extension) noexcept {
+  if (const auto idx = extension.find('.'); idx != std::string_view::npos) {
+    extension.remove_prefix(idx + 1);
+  }
+
+  // Расширения из таблицы не длиннее четырёх символов
+  if (extension.size() < 2u || extension.size() > 4u) {
+    return Type::app_octet_stream;
+  }
+
+  for (const auto& [ext, type] : detail::file_ext) {
+    if (detail::equals_lower(extension, ext)) {
+      return type;
+    }
+  }
+
+  return Type::app_octet_stream;
+}
 
-} // namespace content_type
\ No newline at end of file
+} // namespace content_type
@@ -4,26 +4,24 @@
 
 namespace core {
 
-geom::Position GameEngine::generate_object_position(bool random_position) const {
+geom::Position GameEngine::generate_object_position(util::Xoshiro256& rng, bool random_position) const {
   if (!random_position) {
     return { 0.0, 0.0 };
   }  
 
   decltype(auto) roads = map_.get_roads();  
 
-  std::random_device rd;
-  std::mt19937_64 gen(rd());
   std::uniform_int_distribution<std::uint32_t> u_idx(0, roads.size()-1);
   
-  const auto road_idx = u_idx(gen);
+  const auto road_idx = u_idx(rng);
   decltype(auto) road = roads[road_idx];
 
   if (road.is_horizontal()) {
     std::uniform_real_distribution<double> ux(road.get_start().x, road.get_end().x);
-    return { ux(gen), road.get_start().y };
+    return { ux(rng), road.get_start().y };
   } else {
     std::uniform_real_distribution<double> uy(road.get_start().y, road.get_end().y);
-    return { road.get_start().x, uy(gen) };    
+    return { road.get_start().x, uy(rng) };    
   }
 }
 
@@ -2,6 +2,7 @@
 
 #include "map.hpp"
 #include "geometry.hpp"
+#include "random.hpp"
 
 namespace core {
 
@@ -11,7 +12,9 @@ public:
     : map_(map) {
   }
 
-  [[nodiscard]] geom::Position generate_object_position(bool random_position = true) const;
+  // Случайные координаты берутся из генератора вызывающей стороны,
+  // поэтому при одинаковом зерне позиции повторяются
+  [[nodiscard]] geom::Position generate_object_position(util::Xoshiro256& rng, bool random_position = true) const;
   [[nodiscard]] geom::Position calculate_object_position(const geom::Position& current_position, const geom::Speed& speed, std::int64_t delta) const; 
 
 private:
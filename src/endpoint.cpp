@@ -1,43 +1,88 @@
 #include "endpoint.hpp"
 #include "config.hpp"
 #include "response.hpp"
+#include "action_parser.hpp"
+#include "profiler.hpp"
 
+#include <boost/asio/post.hpp>
 #include <boost/json.hpp>
+#include <algorithm>
+#include <charconv>
+#include <optional>
 #include <stdexcept>
+#include <variant>
 
 namespace endpoint {
 
 using namespace std::literals;
 
 namespace json = boost::json;
+namespace net = boost::asio;
 namespace ct = content_type;
 
-app::Token::Type extract_token(std::string_view value) {
-  const app::Token::Type token(value);
-  return token.substr("Bearer"s.length() + 1, value.length());
+// Возвращает значение параметра строки запроса или std::nullopt, если параметра нет
+std::optional<std::string_view> query_param(std::string_view target, std::string_view name) {
+  const auto query_pos = target.find('?');
+
+  if (query_pos == std::string_view::npos) {
+    return std::nullopt;
+  }
+
+  auto query = target.substr(query_pos + 1);
+
+  while (!query.empty()) {
+    const auto param = query.substr(0, query.find('&'));
+    const auto eq_pos = param.find('=');
+
+    if (param.substr(0, eq_pos) == name) {
+      return (eq_pos == std::string_view::npos) ? std::string_view{} : param.substr(eq_pos + 1);
+    }
+
+    query.remove_prefix(std::min(query.size(), param.size() + 1));
+  }
+
+  return std::nullopt;
+}
+
+// Направление движения: пустая строка (остановка) или одна из букв L, R, U, D
+bool is_valid_move(std::string_view direction) {
+  return model::Character::Direction::from_letter(direction).has_value();
+}
+
+// Находит игрока по токену из заголовка Authorization. Если игрок
+// не найден, возвращает готовый ответ с ошибкой
+std::variant<app::Player*, http_response_t> authorize(const http_string_request_t& req) {
+  const auto it = req.base().find(http::field::authorization);
+
+  if ((it == req.base().cend()) || !it->value().starts_with("Bearer"sv)) {
+    return response::make(response::Unauthorized<ct::app_json>(req.version(), req.keep_alive())
+      .cache(response::CachePolicy::no_cache)
+      .add_body(response::basic_json_body::header_missing("Authorization header is missing"sv))
+    );
+  } 
+
+  const auto player = app::Players::instance().find_by_token(app::extract_token(it->value()));
+
+  if (!player) {
+    return response::make(response::Unauthorized<ct::app_json>(req.version(), req.keep_alive())
+      .cache(response::CachePolicy::no_cache)
+      .add_body(response::basic_json_body::bad_response("unknownToken"sv, "Player token has not been found"sv))
+    );
+  }
+
+  return player;
 }
 
 template <typename Fn>
 http_handler::HandlerFunc::Type auth_middleware(Fn&& next) {
   return [next](http_string_request_t&& req) -> http_response_t {
-    const auto it = req.base().find("Authorization"sv);
+    auto result = authorize(req);
 
-    if ((it == req.base().cend()) || !it->value().starts_with("Bearer"sv)) {
-      return response::make(response::Unauthorized<ct::app_json>(req.version(), req.keep_alive())
-        .add_field(http::field::cache_control, "no-cache"sv)
-        .add_body(response::basic_json_body::header_missing("Authorization header is missing"sv))
-      );
-    } 
-
-    const auto player = app::Players::instance().find_by_token(extract_token(it->value()));
-    if (!player) {
-      return response::make(response::Unauthorized<ct::app_json>(req.version(), req.keep_alive())
-        .add_field(http::field::cache_control, "no-cache"sv)
-        .add_body(response::basic_json_body::bad_response("unknownToken"sv, "Player token has not been found"sv))
-      );
+    if (const auto player = std::get_if<app::Player*>(&result)) {
+      return next(*player, std::move(req));
     }
 
-    return next(player, std::move(req));
+    return std::move(std::get<http_response_t>(result));
   };
 }
 
@@ -78,7 +123,7 @@ http_response_t GameJoin::handler(http_string_request_t&& req) {
 
   if ((it == req.base().cend()) || it->value() != ct::get_as_text(ct::app_json)) {
     return response::make(response::BadRequest<ct::app_json>(req.version(), req.keep_alive())
-      .add_field(http::field::cache_control, "no-cache"sv)
+      .cache(response::CachePolicy::no_cache)
       .add_body(response::basic_json_body::invalid_argument("Invalid Content-Type header"sv))
     );
   }
@@ -94,7 +139,7 @@ http_response_t GameJoin::handler(http_string_request_t&& req) {
 
     if (username.empty()) {
       return response::make(response::BadRequest<ct::app_json>(req.version(), req.keep_alive())
-        .add_field(http::field::cache_control, "no-cache"sv)
+        .cache(response::CachePolicy::no_cache)
         .add_body(response::basic_json_body::invalid_argument("Invalid name"sv))
       );
     }
@@ -103,7 +148,7 @@ http_response_t GameJoin::handler(http_string_request_t&& req) {
 
   } catch (...) {
     return response::make(response::BadRequest<ct::app_json>(req.version(), req.keep_alive())
-      .add_field(http::field::cache_control, "no-cache"sv)
+      .cache(response::CachePolicy::no_cache)
       .add_body(response::basic_json_body::invalid_argument("Join game request parse error"sv))
     );
   }
@@ -112,16 +157,21 @@ http_response_t GameJoin::handler(http_string_request_t&& req) {
 
   if (!map) {
     return response::make(response::NotFound<ct::app_json>(req.version(), req.keep_alive())
-      .add_field(http::field::cache_control, "no-cache"sv)
+      .cache(response::CachePolicy::no_cache)
       .add_body(response::basic_json_body::map_not_found())
     ); 
   }
 
   auto session = config::get().game->get_session(map);
-  auto dog = model::create_character<model::Dog>(std::move(username), session->config().bag_capacity);
+  // Параметры сессии меняются на её strand'е, поэтому вместимость рюкзака берётся из конфигурации игры
+  auto dog = model::create_character<model::Dog>(std::move(username), config::get().game->session_config(*map).bag_capacity);
 
   auto [id, character] = session->add_character(std::move(dog));
-  const auto& [token, player] = app::Players::instance().new_player(character, *session);
+  const auto& [token, player] = app::Players::instance().new_player(id, character, *session);
+
+  if (const auto journal = config::get().game->journal()) {
+    journal->append(wal::Token{ session->id(), id, token });
+  }
 
   return response::make(response::SuccessJoin(req.version(), req.keep_alive(), std::move(token), id));   
 }
@@ -134,8 +184,8 @@ std::unique_ptr<mux::Route> GameJoin::route() {
   route->handler_func(std::bind(&GameJoin::handler, this, std::placeholders::_1));
 
   route->not_allowed_handler([allowed = route->allowed_methods()](http_string_request_t&& req) {
-    return response::make(response::MethodNotAllowed<ct::app_json>(req.version(), req.keep_alive(), allowed.as_string())
-      .add_field(http::field::cache_control, "no-cache"sv)
+    return response::make(response::MethodNotAllowed<ct::app_json>(req.version(), req.keep_alive(), allowed)
+      .cache(response::CachePolicy::no_cache)
       .add_body(response::basic_json_body::invalid_method("Expected: "s + allowed.as_string()))
     );
   });
@@ -153,10 +203,11 @@ std::unique_ptr<mux::Route> GetPlayers::route() {
   route->path("^/api/v1/game/players$"sv);
   route->methods(http_methods::Method::get | http_methods::Method::head);
   route->handler_func(auth_middleware(std::bind(&GetPlayers::handler, this, std::placeholders::_1, std::placeholders::_2)));
+  route->session_bound();
 
   route->not_allowed_handler([allowed = route->allowed_methods()](http_string_request_t&& req) {
-    return response::make(response::MethodNotAllowed<ct::app_json>(req.version(), req.keep_alive(), allowed.as_string())
-      .add_field(http::field::cache_control, "no-cache"sv)
+    return response::make(response::MethodNotAllowed<ct::app_json>(req.version(), req.keep_alive(), allowed)
+      .cache(response::CachePolicy::no_cache)
       .add_body(response::basic_json_body::invalid_method("Expected: "s + allowed.as_string()))
     );
   });
@@ -197,10 +248,11 @@ std::unique_ptr<mux::Route> GetGameState::route() {
   route->path("^/api/v1/game/state$"sv);
   route->methods(http_methods::Method::get | http_methods::Method::head);
   route->handler_func(auth_middleware(std::bind(&GetGameState::handler, this, std::placeholders::_1, std::placeholders::_2)));
+  route->session_bound();
 
   route->not_allowed_handler([allowed = route->allowed_methods()](http_string_request_t&& req) {
-    return response::make(response::MethodNotAllowed<ct::app_json>(req.version(), req.keep_alive(), allowed.as_string())
-      .add_field(http::field::cache_control, "no-cache"sv)
+    return response::make(response::MethodNotAllowed<ct::app_json>(req.version(), req.keep_alive(), allowed)
+      .cache(response::CachePolicy::no_cache)
       .add_body(response::basic_json_body::invalid_method("Expected: "s + allowed.as_string()))
     );
   });  
@@ -213,50 +265,154 @@ http_response_t PlayerAction::handler(http_string_request_t&& req) {
 
   if ((it == req.base().cend()) || it->value() != ct::get_as_text(ct::app_json)) {
     return response::make(response::BadRequest<ct::app_json>(req.version(), req.keep_alive())
-      .add_field(http::field::cache_control, "no-cache"sv)
+      .cache(response::CachePolicy::no_cache)
+      .add_body(response::basic_json_body::invalid_argument("Invalid Content-Type header"sv))
+    );
+  }
+
+  // Обычное тело {"move":"X"} разбирается без построения JSON-документа
+  auto direct = action_parser::parse_move(req.body());
+
+  if (!direct) {
+    try {
+      json::object req_body = json::parse(req.body()).as_object();
+      const auto& move = req_body.at("move"sv).as_string();
+      direct = model::Character::Direction::from_letter(std::string_view(move.data(), move.size()));
+
+      if (!direct) {
+        throw std::invalid_argument("Invalid move direction value"s);
+      }
+    } catch (...) {
+      return response::make(response::BadRequest<ct::app_json>(req.version(), req.keep_alive())
+        .cache(response::CachePolicy::no_cache)
+        .add_body(response::basic_json_body::invalid_argument("Failed to parse action"sv))
+      );
+    }
+  }
+
+  auto result = authorize(req);
+
+  if (const auto response = std::get_if<http_response_t>(&result)) {
+    return std::move(*response);
+  }
+
+  const auto player = std::get<app::Player*>(result);
+  player->game_session().move_character(player->character_id(), *direct);
+
+  return response::make(response::MovePlayer(req.version(), req.keep_alive()));
+}
+
+std::unique_ptr<mux::Route> PlayerAction::route() {
+  auto route = std::make_unique<mux::Route>();
+
+  route->path("^/api/v1/game/player/action$"sv);
+  route->methods(http_methods::Method::post);
+  route->handler_func(std::bind(&PlayerAction::handler, this, std::placeholders::_1));
+  route->session_bound();
+
+  route->not_allowed_handler([allowed = route->allowed_methods()](http_string_request_t&& req) {
+    return response::make(response::MethodNotAllowed<ct::app_json>(req.version(), req.keep_alive(), allowed)
+      .cache(response::CachePolicy::no_cache)
+      .add_body(response::basic_json_body::invalid_method("Expected: "s + allowed.as_string()))
+    );
+  });
+
+  return route;  
+}
+
+http_response_t PlayerActionsBatch::handler(http_string_request_t&& req) {
+  constexpr std::size_t MAX_ACTIONS = 1000u;
+
+  using Action = std::pair<app::Token::Type, std::string>;
+  using SessionActions = std::pair<model::GameSession::Strand, std::vector<Action>>;
+
+  const auto it = req.base().find("Content-Type"sv);
+
+  if ((it == req.base().cend()) || it->value() != ct::get_as_text(ct::app_json)) {
+    return response::make(response::BadRequest<ct::app_json>(req.version(), req.keep_alive())
+      .cache(response::CachePolicy::no_cache)
       .add_body(response::basic_json_body::invalid_argument("Invalid Content-Type header"sv))
     );
   }
 
-  std::string direction;
+  std::vector<Action> actions;
 
   try {
-    json::object req_body = json::parse(req.body()).as_object();
-    direction = req_body.at("move"sv).as_string();
+    const auto& items = json::parse(req.body()).as_object().at("actions"sv).as_array();
+
+    if (items.size() > MAX_ACTIONS) {
+      throw std::invalid_argument("Too many actions"s);
+    }
+
+    actions.reserve(items.size());
 
-    if (!direction.empty()) {
-      const auto pos = direction.find_first_of("LRUD"sv);
+    for (const auto& item : items) {
+      const auto& action = item.as_object();
+      const auto& direction = action.at("move"sv).as_string();
 
-      if (direction.length() > 1 || (pos == std::string::npos)) {
+      if (!is_valid_move(direction)) {
         throw std::invalid_argument("Invalid move direction value"s);
       }
-    }
 
+      actions.emplace_back(action.at("token"sv).as_string(), direction);
+    }
   } catch (...) {
     return response::make(response::BadRequest<ct::app_json>(req.version(), req.keep_alive())
-      .add_field(http::field::cache_control, "no-cache"sv)
-      .add_body(response::basic_json_body::invalid_argument("Failed to parse action"sv))
+      .cache(response::CachePolicy::no_cache)
+      .add_body(response::basic_json_body::invalid_argument("Failed to parse actions"sv))
     );
   }
-  
-  return auth_middleware([&direction](app::Player *const player, http_string_request_t&& req) {
-    auto& character = player->character();
-    character.move(model::Character::Direction(direction), player->game_session().config().characters_speed);
 
-    return response::make(response::MovePlayer(req.version(), req.keep_alive()));
-  })(std::move(req));
+  // Действия группируются по игровым сессиям: сессий в пакете обычно немного,
+  // поэтому strand ищется линейно
+  std::vector<SessionActions> sessions;
+  std::size_t unknown = 0u;
+
+  for (auto& action : actions) {
+    const auto strand = app::Players::instance().find_session_strand(action.first);
+
+    if (!strand) {
+      unknown++;
+      continue;
+    }
+
+    auto session = std::find_if(sessions.begin(), sessions.end(), [&strand](const SessionActions& s) {
+      return s.first == *strand;
+    });
+
+    if (session == sessions.end()) {
+      session = sessions.insert(sessions.end(), { *strand, {} });
+    }
+
+    session->second.push_back(std::move(action));
+  }
+
+  // Игрок мог выйти из игры до выполнения задачи, поэтому на strand'е сессии он ищется повторно
+  for (auto& [strand, session_actions] : sessions) {
+    net::post(strand, [strand, session_actions = std::move(session_actions)] {
+      for (const auto& [token, direction] : session_actions) {
+        const auto player = app::Players::instance().find_by_token(token);
+
+        if (player && player->game_session().strand() == strand) {
+          player->game_session().move_character(player->character_id(), model::Character::Direction(direction));
+        }
+      }
+    });
+  }
+
+  return response::make(response::ActionsBatch(req.version(), req.keep_alive(), actions.size() - unknown, unknown));
 }
 
-std::unique_ptr<mux::Route> PlayerAction::route() {
+std::unique_ptr<mux::Route> PlayerActionsBatch::route() {
   auto route = std::make_unique<mux::Route>();
 
-  route->path("^/api/v1/game/player/action$"sv);
+  route->path("^/api/v1/game/player/actions$"sv);
   route->methods(http_methods::Method::post);
-  route->handler_func(std::bind(&PlayerAction::handler, this, std::placeholders::_1));
+  route->handler_func(std::bind(&PlayerActionsBatch::handler, this, std::placeholders::_1));
 
   route->not_allowed_handler([allowed = route->allowed_methods()](http_string_request_t&& req) {
-    return response::make(response::MethodNotAllowed<ct::app_json>(req.version(), req.keep_alive(), allowed.as_string())
-      .add_field(http::field::cache_control, "no-cache"sv)
+    return response::make(response::MethodNotAllowed<ct::app_json>(req.version(), req.keep_alive(), allowed)
+      .cache(response::CachePolicy::no_cache)
       .add_body(response::basic_json_body::invalid_method("Expected: "s + allowed.as_string()))
     );
   });
@@ -264,12 +420,209 @@ std::unique_ptr<mux::Route> PlayerAction::route() {
   return route;  
 }
 
+http_response_t GetRecords::handler(http_string_request_t&& req) {
+  constexpr std::size_t MAX_ITEMS = 100u;
+
+  std::size_t start = 0u;
+  std::size_t max_items = MAX_ITEMS;
+
+  const auto parse_param = [&req](std::string_view name, std::size_t& value) {
+    if (const auto param = query_param(req.target(), name)) {
+      const auto [ptr, ec] = std::from_chars(param->data(), param->data() + param->size(), value);
+
+      if (ec != std::errc{} || ptr != param->data() + param->size()) {
+        throw std::invalid_argument("Invalid query parameter"s);
+      }
+    }
+  };
+
+  try {
+    parse_param("start"sv, start);
+    parse_param("maxItems"sv, max_items);
+
+    if (max_items > MAX_ITEMS) {
+      throw std::invalid_argument("maxItems is too large"s);
+    }
+  } catch (...) {
+    return response::make(response::BadRequest<ct::app_json>(req.version(), req.keep_alive())
+      .cache(response::CachePolicy::no_cache)
+      .add_body(response::basic_json_body::invalid_argument("Invalid records range"sv))
+    );
+  }
+
+  return response::make(response::Records(req.version(), req.keep_alive(), config::get().leaderboard->page(start, max_items)));
+}
+
+std::unique_ptr<mux::Route> GetRecords::route() {
+  auto route = std::make_unique<mux::Route>();
+
+  route->path("^/api/v1/game/records$"sv);
+  route->methods(http_methods::Method::get | http_methods::Method::head);
+  route->handler_func(std::bind(&GetRecords::handler, this, std::placeholders::_1));
+
+  route->not_allowed_handler([allowed = route->allowed_methods()](http_string_request_t&& req) {
+    return response::make(response::MethodNotAllowed<ct::app_json>(req.version(), req.keep_alive(), allowed)
+      .cache(response::CachePolicy::no_cache)
+      .add_body(response::basic_json_body::invalid_method("Expected: "s + allowed.as_string()))
+    );
+  });
+
+  return route;
+}
+
+std::unique_ptr<mux::Route> GetPlacementStats::route() {
+  auto route = std::make_unique<mux::Route>();
+
+  route->path("^/api/v1/admin/sessions$"sv);
+  route->methods(http_methods::Method::get | http_methods::Method::head);
+  route->handler_func([](http_string_request_t&& req) {
+    return response::make(response::PlacementStats(req.version(), req.keep_alive(), config::get().game->placement_stats()));
+  });
+
+  return route;
+}
+
+std::unique_ptr<mux::Route> GetAdmissionStats::route() {
+  auto route = std::make_unique<mux::Route>();
+
+  route->path("^/api/v1/admin/connections$"sv);
+  route->methods(http_methods::Method::get | http_methods::Method::head);
+  route->handler_func([](http_string_request_t&& req) {
+    return response::make(response::AdmissionStats(req.version(), req.keep_alive(), config::get().admission->stats()));
+  });
+
+  return route;
+}
+
+std::unique_ptr<mux::Route> GetTraceStats::route() {
+  auto route = std::make_unique<mux::Route>();
+
+  route->path("^/api/v1/admin/trace$"sv);
+  route->methods(http_methods::Method::get | http_methods::Method::head);
+  route->handler_func([](http_string_request_t&& req) {
+    return response::make(response::TraceStats(req.version(), req.keep_alive(), tracing::Tracer::instance().stats()));
+  });
+
+  return route;
+}
+
+std::unique_ptr<mux::Route> GetTraceEvents::route() {
+  auto route = std::make_unique<mux::Route>();
+
+  route->path("^/api/v1/admin/trace/events$"sv);
+  route->methods(http_methods::Method::get | http_methods::Method::head);
+  route->handler_func([](http_string_request_t&& req) {
+    return response::make(response::TraceEvents(req.version(), req.keep_alive(), tracing::Tracer::instance().recent()));
+  });
+
+  return route;
+}
+
+http_response_t Profile::handler(http_string_request_t&& req) {
+  auto& profiler = profiler::Profiler::instance();
+
+  if (req.method() != http::verb::post) {
+    return response::make(response::ProfileStatus(req.version(), req.keep_alive(), profiler.status()));
+  }
+
+  std::size_t seconds = 10u;
+  std::size_t frequency = profiler::Profiler::DEFAULT_FREQUENCY;
+
+  const auto parse_param = [&req](std::string_view name, std::size_t& value) {
+    if (const auto param = query_param(req.target(), name)) {
+      const auto [ptr, ec] = std::from_chars(param->data(), param->data() + param->size(), value);
+
+      if (ec != std::errc{} || ptr != param->data() + param->size()) {
+        throw std::invalid_argument("Invalid query parameter"s);
+      }
+    }
+  };
+
+  bool started = false;
+
+  try {
+    parse_param("seconds"sv, seconds);
+    parse_param("frequency"sv, frequency);
+
+    if (seconds > static_cast<std::size_t>(profiler::Profiler::MAX_DURATION.count()) || frequency > profiler::Profiler::MAX_FREQUENCY) {
+      throw std::invalid_argument("Profiling parameters are too large"s);
+    }
+
+    started = profiler.start(std::chrono::seconds(seconds), static_cast<unsigned>(frequency));
+  } catch (...) {
+    return response::make(response::BadRequest<ct::app_json>(req.version(), req.keep_alive())
+      .cache(response::CachePolicy::no_cache)
+      .add_body(response::basic_json_body::invalid_argument("Invalid profiling parameters"sv))
+    );
+  }
+
+  if (!started) {
+    return response::make(response::BadRequest<ct::app_json>(req.version(), req.keep_alive())
+      .cache(response::CachePolicy::no_cache)
+      .add_body(response::basic_json_body::bad_request("Profiling is already running"sv))
+    );
+  }
+
+  return response::make(response::ProfileStatus(req.version(), req.keep_alive(), profiler.status()));
+}
+
+std::unique_ptr<mux::Route> Profile::route() {
+  auto route = std::make_unique<mux::Route>();
+
+  route->path("^/api/v1/admin/profile$"sv);
+  route->methods(http_methods::Method::get | http_methods::Method::head | http_methods::Method::post);
+  route->handler_func(std::bind(&Profile::handler, this, std::placeholders::_1));
+
+  return route;
+}
+
+std::unique_ptr<mux::Route> GetProfileStacks::route() {
+  auto route = std::make_unique<mux::Route>();
+
+  route->path("^/api/v1/admin/profile/folded$"sv);
+  route->methods(http_methods::Method::get | http_methods::Method::head);
+  route->handler_func([](http_string_request_t&& req) {
+    auto stacks = profiler::Profiler::instance().folded();
+
+    if (!stacks) {
+      return response::make(response::BadRequest<ct::app_json>(req.version(), req.keep_alive())
+        .cache(response::CachePolicy::no_cache)
+        .add_body(response::basic_json_body::bad_request("Profiling is still running"sv))
+      );
+    }
+
+    return response::make(response::FoldedStacks(req.version(), req.keep_alive(), std::move(*stacks)));
+  });
+
+  return route;
+}
+
+std::unique_ptr<mux::Route> GameParameters::route() {
+  auto route = std::make_unique<mux::Route>();
+
+  route->path("^/api/v1/admin/config$"sv);
+  route->methods(http_methods::Method::get | http_methods::Method::head | http_methods::Method::post);
+  route->handler_func([reload = reload_](http_string_request_t&& req) {
+    if (req.method() == http::verb::post) {
+      reload();
+      return response::make(response::Accepted(req.version(), req.keep_alive()));
+    }
+
+    const auto& game = *config::get().game;
+
+    return response::make(response::GameParameters(req.version(), req.keep_alive(), 
+      game.get_maps(), *game.config(), game.reload_pending()));
+  });
+
+  return route;
+}
+
 http_response_t Tick::handler(http_string_request_t&& req) {
   const auto it = req.base().find("Content-Type"sv);
 
   if ((it == req.base().cend()) || it->value() != ct::get_as_text(ct::app_json)) {
     return response::make(response::BadRequest<ct::app_json>(req.version(), req.keep_alive())
-      .add_field(http::field::cache_control, "no-cache"sv)
+      .cache(response::CachePolicy::no_cache)
       .add_body(response::basic_json_body::invalid_argument("Invalid Content-Type header"sv))
     );
   }  
@@ -281,7 +634,7 @@ http_response_t Tick::handler(http_string_request_t&& req) {
     deltaTime = req_body.at("timeDelta"sv).as_int64();
   } catch (...) {
     return response::make(response::BadRequest<ct::app_json>(req.version(), req.keep_alive())
-      .add_field(http::field::cache_control, "no-cache"sv)
+      .cache(response::CachePolicy::no_cache)
       .add_body(response::basic_json_body::invalid_argument("Failed to parse tick request JSON"sv))
     );
   }  
@@ -5,6 +5,8 @@
 #include "handlers.hpp"
 #include "player.hpp"
 
+#include <functional>
+
 namespace endpoint {
 
 using namespace common;
@@ -63,6 +65,72 @@ private:
   http_response_t handler(http_string_request_t&& req);
 };
 
+// Действия нескольких игроков одним запросом: {"actions": [{"token": "...", "move": "L"}, ...]}.
+// Действия каждой игровой сессии применяются одной задачей на её strand'е. Ответ не ждёт
+// этих задач: accepted - число действий с известными токенами, переданных сессиям, а не
+// применённых. Игрок, вышедший до выполнения задачи, пропускается без сообщения
+struct PlayerActionsBatch : public Endpoint {
+  std::unique_ptr<mux::Route> route() override; 
+
+private: 
+  http_response_t handler(http_string_request_t&& req);
+};
+
+struct GetRecords : public Endpoint {
+  std::unique_ptr<mux::Route> route() override;
+
+private:
+  http_response_t handler(http_string_request_t&& req);
+};
+
+struct GetPlacementStats : public Endpoint {
+  std::unique_ptr<mux::Route> route() override;
+};
+
+struct GetAdmissionStats : public Endpoint {
+  std::unique_ptr<mux::Route> route() override;
+};
+
+// Гистограммы этапов обработки запросов
+struct GetTraceStats : public Endpoint {
+  std::unique_ptr<mux::Route> route() override;
+};
+
+// Последние запросы в формате Chrome Trace Event (chrome://tracing, Perfetto)
+struct GetTraceEvents : public Endpoint {
+  std::unique_ptr<mux::Route> route() override;
+};
+
+// Профилирование процессорного времени: POST запускает профилирование
+// (?seconds=N&frequency=F), GET возвращает его состояние
+struct Profile : public Endpoint {
+  std::unique_ptr<mux::Route> route() override;
+
+private:
+  http_response_t handler(http_string_request_t&& req);
+};
+
+// Свёрнутые стеки последнего профилирования для flamegraph.pl
+struct GetProfileStacks : public Endpoint {
+  std::unique_ptr<mux::Route> route() override;
+};
+
+// Параметры игры. POST запускает reload, который перечитывает их из конфигурационного 
+// файла вне strand'а обработчика, и сразу отвечает 202 Accepted. Новые параметры 
+// вступают в силу на границе тика, ошибки разбора файла попадают в журнал
+struct GameParameters : public Endpoint {
+  using Reload = std::function<void()>;
+
+  explicit GameParameters(Reload reload)
+    : reload_(std::move(reload)) {
+  }
+
+  std::unique_ptr<mux::Route> route() override;
+
+private:
+  Reload reload_;
+};
+
 struct Tick : public Endpoint {
   std::unique_ptr<mux::Route> route() override;  
 
@@ -3,7 +3,9 @@
 #include "map.hpp"
 #include <boost/json.hpp>
 
-// This namespace stores data that can't be included into model
+// This namespace stores data that can't be included into model.
+// Loot types are kept here as raw JSON only for the map info response,
+// the game model uses the typed table of model::Map
 namespace extra_data {
 
 namespace json = boost::json;
@@ -13,7 +15,6 @@ public:
   void set(const model::Map::Id map_id, json::array loot_types);
 
   [[nodiscard]] const json::array& get(const model::Map::Id map_id) const;
-  [[nodiscard]] std::size_t loot_count(const model::Map::Id map_id) const;
 
   static LootTypes& instance() noexcept;
 
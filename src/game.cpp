@@ -1,11 +1,14 @@
 #include "game.hpp"
-#include "extra_data.hpp"
 #include "collisions.hpp"
 
+#include <cassert>
 #include <numeric>
+#include <optional>
 #include <stdexcept>
 #include <random>
 
+#include <boost/asio/post.hpp>
+
 namespace model {
 
 using namespace std::literals;
@@ -15,57 +18,210 @@ GameSession* GameSessionManager::get_session(const Game& game, const Map* map) {
     throw std::invalid_argument("Invalid map"s);
   }
 
-  auto sessions = sessions_.equal_range(map->get_id()); 
+  std::lock_guard lock(mutex_);
 
-  std::uint16_t min_players = std::numeric_limits<std::uint16_t>::max();
-  GameSession* relevant_session = nullptr;
+  auto& map_sessions = this->map_sessions(game, *map);
 
   // Выбираем игровую сессию с минимальным кол-вом игроков на карте
-  for (auto it = sessions.first; it != sessions.second; it++) {
-    const auto players_count = it->second->characters_count();
+  const auto least_occupied = map_sessions.by_occupancy.cbegin();
 
-    if (players_count == it->second->config().max_players)
-      continue;
-    
-    if (players_count < min_players) {
-      min_players = players_count;
-      relevant_session = it->second.get();
-    }
+  Slot* slot = nullptr;
+
+  if (least_occupied == map_sessions.by_occupancy.cend() || least_occupied->first >= map_sessions.max_players) {
+    slot = &create_session(game, *map, map_sessions);
+  } else {
+    slot = &sessions_.at(least_occupied->second);
   }
 
-  if (!relevant_session) {
-    GameSessionConfig cfg;
-    const auto& game_cfg = game.config();
+  update_occupancy(*slot, slot->players + 1);
+  stats_.placements++;
+
+  return slot->session.get();
+}
 
-    cfg.randomize_spawn = game_cfg.randomize_spawn;
+void GameSessionManager::release(const GameSession& session) {
+  std::lock_guard lock(mutex_);
 
-    if (const auto it = game_cfg.map_character_speed.find(map->get_id()); 
-        it != game_cfg.map_character_speed.cend()) {
-      cfg.characters_speed = it->second;
-    }
+  const auto it = sessions_.find(session.id());
 
-    if (const auto it = game_cfg.map_bag_capacity.find(map->get_id()); 
-        it != game_cfg.map_bag_capacity.cend()) {
-      cfg.bag_capacity = it->second;
+  if (it == sessions_.end() || it->second.players == 0) {
+    return;
+  }
+
+  update_occupancy(it->second, it->second.players - 1);
+}
+
+GameSessionManager::Slot& GameSessionManager::create_session(const Game& game, const Map& map, MapSessions& map_sessions) {
+  const auto id = next_session_id_++;
+  const auto seed = util::derive_seed(game.config()->seed, id);
+
+  if (const auto recorder = game.recorder()) {
+    recorder->session_created(id, seed, *map.get_id());
+  }
+
+  if (const auto journal = game.journal()) {
+    journal->append(wal::SessionCreated{ .session = id, .seed = seed, .map_id = *map.get_id() });
+  }
+
+  stats_.sessions_created++;
+
+  return emplace_session(game, map, id, seed);
+}
+
+GameSessionManager::Slot& GameSessionManager::emplace_session(const Game& game, const Map& map, GameSession::Id id, std::uint64_t seed) {
+  auto& map_sessions = this->map_sessions(game, map);
+
+  auto cfg = game.session_config(map);
+  cfg.seed = seed;
+  cfg.max_players = map_sessions.max_players;
+
+  auto session = std::make_shared<GameSession>(id, cfg, map, net::make_strand(game.io_context(id)));
+
+  session->recorder(game.recorder());
+  session->journal(game.journal());
+
+  session->retire_handler([this, &game](const GameSession& session, const Character& character) {
+    release(session);
+
+    if (const auto& handler = game.retire_handler()) {
+      handler(session, character);
     }
+  });
+
+  auto& slot = sessions_[id];
+  slot.session = std::move(session);
+  slot.loot_slot = loot_generator_.add();
+
+  map_sessions.by_occupancy.emplace(0u, id);
+
+  return slot;
+}
+
+GameSessionManager::MapSessions& GameSessionManager::map_sessions(const Game& game, const Map& map) {
+  auto [it, inserted] = map_sessions_.try_emplace(map.get_id());
+
+  if (inserted) {
+    it->second.max_players = game.session_config(map).max_players;
+  }
+
+  return it->second;
+}
+
+std::vector<GameSessionManager::SessionPtr> GameSessionManager::sessions() const {
+  std::lock_guard lock(mutex_);
 
-    relevant_session = create_session(std::move(cfg), *map); 
+  std::vector<SessionPtr> sessions;
+  sessions.reserve(sessions_.size());
+
+  for (const auto& [_, slot] : sessions_) {
+    sessions.push_back(slot.session);
   }
 
-  return relevant_session;
+  return sessions;
 }
 
-const GameSession* GameSessionManager::get_session(const Game& game, const Map* map) const { 
-  return get_session(game, map);
+GameSession& GameSessionManager::restore_session(const Game& game, const Map& map, GameSession::Id id, std::uint64_t seed) {
+  std::lock_guard lock(mutex_);
+
+  if (sessions_.contains(id)) {
+    throw std::invalid_argument("Game session "s + std::to_string(id) + " already exists"s);
+  }
+
+  next_session_id_ = std::max(next_session_id_, id + 1);
+
+  return *emplace_session(game, map, id, seed).session;
 }
 
-const GameSessionManager::Sessions& GameSessionManager::all_sessions() const noexcept {
-  return sessions_;
+void GameSessionManager::recount_players() {
+  std::lock_guard lock(mutex_);
+
+  for (auto& [_, slot] : sessions_) {
+    update_occupancy(slot, slot.session->characters_count());
+  }
 }
 
-GameSession* GameSessionManager::create_session(GameSessionConfig cfg, const Map& map) {
-  const auto it = sessions_.emplace(map.get_id(), std::make_unique<GameSession>(std::move(cfg), map));  
-  return it->second.get();
+void GameSessionManager::update_occupancy(Slot& slot, std::size_t players) {
+  auto& by_occupancy = map_sessions_.at(slot.session->map().get_id()).by_occupancy;
+  const auto id = slot.session->id();
+
+  by_occupancy.erase({slot.players, id});
+  by_occupancy.emplace(players, id);
+
+  stats_.players = stats_.players - slot.players + players;
+
+  slot.players = players;
+  slot.empty_for = std::chrono::milliseconds::zero();
+}
+
+void GameSessionManager::post_tick(std::int64_t delta, const GameConfig& cfg) {
+  std::lock_guard lock(mutex_);
+
+  for (auto it = sessions_.begin(); it != sessions_.end();) {
+    auto& [id, slot] = *it;
+
+    if (slot.players == 0) {
+      slot.empty_for += std::chrono::milliseconds(delta);
+
+      if (slot.empty_for >= cfg.session_idle_timeout) {
+        map_sessions_.at(slot.session->map().get_id()).by_occupancy.erase({0u, id});
+        loot_generator_.remove(slot.loot_slot);
+        stats_.sessions_reclaimed++;
+
+        // Задачи, уже переданные на strand сессии, удерживают её через shared_ptr
+        it = sessions_.erase(it);
+        continue;
+      }
+    }
+
+    loot_generator_.counts(slot.loot_slot, slot.session->loot_count(), slot.session->looter_count());
+    ++it;
+  }
+
+  loot_generator_.config(cfg.loot_generator);
+  loot_generator_.generate(std::chrono::milliseconds(delta));
+
+  for (const auto& [_, slot] : sessions_) {
+    net::post(slot.session->strand(), [session = slot.session, delta, amount = loot_generator_.generated(slot.loot_slot)] {
+      session->tick(delta, amount);
+    });
+  }
+}
+
+void GameSessionManager::reconfigure(const Game& game) {
+  std::lock_guard lock(mutex_);
+
+  // Сессии, в которых игроков больше нового ограничения, никого не теряют, 
+  // но не принимают новых игроков
+  for (auto& [map_id, map_sessions] : map_sessions_) {
+    if (const auto map = game.find_map(map_id)) {
+      map_sessions.max_players = game.session_config(*map).max_players;
+    }
+  }
+
+  for (const auto& [_, slot] : sessions_) {
+    auto cfg = game.session_config(slot.session->map());
+    cfg.max_players = map_sessions_.at(slot.session->map().get_id()).max_players;
+
+    net::post(slot.session->strand(), [session = slot.session, cfg = std::move(cfg)]() mutable {
+      session->reconfigure(std::move(cfg));
+    });
+  }
+}
+
+GameSessionManager::PlacementStats GameSessionManager::stats() const {
+  std::lock_guard lock(mutex_);
+
+  auto stats = stats_;
+  stats.sessions = sessions_.size();
+
+  for (const auto& [_, slot] : sessions_) {
+    auto& map_stats = stats.maps[slot.session->map().get_id()];
+
+    map_stats.sessions++;
+    map_stats.players += slot.players;
+  }
+
+  return stats;
 }
 
 void Game::add_map(const Map& map) {
@@ -97,58 +253,345 @@ const Map* Game::find_map(const Map::Id& id) const noexcept {
   return nullptr;
 }
 
-const GameConfig& Game::config() const noexcept {
-  return cfg_;
+std::shared_ptr<const GameConfig> Game::config() const noexcept {
+  return cfg_->current.load();
 }
 
 void Game::config(GameConfig cfg) {
-  cfg_ = std::move(cfg);
+  cfg_->current.store(std::make_shared<const GameConfig>(std::move(cfg)));
+  cfg_->pending.store(nullptr);
 }
 
-void Game::refresh_state(std::int64_t delta) {
-  if (!session_manager) {
-    return; 
+std::shared_ptr<const GameConfig> Game::reload(GameConfig cfg) {
+  const auto current = config();
+
+  // От зерна и способа размещения зависит воспроизведение журналов сессий
+  cfg.seed = current->seed;
+  cfg.randomize_spawn = current->randomize_spawn;
+
+  auto next = std::make_shared<const GameConfig>(std::move(cfg));
+  cfg_->pending.store(next);
+
+  return next;
+}
+
+bool Game::reload_pending() const noexcept {
+  return cfg_->pending.load() != nullptr;
+}
+
+GameSessionConfig Game::session_config(const Map& map) const {
+  const auto game_cfg = config();
+
+  GameSessionConfig cfg;
+
+  cfg.randomize_spawn = game_cfg->randomize_spawn;
+  cfg.retirement_time = game_cfg->retirement_time;
+
+  if (const auto it = game_cfg->map_character_speed.find(map.get_id()); 
+      it != game_cfg->map_character_speed.cend()) {
+    cfg.characters_speed = it->second;
+  }
+
+  if (const auto it = game_cfg->map_bag_capacity.find(map.get_id()); 
+      it != game_cfg->map_bag_capacity.cend()) {
+    cfg.bag_capacity = it->second;
   }
-  
-  for (const auto& [_, session] : session_manager->all_sessions()) {
-    session->recalc_characters_position(delta);
-    session->spawn_lost_objects(delta); 
 
-    session->process_collisions();
+  if (const auto it = game_cfg->map_max_players.find(map.get_id()); 
+      it != game_cfg->map_max_players.cend()) {
+    cfg.max_players = it->second;
   }
+
+  return cfg;
 }
 
-const GameSession* Game::get_session(const Map* map) const {
-  return get_session(map);
+void Game::recorder(std::shared_ptr<replay::Recorder> recorder) noexcept {
+  recorder_ = std::move(recorder);
 }
 
-GameSession* Game::get_session(const Map* map) {
+replay::Recorder* Game::recorder() const noexcept {
+  return recorder_.get();
+}
+
+void Game::journal(std::shared_ptr<wal::Journal> journal) {
+  journal_ = std::move(journal);
+
+  for (const auto& session : session_manager->sessions()) {
+    session->journal(journal_.get());
+  }
+}
+
+wal::Journal* Game::journal() const noexcept {
+  return journal_.get();
+}
+
+void Game::io_context(net::io_context& io) {
+  io_contexts_ = { &io };
+}
+
+void Game::io_contexts(std::vector<net::io_context*> contexts) {
+  io_contexts_ = std::move(contexts);
+}
+
+void Game::retire_handler(GameSession::RetireHandler handler) {
+  retire_handler_ = std::move(handler);
+}
+
+const GameSession::RetireHandler& Game::retire_handler() const noexcept {
+  return retire_handler_;
+}
+
+net::io_context& Game::io_context(GameSession::Id session) const {
+  if (io_contexts_.empty()) {
+    throw std::logic_error("Game io_context is not set"s);
+  }
+
+  return *io_contexts_[session % io_contexts_.size()];
+}
+
+void Game::refresh_state(std::int64_t delta) {
   if (!session_manager) {
-    session_manager = std::make_unique<GameSessionManager>();
+    return; 
   }
 
+  // Новая конфигурация вступает в силу на границе тика: параметры сессий 
+  // попадают на их strand'ы раньше задачи этого тика
+  if (auto next = cfg_->pending.exchange(nullptr)) {
+    cfg_->current.store(std::move(next));
+    session_manager->reconfigure(*this);
+  }
+  
+  session_manager->post_tick(delta, *config());
+}
+
+GameSession* Game::get_session(const Map* map) {
   return session_manager->get_session(*this, map);
 }
 
+void Game::leave_session(const GameSession& session) {
+  session_manager->release(session);
+}
+
+GameSessionManager::PlacementStats Game::placement_stats() const {
+  return session_manager->stats();
+}
+
+std::vector<GameSessionManager::SessionPtr> Game::sessions() const {
+  return session_manager->sessions();
+}
+
+GameSession& Game::restore_session(const Map& map, GameSession::Id id, std::uint64_t seed) {
+  return session_manager->restore_session(*this, map, id, seed);
+}
+
+void Game::recount_players() {
+  session_manager->recount_players();
+}
+
 const Map& GameSession::map() const noexcept {
   return map_;
 }
 
+GameSession::Id GameSession::id() const noexcept {
+  return id_;
+}
+
+const GameSession::Strand& GameSession::strand() const noexcept {
+  return strand_;
+}
+
+void GameSession::recorder(replay::Recorder* recorder) noexcept {
+  recorder_ = recorder;
+}
+
+void GameSession::journal(wal::Journal* journal) noexcept {
+  journal_ = journal;
+}
+
+void GameSession::restore_character(Character::Id id, std::shared_ptr<Character> character) {
+  characters_.insert_or_assign(id, std::move(character));
+  restore_counters(id + 1, loot_id_);
+  publish_counts();
+}
+
+void GameSession::restore_lost_object(const Loot& loot) {
+  lost_objects_.add(loot);
+  restore_counters(character_id_, loot.id + 1);
+  publish_counts();
+}
+
+void GameSession::restore_counters(Character::Id next_character_id, Loot::Id next_loot_id) noexcept {
+  character_id_ = std::max(character_id_.load(), next_character_id);
+  loot_id_ = std::max(loot_id_, next_loot_id);
+}
+
+void GameSession::remove_lost_object(Loot::Id id) {
+  std::optional<LootPool::Handle> found;
+
+  lost_objects_.for_each([id, &found](LootPool::Handle handle, const Loot& loot) {
+    if (loot.id == id) {
+      found = handle;
+    }
+  });
+
+  if (found) {
+    lost_objects_.remove(*found);
+  }
+
+  publish_counts();
+}
+
+void GameSession::remove_character(Character::Id id) {
+  characters_.erase(id);
+  publish_counts();
+}
+
+Character::Id GameSession::next_character_id() const noexcept {
+  return character_id_;
+}
+
+Loot::Id GameSession::next_loot_id() const noexcept {
+  return loot_id_;
+}
+
+void GameSession::tick(std::int64_t delta, unsigned lost_loot_amount) {
+  assert(strand_.running_in_this_thread());
+
+  if (recorder_) {
+    recorder_->tick(id_, delta, lost_loot_amount);
+  }
+
+  recalc_characters_position(delta);
+  spawn_lost_objects(lost_loot_amount); 
+
+  process_collisions();
+  retire_idle_characters(std::chrono::milliseconds(delta));
+
+  publish_counts();
+}
+
+void GameSession::retire_idle_characters(std::chrono::milliseconds delta) {
+  became_idle_.clear();
+
+  for (const auto& [id, character] : characters_) {
+    const auto was_active = character->idle_time() == std::chrono::milliseconds::zero();
+    character->update_activity(delta);
+
+    if (was_active && character->idle_time() > std::chrono::milliseconds::zero()) {
+      became_idle_.push_back(id);
+    }
+  }
+
+  // Таймер мог устареть, если персонаж успел сдвинуться с места
+  retirement_wheel_.advance(delta, [this](Character::Id id) {
+    if (const auto it = characters_.find(id); 
+        it != characters_.cend() && it->second->idle_time() >= cfg_.retirement_time) {
+      retire_queue_.push_back(id);
+    }
+  });
+
+  for (const auto id : became_idle_) {
+    retirement_wheel_.schedule(id, cfg_.retirement_time - characters_.at(id)->idle_time());
+  }
+
+  for (std::size_t retired = 0; !retire_queue_.empty() && retired < MAX_RETIREMENTS_PER_TICK;) {
+    const auto id = retire_queue_.front();
+    retire_queue_.pop_front();
+
+    const auto it = characters_.find(id);
+
+    if (it == characters_.end() || it->second->idle_time() < cfg_.retirement_time) {
+      continue;
+    }
+
+    const auto character = std::move(it->second);
+    characters_.erase(it);
+    retired++;
+
+    if (journal_) {
+      journal_->append(wal::Retire{ .session = id_, .character = id });
+    }
+
+    if (retire_handler_) {
+      retire_handler_(*this, *character);
+    }
+  }
+}
+
+void GameSession::reconfigure(GameSessionConfig config) {
+  assert(strand_.running_in_this_thread());
+
+  apply_config(std::move(config));
+
+  // Без этой записи воспроизведение и восстановление применяли бы 
+  // события после перезагрузки с прежними параметрами
+  const journal::Reconfigure event {
+    .session = id_,
+    .max_players = cfg_.max_players,
+    .bag_capacity = cfg_.bag_capacity,
+    .speed = cfg_.characters_speed,
+    .retirement_time = cfg_.retirement_time.count()
+  };
+
+  if (recorder_) {
+    recorder_->reconfigure(event);
+  }
+
+  if (journal_) {
+    journal_->append(event);
+  }
+}
+
+void GameSession::restore_config(GameSessionConfig config) {
+  apply_config(std::move(config));
+}
+
+void GameSession::apply_config(GameSessionConfig config) {
+  config.seed = cfg_.seed;
+  config.randomize_spawn = cfg_.randomize_spawn;
+
+  const auto speed_changed = config.characters_speed != cfg_.characters_speed;
+  const auto retirement_changed = config.retirement_time != cfg_.retirement_time;
+
+  cfg_ = std::move(config);
+
+  for (const auto& [id, character] : characters_) {
+    // Уже собранные предметы остаются в рюкзаке, даже если он стал меньше
+    character->bagpack.capacity(cfg_.bag_capacity);
+
+    if (speed_changed && character->speed() != geom::Speed{0.0, 0.0}) {
+      character->move(character->direction(), cfg_.characters_speed);
+    }
+
+    // Таймеры отставки были рассчитаны по прежнему времени. Устаревшие 
+    // таймеры отбрасываются при срабатывании проверкой времени бездействия
+    if (retirement_changed && character->idle_time() > std::chrono::milliseconds::zero()) {
+      retirement_wheel_.schedule(id, cfg_.retirement_time - character->idle_time());
+    }
+  }
+}
+
+void GameSession::retire_handler(RetireHandler handler) {
+  retire_handler_ = std::move(handler);
+}
+
 void GameSession::process_collisions() {
-  auto& provider = collisions::LootCharacterProvider::instance();
-  
+  lost_objects_.for_each([this](LootPool::Handle handle, const Loot& loot) {
+    provider_.add_object<collisions::Item>({loot.position, loot.WIDTH, handle});
+  });
+
   for (const auto& office : map_.get_offices()) {
-    provider.add_object<collisions::Base>({office.get_position(), office.WIDTH});  
+    provider_.add_object<collisions::Base>({office.get_position(), office.WIDTH});  
   } 
    
-  const auto events = collisions::find_gather_events(provider);
+  const auto events = collisions::find_gather_events(provider_);
 
   // 1. Игрок берёт все предметы, мимо которых он проходит, если рюкзак не полон
   // 2. Игрок пропускает предмет, если рюкзак полон
   // 3. Проходя мимо базы, игрок убирает все предметы из рюкзака.
 
   for (const auto& event : events) {
-    const auto& gatherer = provider.get_gatherer(event.gatherer_idx);
+    const auto& gatherer = provider_.get_gatherer(event.gatherer_idx);
     auto it_char = characters_.find(gatherer.id);
     
     if (it_char == characters_.end()) {
@@ -156,30 +599,40 @@ void GameSession::process_collisions() {
     }
 
     auto character = it_char->second.get();
-    const auto& object = provider.get_object(event.object_idx);
+    const auto& object = provider_.get_object(event.object_idx);
     
     switch (object.type()) {
       case collisions::ObjectType::loot : {
-        auto item = static_cast<const collisions::Item&>(object);
-        
-        auto it_loot = lost_objects_.find(item.id); 
+        const auto& item = static_cast<const collisions::Item&>(object);
+        const auto handle = static_cast<LootPool::Handle>(item.id);
+
+        // Предмет уже мог подобрать другой игрок
+        if (!character->bagpack.is_full() && lost_objects_.contains(handle)) {
+          const auto& loot = lost_objects_.get(handle);
+
+          if (journal_) {
+            journal_->append(wal::Collect{ .session = id_, .character = gatherer.id, .loot = loot });
+          }
 
-        if (!character->bagpack.is_full()) {
           // Перемещаем предмент в рюкзак игрока
-          character->bagpack.add(it_loot->first, it_loot->second);
+          character->bagpack.add(loot);
           // Убираем предмет с карты
-          lost_objects_.erase(it_loot);
+          lost_objects_.remove(handle);
         }
 
         break;
       } case collisions::ObjectType::base : {
         if (character->bagpack.is_full()) {
-          for (const auto& [_, loot] : character->bagpack.get()) {
+          for (const auto& loot : character->bagpack.get()) {
             // Начисляем очки игроку за каждый собранный предмет
-            character->add_points(loot->value());
+            character->add_points(loot.value);
           }
 
           character->bagpack.clear();
+
+          if (journal_) {
+            journal_->append(wal::Score{ .session = id_, .character = gatherer.id, .score = character->score() });
+          }
         }
 
         break;        
@@ -187,27 +640,73 @@ void GameSession::process_collisions() {
     }
   } 
 
-  provider.clear_gatherers();
-  provider.clear_objects();
+  provider_.clear_gatherers();
+  provider_.clear_objects();
 }
 
 GameSession::IdCharPair GameSession::add_character(std::shared_ptr<Character> character) {  
-  static const bool randomize_spawn = cfg_.randomize_spawn;
-  const auto pos = engine.generate_object_position(randomize_spawn); 
+  const auto id = character_id_.fetch_add(1u);
 
-  character->position(std::move(pos));
-  
-  const auto [it, _] = characters_.try_emplace(character_id_++, std::move(character));
-  return { it->first, it->second };
+  net::post(strand_, [this, id, character] {
+    join(id, std::move(character));
+  });
+
+  return { id, std::move(character) };
 }
 
-GameSession::IdLootPair GameSession::add_lost_object(std::shared_ptr<Loot> lost_object) {
-  const auto pos = engine.generate_object_position(false);
-  
-  lost_object->position(std::move(pos));
+void GameSession::join(Character::Id id, std::shared_ptr<Character> character) {
+  assert(strand_.running_in_this_thread());
 
-  const auto [it, _] = lost_objects_.try_emplace(loot_id_++, std::move(lost_object));
-  return { it->first, it->second }; 
+  // Идентификатор мог быть выделен не через add_character (например, при воспроизведении)
+  for (auto next = character_id_.load(); next <= id && !character_id_.compare_exchange_weak(next, id + 1);) {
+  }
+
+  if (recorder_) {
+    recorder_->join(id_, id, character->name());
+  }
+
+  character->position(engine.generate_object_position(rng_, cfg_.randomize_spawn));
+
+  if (journal_) {
+    journal_->append(wal::Join{ 
+      .session = id_, 
+      .character = id, 
+      .name = std::string(character->name()), 
+      .position = character->position() 
+    });
+  }
+
+  characters_.try_emplace(id, std::move(character));
+  publish_counts();
+}
+
+void GameSession::move_character(Character::Id id, Character::Direction direction) {
+  assert(strand_.running_in_this_thread());
+
+  const auto it = characters_.find(id);
+
+  if (it == characters_.cend()) {
+    return;
+  }
+
+  if (recorder_) {
+    recorder_->move(id_, id, direction.value());
+  }
+
+  if (journal_) {
+    journal_->append(wal::Move{ .session = id_, .character = id, .direction = direction.value() });
+  }
+
+  it->second->move(direction, cfg_.characters_speed);
+}
+
+LootPool::Handle GameSession::add_lost_object(Loot::Type type, Loot::Value value) {
+  return lost_objects_.add({
+    .id = loot_id_++,
+    .type = type,
+    .value = value,
+    .position = engine.generate_object_position(rng_, false)
+  });
 }
 
 [[nodiscard]] std::size_t GameSession::characters_count() const noexcept {
@@ -222,7 +721,7 @@ const GameSession::LostObjects& GameSession::lost_objects() const noexcept {
   return lost_objects_;
 }
 
-void GameSession::recalc_characters_position(std::int64_t delta) const {
+void GameSession::recalc_characters_position(std::int64_t delta) {
   for (auto& [id, character] : characters_) {
     auto new_position = engine.calculate_object_position(character->position(), character->speed(), delta);
 
@@ -233,43 +732,41 @@ void GameSession::recalc_characters_position(std::int64_t delta) const {
       .id = id,
     };
 
-    collisions::LootCharacterProvider::instance().add_gatherer(std::move(gatherer));
+    provider_.add_gatherer(std::move(gatherer));
 
     character->position(std::move(new_position));
   }
 }
 
-void GameSession::spawn_lost_objects(std::int64_t delta) { 
-  const auto lost_loot_amount = 
-    model::LootGenerator::instance().generate(std::chrono::milliseconds(delta), lost_objects_.size(), characters_.size());   
-  
-  if (lost_loot_amount == 0)
-    return; // nothing to spawn
+void GameSession::spawn_lost_objects(unsigned lost_loot_amount) { 
+  const auto& loot_types = map_.get_loot_types();
 
-  std::random_device rd;
-  std::mt19937_64 gen(rd());
+  if (lost_loot_amount == 0 || loot_types.empty())
+    return; // nothing to spawn
 
-  auto& loot_types = extra_data::LootTypes::instance(); 
-  
-  const auto loot_count = loot_types.loot_count(map_.get_id());
-  std::uniform_int_distribution<std::uint32_t> u_idx(0, loot_count-1); 
+  std::uniform_int_distribution<std::size_t> u_idx(0, loot_types.size()-1); 
 
   for (std::size_t i = 0; i < lost_loot_amount; i++) {
-    const auto loot_type = u_idx(gen);
-    auto& loot = loot_types.get(map_.get_id())[loot_type];
+    const auto& loot_type = loot_types[u_idx(rng_)];
+    add_lost_object(loot_type.index, loot_type.value);
+  }
+}
 
-    const auto loot_name = loot.at("name"sv).as_string().c_str();
-    const auto loot_value = loot.at("value"sv).as_int64();
+void GameSession::publish_counts() noexcept {
+  loot_count_.store(static_cast<unsigned>(lost_objects_.size()), std::memory_order_relaxed);
+  looter_count_.store(static_cast<unsigned>(characters_.size()), std::memory_order_relaxed);
+}
 
-    auto lost_object = create_loot(loot_name, loot_type, loot_value);
+unsigned GameSession::loot_count() const noexcept {
+  return loot_count_.load(std::memory_order_relaxed);
+}
 
-    if (lost_object) {
-      const auto [id, obj] = add_lost_object(std::move(lost_object)); 
+unsigned GameSession::looter_count() const noexcept {
+  return looter_count_.load(std::memory_order_relaxed);
+}
 
-      collisions::Item item(obj->position(), obj->width(), id);     
-      collisions::LootCharacterProvider::instance().add_object(std::move(item));
-    }
-  }
+std::uint64_t GameSession::seed() const noexcept {
+  return cfg_.seed;
 }
 
 const GameSessionConfig& GameSession::config() const noexcept {
@@ -4,9 +4,30 @@
 #include "map.hpp"
 #include "loot.hpp"
 #include "core.hpp"
+#include "collisions.hpp"
+#include "timing_wheel.hpp"
+#include "random.hpp"
+#include "replay.hpp"
+#include "wal.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <vector>
+
+#include <boost/asio/io_context.hpp>
+#include <boost/asio/strand.hpp>
 
 namespace model {
 
+namespace net = boost::asio;
+
+using namespace std::literals;
+
 struct GameConfig {
   using MapCharacterSpeed = std::unordered_map<Map::Id, double, Map::IdHasher>;
   using MapBagCapacity = std::unordered_map<Map::Id, std::uint64_t, Map::IdHasher>;
@@ -14,85 +35,249 @@ struct GameConfig {
 
   bool randomize_spawn;
 
+  // Общее зерно генераторов случайных чисел. Зерно каждой 
+  // сессии выводится из него и идентификатора сессии
+  std::uint64_t seed { 0u };
+
   MapCharacterSpeed map_character_speed;
   MapBagCapacity map_bag_capacity;
   MapMaxPlayers map_max_players;
+
+  LootGeneratorConfig loot_generator;
+
+  // Время, спустя которое пустая игровая сессия удаляется
+  std::chrono::milliseconds session_idle_timeout { 60s };
+  // Время бездействия, после которого персонаж покидает игру
+  std::chrono::milliseconds retirement_time { 60s };
 };
 
 struct GameSessionConfig {
   bool randomize_spawn;
+
+  std::uint64_t seed { 0u };
   
   std::uint16_t max_players { 8u };
   std::uint64_t bag_capacity { 3u };
 
   double characters_speed;
+
+  std::chrono::milliseconds retirement_time { 60s };
 };
 
 class GameSession final {
 public: 
+  using Id = std::uint64_t;
+  using Strand = net::strand<net::io_context::executor_type>;
+
   using IdCharPair = std::pair<Character::Id, std::shared_ptr<Character>>;
-  using IdLootPair = std::pair<Loot::Id, std::shared_ptr<Loot>>;
 
   using Characters = std::unordered_map<Character::Id, std::shared_ptr<Character>>;
-  using LostObjects = std::unordered_map<Loot::Id, std::shared_ptr<Loot>>;
+  using LostObjects = LootPool;
+
+  // Вызывается на strand'е сессии после удаления бездействующего персонажа
+  using RetireHandler = std::function<void(const GameSession& session, const Character& character)>;
 
-  explicit GameSession(GameSessionConfig config, const Map& map)
-    : cfg_(std::move(config))
-    , map_(map) {
+  explicit GameSession(Id id, GameSessionConfig config, const Map& map, Strand strand)
+    : id_(id)
+    , cfg_(std::move(config))
+    , map_(map)
+    , strand_(strand)
+    , rng_(cfg_.seed) {
 
     characters_.reserve(cfg_.max_players);
   }
  
   GameSession(const GameSession&) = delete;
-  GameSession(GameSession&&) = default;
+  GameSession(GameSession&&) = delete;
 
   GameSession& operator=(const GameSession&) = delete;
-  GameSession& operator=(GameSession&&) = default;
+  GameSession& operator=(GameSession&&) = delete;
 
+  // Идентификатор персонажа выделяется сразу, а сам персонаж 
+  // попадает в сессию при выполнении задачи на strand'е сессии. До этого 
+  // его нет в characters(), а его позиция не определена. Задачи, переданные 
+  // на strand сессии после вызова, выполняются после входа персонажа
   IdCharPair add_character(std::shared_ptr<Character> character);
-  IdLootPair add_lost_object(std::shared_ptr<Loot> lost_object);
+
+  // Размещают персонажа в сессии и меняют направление его движения.
+  // Должны вызываться только на strand'е сессии
+  void join(Character::Id id, std::shared_ptr<Character> character);
+  void move_character(Character::Id id, Character::Direction direction);
+
+  // Применяет новые параметры сессии и записывает их в журналы. Зерно генератора 
+  // и способ размещения персонажей не меняются. Должен вызываться только на strand'е сессии
+  void reconfigure(GameSessionConfig config);
+
+  // Размещает предмет в случайной точке карты, присваивая ему идентификатор
+  LootPool::Handle add_lost_object(Loot::Type type, Loot::Value value);
 
   [[nodiscard]] const Characters& characters() const noexcept;
   [[nodiscard]] const LostObjects& lost_objects() const noexcept;
 
+  [[nodiscard]] Id id() const noexcept;
   [[nodiscard]] const GameSessionConfig& config() const noexcept;
   [[nodiscard]] const Map& map() const noexcept;
+  [[nodiscard]] const Strand& strand() const noexcept;
+  [[nodiscard]] std::uint64_t seed() const noexcept;
 
   [[nodiscard]] std::size_t characters_count() const noexcept;
 
-  void recalc_characters_position(std::int64_t delta) const;
-  void spawn_lost_objects(std::int64_t delta);
+  // Количество трофеев и персонажей на момент окончания последнего тика или 
+  // входа персонажа. Могут вызываться из любого потока
+  [[nodiscard]] unsigned loot_count() const noexcept;
+  [[nodiscard]] unsigned looter_count() const noexcept;
+
+  void retire_handler(RetireHandler handler);
+
+  // Журнал, в который записываются входные данные сессии
+  void recorder(replay::Recorder* recorder) noexcept;
+  // Журнал упреждающей записи изменений сохраняемого состояния
+  void journal(wal::Journal* journal) noexcept;
+
+  // Восстановление состояния из снимка и журнала. 
+  // Вызываются до запуска io_context, когда задачи сессии не выполняются
+  void restore_character(Character::Id id, std::shared_ptr<Character> character);
+  void restore_lost_object(const Loot& loot);
+  void restore_counters(Character::Id next_character_id, Loot::Id next_loot_id) noexcept;
+  void restore_config(GameSessionConfig config);
+  void remove_lost_object(Loot::Id id);
+  void remove_character(Character::Id id);
+
+  [[nodiscard]] Character::Id next_character_id() const noexcept;
+  [[nodiscard]] Loot::Id next_loot_id() const noexcept;
+
+  // Должен вызываться только на strand'е сессии.
+  // lost_loot_amount - количество трофеев, появляющихся на карте за тик
+  void tick(std::int64_t delta, unsigned lost_loot_amount);
+
+private:
+  void recalc_characters_position(std::int64_t delta);
+  void spawn_lost_objects(unsigned lost_loot_amount);
+  void publish_counts() noexcept;
   void process_collisions();
+  void apply_config(GameSessionConfig config);
+
+  // Удаляет персонажей, бездействующих дольше retirement_time. За один тик 
+  // удаляется не более MAX_RETIREMENTS_PER_TICK персонажей, остальные ждут следующего тика
+  void retire_idle_characters(std::chrono::milliseconds delta);
 
 private:
-  Character::Id character_id_ { 1u };
+  constexpr static std::chrono::milliseconds RETIREMENT_WHEEL_RESOLUTION { 250 };
+  constexpr static std::size_t RETIREMENT_WHEEL_SLOTS { 256u };
+  constexpr static std::size_t MAX_RETIREMENTS_PER_TICK { 32u };
+
+  Id id_;
+
+  std::atomic<Character::Id> character_id_ { 1u };
+
   Loot::Id loot_id_ { 1u };
+
+  std::atomic<unsigned> loot_count_ { 0u };
+  std::atomic<unsigned> looter_count_ { 0u };
   
   Characters characters_;
   LostObjects lost_objects_;
 
   const Map& map_;
   GameSessionConfig cfg_;
+  Strand strand_;
 
   core::GameEngine engine { map_ };
+  util::Xoshiro256 rng_;
+  collisions::LootCharacterProvider provider_;
+
+  util::TimingWheel<Character::Id> retirement_wheel_ { RETIREMENT_WHEEL_RESOLUTION, RETIREMENT_WHEEL_SLOTS };
+  std::vector<Character::Id> became_idle_;
+  std::deque<Character::Id> retire_queue_;
+
+  RetireHandler retire_handler_;
+  replay::Recorder* recorder_ { nullptr };
+  wal::Journal* journal_ { nullptr };
 };
 
 class Game;
 
+// Распределяет игроков по игровым сессиям карты. Для каждой карты сессии
+// упорядочены по заполненности, поэтому выбор наименее заполненной сессии, 
+// а также учёт вошедших и покинувших сессию игроков выполняются за O(log n)
 class GameSessionManager {
 public:
-  using Sessions = std::unordered_multimap<Map::Id, std::unique_ptr<GameSession>, Map::IdHasher>;
+  using SessionPtr = std::shared_ptr<GameSession>;
+
+  struct PlacementStats {
+    struct MapStats {
+      std::size_t sessions;
+      std::size_t players;
+    };
+
+    using Maps = std::unordered_map<Map::Id, MapStats, Map::IdHasher>;
+
+    std::uint64_t placements { 0u };
+    std::uint64_t sessions_created { 0u };
+    std::uint64_t sessions_reclaimed { 0u };
+
+    std::size_t sessions { 0u };
+    std::size_t players { 0u };
 
-  [[nodiscard]] const GameSession* get_session(const Game& game, const Map* map) const; 
+    Maps maps;
+  };
+
+  // Возвращает наименее заполненную сессию карты и учитывает в ней нового игрока.
+  // Если все сессии карты заполнены, создаётся новая
   [[nodiscard]] GameSession* get_session(const Game& game, const Map* map);
 
-  [[nodiscard]] const Sessions& all_sessions() const noexcept;
+  // Учитывает выход игрока из сессии
+  void release(const GameSession& session);
+
+  // Вычисляет количество появляющихся трофеев сразу для всех сессий, 
+  // передаёт задачу обновления состояния на strand каждой сессии 
+  // и удаляет сессии, остающиеся пустыми дольше cfg.session_idle_timeout
+  void post_tick(std::int64_t delta, const GameConfig& cfg);
+
+  // Пересчитывает параметры сессий по текущей конфигурации игры и передаёт 
+  // их на strand каждой сессии раньше задачи следующего тика
+  void reconfigure(const Game& game);
+
+  [[nodiscard]] PlacementStats stats() const;
+
+  [[nodiscard]] std::vector<SessionPtr> sessions() const;
+
+  // Создаёт сессию с заданными идентификатором и зерном при восстановлении состояния
+  GameSession& restore_session(const Game& game, const Map& map, GameSession::Id id, std::uint64_t seed);
+  // Пересчитывает заполненность сессий после восстановления состояния
+  void recount_players();
 
 private:
-  [[nodiscard]] GameSession* create_session(GameSessionConfig cfg, const Map& map);
+  using Occupancy = std::pair<std::size_t, GameSession::Id>;
+
+  struct Slot {
+    SessionPtr session;
+    LootGenerator::Slot loot_slot;
+    std::size_t players { 0u };
+    std::chrono::milliseconds empty_for { 0 };
+  };
+
+  struct MapSessions {
+    std::set<Occupancy> by_occupancy;
+    std::size_t max_players;
+  };
+
+  [[nodiscard]] Slot& create_session(const Game& game, const Map& map, MapSessions& map_sessions);
+  [[nodiscard]] Slot& emplace_session(const Game& game, const Map& map, GameSession::Id id, std::uint64_t seed);
+  [[nodiscard]] MapSessions& map_sessions(const Game& game, const Map& map);
+  void update_occupancy(Slot& slot, std::size_t players);
 
 private:
-  Sessions sessions_;
+  mutable std::mutex mutex_;
+
+  GameSession::Id next_session_id_ { 1u };
+
+  std::unordered_map<GameSession::Id, Slot> sessions_;
+  std::unordered_map<Map::Id, MapSessions, Map::IdHasher> map_sessions_;
+
+  PlacementStats stats_;
+
+  LootGenerator loot_generator_;
 };
 
 class Game { 
@@ -102,8 +287,8 @@ public:
 public:
   Game() = default;
 
-  explicit Game(const GameConfig& config)
-    : cfg_(std::move(config)) {
+  explicit Game(GameConfig config) {
+    this->config(std::move(config));
   }
 
   Game(const Game&) = delete;
@@ -114,22 +299,59 @@ public:
 
   void add_map(const Map& map);
   void config(GameConfig config);
+  // Сохраняет новую конфигурацию, которая вступает в силу на границе следующего тика.
+  // Зерно генератора и способ размещения персонажей остаются прежними. 
+  // Может вызываться из любого потока
+  std::shared_ptr<const GameConfig> reload(GameConfig config);
+  void io_context(net::io_context& io);
+  // Сессии распределяются между контекстами по кругу в порядке идентификаторов
+  void io_contexts(std::vector<net::io_context*> contexts);
+  void retire_handler(GameSession::RetireHandler handler);
+  void recorder(std::shared_ptr<replay::Recorder> recorder) noexcept;
+  void journal(std::shared_ptr<wal::Journal> journal);
   void refresh_state(std::int64_t delta);
 
   const Map* find_map(const Map::Id& id) const noexcept;
   [[nodiscard]] const Maps& get_maps() const noexcept;
-  [[nodiscard]] const GameConfig& config() const noexcept;
+  // Снимок действующей конфигурации. Может вызываться из любого потока
+  [[nodiscard]] std::shared_ptr<const GameConfig> config() const noexcept;
+  [[nodiscard]] bool reload_pending() const noexcept;
+  [[nodiscard]] net::io_context& io_context(GameSession::Id session) const;
+  [[nodiscard]] const GameSession::RetireHandler& retire_handler() const noexcept;
+  [[nodiscard]] replay::Recorder* recorder() const noexcept;
+  [[nodiscard]] wal::Journal* journal() const noexcept;
+
+  // Параметры новой сессии на карте map (кроме зерна генератора)
+  [[nodiscard]] GameSessionConfig session_config(const Map& map) const;
 
-  [[nodiscard]] const GameSession* get_session(const Map* map) const; 
   [[nodiscard]] GameSession* get_session(const Map* map);
+  void leave_session(const GameSession& session);
+
+  [[nodiscard]] GameSessionManager::PlacementStats placement_stats() const;
+
+  [[nodiscard]] std::vector<GameSessionManager::SessionPtr> sessions() const;
+  GameSession& restore_session(const Map& map, GameSession::Id id, std::uint64_t seed);
+  void recount_players();
 
 private:
   using MapIdToIndex = std::unordered_map<Map::Id, std::size_t, Map::IdHasher>;
 
-  GameConfig cfg_;
+  // Конфигурация не изменяется, а заменяется целиком: читатели работают 
+  // со снимком, а новая конфигурация ожидает в pending границы тика
+  struct ConfigSlot {
+    std::atomic<std::shared_ptr<const GameConfig>> current { std::make_shared<const GameConfig>() };
+    std::atomic<std::shared_ptr<const GameConfig>> pending;
+  };
+
+  std::unique_ptr<ConfigSlot> cfg_ { std::make_unique<ConfigSlot>() };
   Maps maps_;
 
-  std::unique_ptr<GameSessionManager> session_manager;
+  std::vector<net::io_context*> io_contexts_;
+  GameSession::RetireHandler retire_handler_;
+  std::shared_ptr<replay::Recorder> recorder_;
+  std::shared_ptr<wal::Journal> journal_;
+
+  std::unique_ptr<GameSessionManager> session_manager { std::make_unique<GameSessionManager>() };
 
   MapIdToIndex map_id_to_index_;
 };
@@ -0,0 +1,198 @@
+#include "handoff.hpp"
+
+#include <cstring>
+#include <stdexcept>
+#include <string>
+
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+namespace handoff {
+
+using namespace std::literals;
+
+namespace {
+
+constexpr std::size_t MAX_SOCKETS = 64u;
+
+} // namespace
+
+void send_sockets(int channel, std::span<const int> fds) {
+  if (fds.empty() || fds.size() > MAX_SOCKETS) {
+    throw std::invalid_argument("Invalid number of sockets to hand off"s);
+  }
+
+  // Количество дескрипторов передаётся и в данных: без данных sendmsg не отправит сообщение
+  auto count = static_cast<std::uint8_t>(fds.size());
+
+  iovec iov { .iov_base = &count, .iov_len = sizeof(count) };
+
+  std::vector<char> control(CMSG_SPACE(sizeof(int) * fds.size()));
+
+  msghdr msg {};
+  msg.msg_iov = &iov;
+  msg.msg_iovlen = 1;
+  msg.msg_control = control.data();
+  msg.msg_controllen = control.size();
+
+  cmsghdr* cmsg = CMSG_FIRSTHDR(&msg);
+  cmsg->cmsg_level = SOL_SOCKET;
+  cmsg->cmsg_type = SCM_RIGHTS;
+  cmsg->cmsg_len = CMSG_LEN(sizeof(int) * fds.size());
+
+  std::memcpy(CMSG_DATA(cmsg), fds.data(), sizeof(int) * fds.size());
+
+  while (::sendmsg(channel, &msg, MSG_NOSIGNAL) < 0) {
+    if (errno != EINTR) {
+      throw std::runtime_error("Failed to hand off sockets: "s + std::strerror(errno));
+    }
+  }
+}
+
+std::vector<int> receive_sockets(int channel) {
+  std::uint8_t count = 0;
+
+  iovec iov { .iov_base = &count, .iov_len = sizeof(count) };
+
+  std::vector<char> control(CMSG_SPACE(sizeof(int) * MAX_SOCKETS));
+
+  msghdr msg {};
+  msg.msg_iov = &iov;
+  msg.msg_iovlen = 1;
+  msg.msg_control = control.data();
+  msg.msg_controllen = control.size();
+
+  ssize_t received;
+
+  while ((received = ::recvmsg(channel, &msg, MSG_CMSG_CLOEXEC)) < 0) {
+    if (errno != EINTR) {
+      throw std::runtime_error("Failed to receive sockets: "s + std::strerror(errno));
+    }
+  }
+
+  std::vector<int> fds;
+
+  for (cmsghdr* cmsg = CMSG_FIRSTHDR(&msg); cmsg; cmsg = CMSG_NXTHDR(&msg, cmsg)) {
+    if (cmsg->cmsg_level != SOL_SOCKET || cmsg->cmsg_type != SCM_RIGHTS) {
+      continue;
+    }
+
+    const auto n = (cmsg->cmsg_len - CMSG_LEN(0)) / sizeof(int);
+    const auto first = fds.size();
+
+    fds.resize(first + n);
+    std::memcpy(fds.data() + first, CMSG_DATA(cmsg), sizeof(int) * n);
+  }
+
+  if (received != sizeof(count) || (msg.msg_flags & MSG_CTRUNC) || fds.size() != count) {
+    for (const auto fd : fds) {
+      ::close(fd);
+    }
+
+    throw std::runtime_error("Malformed socket handoff message"s);
+  }
+
+  return fds;
+}
+
+std::vector<int> take_over(const fs::path& path) {
+  sockaddr_un addr {};
+  addr.sun_family = AF_UNIX;
+
+  if (path.native().size() >= sizeof(addr.sun_path)) {
+    throw std::invalid_argument("Handoff socket path is too long"s);
+  }
+
+  std::strcpy(addr.sun_path, path.c_str());
+
+  const int channel = ::socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+
+  if (channel < 0) {
+    throw std::runtime_error("Unable to create handoff socket"s);
+  }
+
+  if (::connect(channel, reinterpret_cast<const sockaddr*>(&addr), sizeof(addr)) != 0) {
+    ::close(channel);
+    throw std::runtime_error("Unable to connect to "s + path.string() + ": "s + std::strerror(errno));
+  }
+
+  std::vector<int> fds;
+
+  try {
+    fds = receive_sockets(channel);
+  } catch (...) {
+    ::close(channel);
+    throw;
+  }
+
+  // Соединение закрывается при завершении предыдущего процесса, после сохранения его состояния
+  char byte;
+
+  while (true) {
+    const auto n = ::read(channel, &byte, sizeof(byte));
+
+    if (n == 0 || (n < 0 && errno != EINTR)) {
+      break;
+    }
+  }
+
+  ::close(channel);
+
+  return fds;
+}
+
+Server::Server(net::io_context& io, const fs::path& path, Provider sockets, Handler on_handoff)
+  : acceptor_(io)
+  , peer_(io)
+  , sockets_(std::move(sockets))
+  , on_handoff_(std::move(on_handoff)) {
+
+  std::error_code ec;
+  fs::remove(path, ec);
+
+  const protocol::endpoint endpoint(path.string());
+
+  acceptor_.open(endpoint.protocol());
+  acceptor_.bind(endpoint);
+  acceptor_.listen();
+}
+
+void Server::run() {
+  do_accept();
+}
+
+void Server::error_handler(ErrorHandler handler) {
+  error_handler_ = std::move(handler);
+}
+
+void Server::do_accept() {
+  acceptor_.async_accept([self = shared_from_this()](boost::system::error_code ec, protocol::socket peer) {
+    if (ec) {
+      return;
+    }
+
+    try {
+      send_sockets(peer.native_handle(), self->sockets_());
+    } catch (const std::exception& e) {
+      if (self->error_handler_) {
+        self->error_handler_(e);
+      }
+
+      // Сокеты остаются у этого процесса, можно повторить попытку
+      return self->do_accept();
+    }
+
+    // Соединение остаётся открытым до завершения процесса: по его закрытию
+    // новый процесс узнаёт, что состояние сохранено
+    self->peer_ = std::move(peer);
+
+    // Сокеты переданы: следующему процессу нужен свой сервер передачи
+    boost::system::error_code ignored;
+    self->acceptor_.close(ignored);
+
+    self->on_handoff_();
+  });
+}
+
+} // namespace handoff
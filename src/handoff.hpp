@@ -0,0 +1,64 @@
+#pragma once
+
+#include <filesystem>
+#include <functional>
+#include <memory>
+#include <span>
+#include <vector>
+
+#include <boost/asio/io_context.hpp>
+#include <boost/asio/local/stream_protocol.hpp>
+
+namespace handoff {
+
+namespace net = boost::asio;
+namespace fs = std::filesystem;
+
+/*
+ * Передача слушающих сокетов новому процессу сервера при перезапуске.
+ *
+ * Работающий сервер принимает подключения на Unix-сокете. Новый процесс
+ * подключается к нему и получает дескрипторы слушающих сокетов в сообщении
+ * SCM_RIGHTS, после чего старый процесс перестаёт принимать соединения.
+ * Очередь ожидающих соединений принадлежит самому сокету, поэтому
+ * соединения при перезапуске не теряются.
+ */
+
+// Отправляет дескрипторы fds через Unix-сокет channel
+void send_sockets(int channel, std::span<const int> fds);
+
+// Принимает дескрипторы, отправленные send_sockets
+[[nodiscard]] std::vector<int> receive_sockets(int channel);
+
+// Подключается к работающему серверу по пути path и забирает его слушающие сокеты.
+// Возвращает управление после завершения работающего сервера
+[[nodiscard]] std::vector<int> take_over(const fs::path& path);
+
+class Server : public std::enable_shared_from_this<Server> {
+public:
+  using Provider = std::function<std::vector<int>()>;
+  using Handler = std::function<void()>;
+  using ErrorHandler = std::function<void(const std::exception& e)>;
+
+  // sockets возвращает дескрипторы для передачи, on_handoff вызывается после
+  // успешной передачи. Существующий файл по пути path удаляется
+  Server(net::io_context& io, const fs::path& path, Provider sockets, Handler on_handoff);
+
+  void run();
+  void error_handler(ErrorHandler handler);
+
+private:
+  using protocol = net::local::stream_protocol;
+
+  void do_accept();
+
+private:
+  protocol::acceptor acceptor_;
+  protocol::socket peer_;
+
+  Provider sockets_;
+  Handler on_handoff_;
+  ErrorHandler error_handler_;
+};
+
+} // namespace handoff
@@ -2,8 +2,11 @@
 
 #include "common_http.hpp"
 
+#include <array>
 #include <cstdint>
-#include <unordered_map>
+#include <string>
+#include <string_view>
+#include <utility>
 
 namespace http_methods {
 
@@ -34,17 +37,112 @@ namespace http_methods {
 using namespace common;
 using namespace std::literals;
 
+// Порядок таблицы задаёт порядок методов в заголовке Allow
+inline constexpr std::array<std::pair<std::string_view, Method>, 4> verbs {{
+  { "GET"sv,  Method::get },
+  { "HEAD"sv, Method::head },
+  { "POST"sv, Method::post },
+  { "PUT"sv,  Method::put },
+}};
+
+[[nodiscard]] constexpr Method from_string(std::string_view method) noexcept {
+  for (const auto& [str, value] : verbs) {
+    if (str == method) {
+      return value;
+    }
+  }
+
+  return Method::unknown;
+}
+
+[[nodiscard]] constexpr Method from_verb(http::verb method) noexcept {
+  switch (method) {
+    case http::verb::get  : return Method::get;
+    case http::verb::head : return Method::head;
+    case http::verb::post : return Method::post;
+    case http::verb::put  : return Method::put;
+    default               : return Method::unknown;
+  }
+}
+
+namespace detail {
+
+constexpr std::size_t MAX_ALLOW_LENGTH = 24u;
+constexpr std::size_t METHOD_COMBINATIONS = 16u;
+
+struct AllowList {
+  std::array<char, MAX_ALLOW_LENGTH> chars {};
+  std::size_t size { 0u };
+};
+
+// Значения заголовка Allow для всех сочетаний методов
+constexpr std::array<AllowList, METHOD_COMBINATIONS> make_allow_lists() {
+  std::array<AllowList, METHOD_COMBINATIONS> lists {};
+
+  for (std::size_t mask = 0; mask < lists.size(); ++mask) {
+    auto& list = lists[mask];
+
+    for (const auto& [str, value] : verbs) {
+      if ((static_cast<std::size_t>(value) & mask) == 0u) {
+        continue;
+      }
+
+      if (list.size) {
+        list.chars[list.size++] = ',';
+        list.chars[list.size++] = ' ';
+      }
+
+      for (const char c : str) {
+        list.chars[list.size++] = c;
+      }
+    }
+  }
+
+  return lists;
+}
+
+inline constexpr auto allow_lists = make_allow_lists();
+
+} // namespace detail
+
 class AllowedMethod {
 public:
-  [[nodiscard]] bool is_allowed(std::string_view method) const;
-  [[nodiscard]] std::string as_string() const;
+  constexpr AllowedMethod() = default;
 
-  void set(const Method methods) noexcept;
+  constexpr explicit AllowedMethod(const Method methods) noexcept
+    : allowed_methods_(methods) {
+  }
 
-private:
-  Method allowed_methods_;
+  [[nodiscard]] constexpr bool is_allowed(const Method method) const noexcept {
+    return method != Method::unknown && (allowed_methods_ & method) != Method::unknown;
+  }
+
+  [[nodiscard]] constexpr bool is_allowed(std::string_view method) const noexcept {
+    return is_allowed(from_string(method));
+  }
 
-  static std::unordered_map<std::string, Method> verbs_;
+  [[nodiscard]] constexpr bool is_allowed(http::verb method) const noexcept {
+    return is_allowed(from_verb(method));
+  }
+
+  // Строка для заголовка Allow. Ссылается на статическую таблицу
+  [[nodiscard]] constexpr std::string_view as_string_view() const noexcept {
+    using ut = std::underlying_type_t<Method>;
+
+    const auto& list = detail::allow_lists[static_cast<ut>(allowed_methods_) % detail::METHOD_COMBINATIONS];
+    return { list.chars.data(), list.size };
+  }
+
+  [[nodiscard]] constexpr std::string as_string() const {
+    return std::string(as_string_view());
+  }
+
+  constexpr void set(const Method methods) noexcept {
+    allowed_methods_ = methods;
+  }
+
+private:
+  Method allowed_methods_ { Method::unknown };
 };
 
-} // namespace http_methods
\ No newline at end of file
+} // namespace http_methods
@@ -0,0 +1,112 @@
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+#include <istream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace journal {
+
+/*
+ * Общие части журнала входных данных (replay) и журнала упреждающей записи (wal):
+ * события, которые в обоих журналах имеют одинаковые поля, и их двоичное
+ * кодирование. Числа записываются в представлении платформы, строки - с
+ * префиксом длины u16.
+ */
+
+struct SessionCreated {
+  std::uint64_t session;
+  std::uint64_t seed;
+  std::string map_id;
+};
+
+struct Move {
+  std::uint64_t session;
+  std::uint64_t character;
+  std::uint8_t direction;
+};
+
+// Параметры сессии, применённые после перезагрузки конфигурации игры.
+// retirement_time - в миллисекундах
+struct Reconfigure {
+  std::uint64_t session;
+  std::uint16_t max_players;
+  std::uint64_t bag_capacity;
+  double speed;
+  std::int64_t retirement_time;
+};
+
+template <typename T>
+void put(std::vector<char>& buffer, const T& value) {
+  const auto pos = buffer.size();
+  buffer.resize(pos + sizeof(value));
+
+  std::memcpy(buffer.data() + pos, &value, sizeof(value));
+}
+
+// Строки длиннее 65535 байт обрезаются
+inline void put_string(std::vector<char>& buffer, std::string_view str) {
+  const auto size = static_cast<std::uint16_t>(str.size());
+
+  put(buffer, size);
+  buffer.insert(buffer.end(), str.begin(), str.begin() + size);
+}
+
+// Читает поля из буфера в памяти. Методы возвращают false, если данных не хватает
+class BufferReader {
+public:
+  BufferReader(const char* begin, const char* end)
+    : pos_(begin)
+    , end_(end) {
+  }
+
+  template <typename T>
+  bool get(T& value) {
+    if (static_cast<std::size_t>(end_ - pos_) < sizeof(value)) {
+      return false;
+    }
+
+    std::memcpy(&value, pos_, sizeof(value));
+    pos_ += sizeof(value);
+
+    return true;
+  }
+
+  bool get_string(std::string& str) {
+    std::uint16_t size;
+
+    if (!get(size) || static_cast<std::size_t>(end_ - pos_) < size) {
+      return false;
+    }
+
+    str.assign(pos_, size);
+    pos_ += size;
+
+    return true;
+  }
+
+private:
+  const char* pos_;
+  const char* end_;
+};
+
+// Читает поля из потока. Функции возвращают false, если поток закончился
+template <typename T>
+bool get(std::istream& in, T& value) {
+  return static_cast<bool>(in.read(reinterpret_cast<char*>(&value), sizeof(value)));
+}
+
+inline bool get_string(std::istream& in, std::string& str) {
+  std::uint16_t size;
+
+  if (!get(in, size)) {
+    return false;
+  }
+
+  str.resize(size);
+  return static_cast<bool>(in.read(str.data(), size));
+}
+
+} // namespace journal
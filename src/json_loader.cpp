@@ -1,7 +1,10 @@
 #include "json_loader.hpp"
 #include "extra_data.hpp"
 
+#include <algorithm>
 #include <fstream>
+#include <limits>
+#include <random>
 #include <boost/json/src.hpp>
 
 namespace json_loader {
@@ -87,21 +90,19 @@ public:
   }
 };
 
-void set_loot_gen_config(const json::object& obj) {
+model::LootGeneratorConfig get_loot_gen_config(const json::object& obj) {
   decltype(auto) loot_gen_config_obj = obj.at("lootGeneratorConfig"sv).as_object();
 
   const auto period = std::chrono::duration<double>(loot_gen_config_obj.at("period"sv).as_double());
   const auto probability = loot_gen_config_obj.at("probability"sv).as_double();
 
-  model::LootGeneratorConfig loot_gen_config {
+  return {
     .period = std::chrono::duration_cast<model::LootGenerator::TimeInterval>(period), 
     .probability = probability
   };
-
-  model::LootGenerator::instance().config(std::move(loot_gen_config));
 }
 
-void set_loot_types(const json::value& val, model::Map::Id id) {
+void set_loot_types(const json::value& val, model::Map& map) {
   decltype(auto) loot_types = val.at("lootTypes"sv).as_array();
   
   // В валидном конфигурационном файле должно содержаться не менее одного типа трофеев
@@ -109,12 +110,27 @@ void set_loot_types(const json::value& val, model::Map::Id id) {
     throw std::invalid_argument("'lootTypes' must have minimum 1 trophy"s);
   }
 
-  extra_data::LootTypes::instance().set(id, std::move(loot_types));
+  // Игровая модель работает с типизированной таблицей, 
+  // исходный JSON нужен только для ответа с описанием карты
+  for (const auto& loot_type : loot_types) {
+    map.add_loot_type(loot_type.at("name"sv).as_string().c_str(), loot_type.at("value"sv).as_int64());
+  }
+
+  extra_data::LootTypes::instance().set(map.get_id(), std::move(loot_types));
 }
 
-} // namespace
+// Число игроков сессии. При нуле каждый вход в игру создавал бы новую сессию
+std::uint16_t get_max_players(const json::value& val) {
+  const auto max_players = val.as_int64();
+
+  if (max_players < 1 || max_players > std::numeric_limits<std::uint16_t>::max()) {
+    throw std::invalid_argument("Invalid config: max players must be in range 1..65535"s);
+  }
 
-model::Game load_game(const std::filesystem::path& config_path, bool randomize_spawn) {
+  return static_cast<std::uint16_t>(max_players);
+}
+
+json::object read_config(const std::filesystem::path& config_path) {
   std::ifstream jsonfile(config_path);
 
   if (!jsonfile) { 
@@ -124,11 +140,12 @@ model::Game load_game(const std::filesystem::path& config_path, bool randomize_s
   std::string input {std::istreambuf_iterator<char>(jsonfile), {}};
   jsonfile.close();
 
-  const auto obj = json::parse(input).as_object();
-  decltype(auto) maps = obj.at("maps"sv).as_array();
+  return json::parse(input).as_object();
+}
 
+// Параметры игры без зерна генератора и способа размещения персонажей
+model::GameConfig get_game_config(const json::object& obj) {
   model::GameConfig cfg;
-  cfg.randomize_spawn = randomize_spawn;
 
   double default_speed = 1.0;
  
@@ -145,16 +162,23 @@ model::Game load_game(const std::filesystem::path& config_path, bool randomize_s
   std::uint16_t default_max_players = 8u;
 
   if (const auto it = obj.find("defaultMaxPlayers"sv); it != obj.cend()) {
-    default_max_players = it->value().as_int64();
+    default_max_players = get_max_players(it->value());
   }
 
-  set_loot_gen_config(obj);
+  if (const auto it = obj.find("sessionIdleTimeout"sv); it != obj.cend()) {
+    const auto timeout = std::chrono::duration<double>(it->value().as_double());
+    cfg.session_idle_timeout = std::chrono::duration_cast<std::chrono::milliseconds>(timeout);
+  }
 
-  model::Game game;
+  if (const auto it = obj.find("dogRetirementTime"sv); it != obj.cend()) {
+    const auto retirement_time = std::chrono::duration<double>(it->value().as_double());
+    cfg.retirement_time = std::chrono::duration_cast<std::chrono::milliseconds>(retirement_time);
+  }
 
-  for (const auto& m : maps) {
+  cfg.loot_generator = get_loot_gen_config(obj);
+
+  for (const auto& m : obj.at("maps"sv).as_array()) {
     const model::Map::Id id { m.at("id"sv).as_string().c_str() };
-    model::Map map { id, m.at("name"sv).as_string().c_str() };
 
     try {
       cfg.map_character_speed[id] = m.at("dogSpeed"sv).as_double();
@@ -168,9 +192,41 @@ model::Game load_game(const std::filesystem::path& config_path, bool randomize_s
       cfg.map_bag_capacity[id] = default_bag_capacity;
     }
 
-    set_loot_types(m, id);
+    try {
+      cfg.map_max_players[id] = get_max_players(m.at("maxPlayers"sv));
+    } catch (const std::out_of_range& e) {
+      cfg.map_max_players[id] = default_max_players;
+    }
+  }
+
+  return cfg;
+}
+
+} // namespace
+
+model::Game load_game(const std::filesystem::path& config_path, bool randomize_spawn, std::optional<std::uint64_t> seed) {
+  const auto obj = read_config(config_path);
+  decltype(auto) maps = obj.at("maps"sv).as_array();
+
+  auto cfg = get_game_config(obj);
+  cfg.randomize_spawn = randomize_spawn;
+
+  if (seed.has_value()) {
+    cfg.seed = *seed;
+  } else if (const auto it = obj.find("randomSeed"sv); it != obj.cend()) {
+    cfg.seed = it->value().to_number<std::uint64_t>();
+  } else {
+    std::random_device rd;
+    cfg.seed = (static_cast<std::uint64_t>(rd()) << 32) | rd();
+  }
+
+  model::Game game;
 
-    cfg.map_max_players[id] = default_max_players;
+  for (const auto& m : maps) {
+    const model::Map::Id id { m.at("id"sv).as_string().c_str() };
+    model::Map map { id, m.at("name"sv).as_string().c_str() };
+
+    set_loot_types(m, map);
 
     RoadLoader rl(map);
     BuildingLoader bl(map);
@@ -196,4 +252,22 @@ model::Game load_game(const std::filesystem::path& config_path, bool randomize_s
   return game;
 }
 
+model::GameConfig load_game_config(const std::filesystem::path& config_path, const model::Game& game) {
+  auto cfg = get_game_config(read_config(config_path));
+
+  // Карты загружаются один раз: сессии и персонажи ссылаются на их дороги и объекты
+  const auto& maps = game.get_maps();
+
+  const auto same_maps = cfg.map_character_speed.size() == maps.size() 
+    && std::all_of(maps.cbegin(), maps.cend(), [&cfg](const model::Map& map) {
+      return cfg.map_character_speed.contains(map.get_id());
+    });
+
+  if (!same_maps) {
+    throw std::invalid_argument("Maps cannot be changed without restart"s);
+  }
+
+  return cfg;
+}
+
 }  // namespace json_loader
@@ -2,10 +2,19 @@
 
 #include "game.hpp"
 
+#include <cstdint>
 #include <filesystem>
+#include <optional>
 
 namespace json_loader {
 
-[[nodiscard]] model::Game load_game(const std::filesystem::path& config_path, bool randomize_spawn);
+// Зерно генераторов случайных чисел берётся из seed, если оно задано, затем из
+// поля randomSeed конфигурационного файла, иначе выбирается случайно
+[[nodiscard]] model::Game load_game(const std::filesystem::path& config_path, bool randomize_spawn, 
+                                    std::optional<std::uint64_t> seed = std::nullopt);
+
+// Перечитывает параметры игры для перезагрузки конфигурации. Набор карт должен совпадать 
+// с картами game, иначе выбрасывается std::invalid_argument. Зерно генератора не читается
+[[nodiscard]] model::GameConfig load_game_config(const std::filesystem::path& config_path, const model::Game& game);
 
 }  // namespace json_loader
@@ -0,0 +1,354 @@
+#include "leaderboard.hpp"
+#include "logger.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <iterator>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace leaderboard {
+
+using namespace std::literals;
+
+namespace {
+
+// Формат сегмента:
+//   SegmentHeader
+//   count x { u64 score, u64 play_time (ms), u32 name_size, name_size байт имени }
+struct SegmentHeader {
+  std::uint32_t magic;
+  std::uint32_t count;
+  std::uint64_t payload_size;
+};
+
+constexpr std::uint32_t SEGMENT_MAGIC { 0x4742'4C53 }; // "SLBG"
+
+template <typename T>
+void write_pod(std::ostream& out, const T& value) {
+  out.write(reinterpret_cast<const char*>(&value), sizeof(value));
+}
+
+template <typename T>
+bool read_pod(const char*& pos, const char* end, T& value) {
+  if (static_cast<std::size_t>(end - pos) < sizeof(value)) {
+    return false;
+  }
+
+  std::memcpy(&value, pos, sizeof(value));
+  pos += sizeof(value);
+
+  return true;
+}
+
+// std::ofstream не даёт доступа к дескриптору, поэтому файл открывается ещё раз:
+// fdatasync сбрасывает данные файла независимо от того, через какой дескриптор они записаны
+bool sync(const fs::path& path) {
+  const int fd = ::open(path.c_str(), O_WRONLY | O_CLOEXEC);
+
+  if (fd < 0) {
+    return false;
+  }
+
+  const bool synced = ::fdatasync(fd) == 0;
+  ::close(fd);
+
+  return synced;
+}
+
+std::uint64_t record_size(const Record& record) {
+  return sizeof(std::uint64_t) * 2 + sizeof(std::uint32_t) + record.name.size();
+}
+
+// Отображение файла в память только для чтения
+class MappedFile {
+public:
+  explicit MappedFile(const fs::path& path) {
+    fd_ = ::open(path.c_str(), O_RDONLY);
+    if (fd_ < 0) {
+      return;
+    }
+
+    struct stat st;
+    if (::fstat(fd_, &st) != 0 || st.st_size == 0) {
+      return;
+    }
+
+    void* data = ::mmap(nullptr, st.st_size, PROT_READ, MAP_PRIVATE, fd_, 0);
+    if (data == MAP_FAILED) {
+      throw std::runtime_error("Failed to map leaderboard file"s);
+    }
+
+    data_ = static_cast<const char*>(data);
+    size_ = st.st_size;
+  }
+
+  MappedFile(const MappedFile&) = delete;
+  MappedFile& operator=(const MappedFile&) = delete;
+
+  ~MappedFile() {
+    if (data_) {
+      ::munmap(const_cast<char*>(data_), size_);
+    }
+
+    if (fd_ >= 0) {
+      ::close(fd_);
+    }
+  }
+
+  const char* begin() const noexcept {
+    return data_;
+  }
+
+  const char* end() const noexcept {
+    return data_ + size_;
+  }
+
+private:
+  int fd_ { -1 };
+
+  const char* data_ { nullptr };
+  std::size_t size_ { 0u };
+};
+
+} // namespace
+
+bool ranks_before(const Record& l, const Record& r) noexcept {
+  if (l.score != r.score) {
+    return l.score > r.score;
+  }
+
+  if (l.play_time != r.play_time) {
+    return l.play_time < r.play_time;
+  }
+
+  return l.name < r.name;
+}
+
+Leaderboard::Leaderboard(std::optional<fs::path> file, std::size_t top_k)
+  : file_path_(std::move(file))
+  , top_k_(top_k) {
+
+  if (!file_path_) {
+    return;
+  }
+
+  const auto valid_size = load();
+
+  // Прерванный или повреждённый сегмент отрезается вместе со всем, что за ним
+  // следует, иначе сегменты, дописанные после него, не будут прочитаны при следующем запуске
+  if (fs::exists(*file_path_)) {
+    if (const auto size = fs::file_size(*file_path_); size > valid_size) {
+      LOG_WARN << JSON_DATA({
+        {"file"sv, file_path_->string()},
+        {"size"sv, size},
+        {"valid_size"sv, valid_size}
+      })
+      << "leaderboard file truncated"sv;
+
+      fs::resize_file(*file_path_, valid_size);
+    }
+  }
+
+  file_.open(*file_path_, std::ios::binary | std::ios::app);
+  if (!file_) {
+    throw std::runtime_error("Unable to open the leaderboard file"s);
+  }
+}
+
+Leaderboard::~Leaderboard() {
+  try {
+    flush();
+  } catch (...) {
+    //
+  }
+
+  Record* record = nullptr;
+
+  while (queue_.pop(record)) {
+    delete record;
+  }
+}
+
+void Leaderboard::push(Record record) {
+  queue_.push(new Record(std::move(record)));
+}
+
+void Leaderboard::flush() {
+  std::vector<Record> batch = std::move(unsaved_);
+  unsaved_.clear();
+
+  Record* record = nullptr;
+
+  while (queue_.pop(record)) {
+    std::unique_ptr<Record> holder(record);
+    batch.push_back(std::move(*holder));
+  }
+
+  if (batch.empty()) {
+    return;
+  }
+
+  std::sort(batch.begin(), batch.end(), ranks_before);
+
+  try {
+    append_segment(batch);
+  } catch (...) {
+    unsaved_ = std::move(batch);
+    throw;
+  }
+
+  merge_into_index(std::move(batch));
+}
+
+std::vector<Record> Leaderboard::page(std::size_t start, std::size_t max_items) const {
+  std::shared_lock lock(index_mutex_);
+
+  if (start >= index_.size()) {
+    return {};
+  }
+
+  const auto first = index_.cbegin() + start;
+  const auto last = first + std::min(max_items, index_.size() - start);
+
+  return { first, last };
+}
+
+std::size_t Leaderboard::size() const {
+  std::shared_lock lock(index_mutex_);
+  return index_.size();
+}
+
+std::uint64_t Leaderboard::load() {
+  if (!fs::exists(*file_path_)) {
+    return 0u;
+  }
+
+  MappedFile mapped(*file_path_);
+  const char* pos = mapped.begin();
+  const char* valid_end = pos;
+
+  std::vector<Record> records;
+
+  while (pos && pos < mapped.end()) {
+    SegmentHeader header;
+
+    // Сегмент, запись которого была прервана, игнорируется
+    if (!read_pod(pos, mapped.end(), header) || header.magic != SEGMENT_MAGIC ||
+        header.payload_size > static_cast<std::uint64_t>(mapped.end() - pos)) {
+      break;
+    }
+
+    const char* segment_end = pos + header.payload_size;
+    const auto segment_begin = records.size();
+
+    bool corrupted = false;
+
+    for (std::uint32_t i = 0; i < header.count; i++) {
+      std::uint64_t score, play_time;
+      std::uint32_t name_size;
+
+      if (!read_pod(pos, segment_end, score) || !read_pod(pos, segment_end, play_time) ||
+          !read_pod(pos, segment_end, name_size) || name_size > static_cast<std::size_t>(segment_end - pos)) {
+        corrupted = true;
+        break;
+      }
+
+      records.push_back({
+        .name = std::string(pos, name_size),
+        .score = score,
+        .play_time = std::chrono::milliseconds(play_time)
+      });
+
+      pos += name_size;
+    }
+
+    // Повреждённый сегмент обрабатывается так же, как прерванный: 
+    // чтение останавливается на его начале
+    if (corrupted || pos != segment_end) {
+      records.resize(segment_begin);
+      break;
+    }
+
+    valid_end = segment_end;
+  }
+
+  std::sort(records.begin(), records.end(), ranks_before);
+  merge_into_index(std::move(records));
+
+  return static_cast<std::uint64_t>(valid_end - mapped.begin());
+}
+
+void Leaderboard::append_segment(const std::vector<Record>& records) {
+  if (!file_.is_open()) {
+    return;
+  }
+
+  // Сегмент, записанный частично, отрезается, чтобы следующие сегменты шли сразу за целыми
+  const auto valid_size = fs::file_size(*file_path_);
+
+  SegmentHeader header {
+    .magic = SEGMENT_MAGIC,
+    .count = static_cast<std::uint32_t>(records.size()),
+    .payload_size = 0u
+  };
+
+  for (const auto& record : records) {
+    header.payload_size += record_size(record);
+  }
+
+  write_pod(file_, header);
+
+  for (const auto& record : records) {
+    write_pod(file_, record.score);
+    write_pod(file_, static_cast<std::uint64_t>(record.play_time.count()));
+    write_pod(file_, static_cast<std::uint32_t>(record.name.size()));
+
+    file_.write(record.name.data(), record.name.size());
+  }
+
+  file_.flush();
+
+  // Сегмент считается сохранённым только после fdatasync: иначе при сбое питания 
+  // записи, уже отданные в таблицу, могут пропасть
+  if (file_ && !sync(*file_path_)) {
+    file_.setstate(std::ios::failbit);
+  }
+
+  if (!file_) {
+    file_.close();
+
+    std::error_code ec;
+    fs::resize_file(*file_path_, valid_size, ec);
+
+    file_.clear();
+    file_.open(*file_path_, std::ios::binary | std::ios::app);
+
+    throw std::runtime_error("Failed to write leaderboard segment"s);
+  }
+}
+
+void Leaderboard::merge_into_index(std::vector<Record>&& records) {
+  std::unique_lock lock(index_mutex_);
+
+  std::vector<Record> merged;
+  merged.reserve(std::min(top_k_, index_.size() + records.size()));
+
+  std::merge(std::make_move_iterator(index_.begin()), std::make_move_iterator(index_.end()),
+             std::make_move_iterator(records.begin()), std::make_move_iterator(records.end()),
+             std::back_inserter(merged), ranks_before);
+
+  if (merged.size() > top_k_) {
+    merged.resize(top_k_);
+  }
+
+  index_ = std::move(merged);
+}
+
+} // namespace leaderboard
@@ -0,0 +1,84 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <optional>
+#include <shared_mutex>
+#include <string>
+#include <vector>
+
+#include <boost/lockfree/queue.hpp>
+
+namespace leaderboard {
+
+namespace fs = std::filesystem;
+
+struct Record {
+  std::string name;
+  std::uint64_t score;
+  std::chrono::milliseconds play_time;
+};
+
+// Порядок записей в таблице рекордов: по убыванию очков,
+// при равенстве - по возрастанию времени игры, затем по имени
+[[nodiscard]] bool ranks_before(const Record& l, const Record& r) noexcept;
+
+/*
+ * Таблица рекордов вышедших из игры игроков.
+ *
+ * Записи сохраняются в append-only файл, состоящий из отсортированных сегментов:
+ * каждый сброс накопленных записей дописывает в конец файла один сегмент.
+ * При запуске файл отображается в память, и из всех сегментов строится
+ * индекс лучших top_k записей, из которого отдаются страницы таблицы.
+ *
+ * Записи добавляются из потоков игровых сессий через lock-free очередь,
+ * а в файл и индекс переносятся пачками вызовом flush().
+ */
+class Leaderboard final {
+public:
+  constexpr static std::size_t DEFAULT_TOP_K { 10'000u };
+
+  explicit Leaderboard(std::optional<fs::path> file, std::size_t top_k = DEFAULT_TOP_K);
+  ~Leaderboard();
+
+  Leaderboard(const Leaderboard&) = delete;
+  Leaderboard& operator=(const Leaderboard&) = delete;
+
+  // Может вызываться из любого потока
+  void push(Record record);
+
+  // Записывает накопленные записи в файл, сбрасывая их на диск, и добавляет их в индекс.
+  // Если запись в файл не удалась, записи остаются до следующего вызова,
+  // а исключение передаётся вызывающему. Не должен вызываться одновременно 
+  // из нескольких потоков
+  void flush();
+
+  [[nodiscard]] std::vector<Record> page(std::size_t start, std::size_t max_items) const;
+  [[nodiscard]] std::size_t size() const;
+
+private:
+  // Загружает сегменты файла и возвращает размер его части, состоящей из целых сегментов
+  std::uint64_t load();
+  void append_segment(const std::vector<Record>& records);
+  void merge_into_index(std::vector<Record>&& records);
+
+private:
+  constexpr static std::size_t QUEUE_CAPACITY { 1024u };
+
+  std::optional<fs::path> file_path_;
+  std::ofstream file_;
+
+  // Записи, сегмент которых не удалось записать при прошлом сбросе
+  std::vector<Record> unsaved_;
+
+  std::size_t top_k_;
+
+  boost::lockfree::queue<Record*> queue_ { QUEUE_CAPACITY };
+
+  mutable std::shared_mutex index_mutex_;
+  std::vector<Record> index_;
+};
+
+} // namespace leaderboard
@@ -2,11 +2,24 @@
 
 #include "session.hpp"
 #include "logger.hpp"
+#include "admission.hpp"
 
 #include <boost/asio/ip/tcp.hpp>
+#include <boost/asio/post.hpp>
+#include <boost/asio/steady_timer.hpp>
 #include <boost/asio/strand.hpp>
 #include <boost/beast/core.hpp>
 
+#include <cerrno>
+#include <chrono>
+#include <memory>
+#include <span>
+#include <vector>
+
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/socket.h>
+
 namespace http_server {
 
 namespace net = boost::asio;
@@ -15,26 +28,132 @@ namespace sys = boost::system;
 
 using tcp = net::ip::tcp;
 
+// Целочисленный параметр сокета, которого нет среди параметров Asio. Реализует
+// требования SettableSocketOption, поэтому передаётся в set_option
+template <int Level, int Name>
+class IntegerOption {
+public:
+  explicit IntegerOption(int value) noexcept
+    : value_(value) {
+  }
+
+  template <typename Protocol>
+  int level(const Protocol&) const noexcept {
+    return Level;
+  }
+
+  template <typename Protocol>
+  int name(const Protocol&) const noexcept {
+    return Name;
+  }
+
+  template <typename Protocol>
+  const void* data(const Protocol&) const noexcept {
+    return &value_;
+  }
+
+  template <typename Protocol>
+  std::size_t size(const Protocol&) const noexcept {
+    return sizeof(value_);
+  }
+
+private:
+  int value_;
+};
+
+#ifdef SO_REUSEPORT
+using reuse_port = IntegerOption<SOL_SOCKET, SO_REUSEPORT>;
+#endif
+
+#ifdef TCP_DEFER_ACCEPT
+using defer_accept = IntegerOption<IPPROTO_TCP, TCP_DEFER_ACCEPT>;
+#endif
+
+// Интерфейс слушателя, не зависящий от типа обработчика запросов
+class ListenerBase {
+public:
+  virtual ~ListenerBase() = default;
+
+  // Прекращает приём соединений. Сам сокет закрывается на strand'е acceptor'а
+  virtual void stop() = 0;
+
+  [[nodiscard]] virtual tcp::acceptor::native_handle_type native_handle() = 0;
+};
+
+using Listeners = std::vector<std::shared_ptr<ListenerBase>>;
+
 template <typename RequestHandler>
-class Listener : public std::enable_shared_from_this<Listener<RequestHandler>> {
+class Listener : public ListenerBase, public std::enable_shared_from_this<Listener<RequestHandler>> {
 public: 
 
   template <typename Handler>
-  Listener(net::io_context& io, const tcp::endpoint& endpoint, Handler&& handler)
+  Listener(net::io_context& io, const tcp::endpoint& endpoint, const config::ListenerConfig& cfg, 
+           admission::Controller* admission, Handler&& handler)
     : io_(io)
     , acceptor_(net::make_strand(io))
+    , retry_timer_(acceptor_.get_executor())
+    , tcp_nodelay_(cfg.tcp_nodelay)
+    , admission_(admission)
     , request_handler_(std::forward<Handler>(handler)) {
     
     acceptor_.open(endpoint.protocol());
     acceptor_.set_option(net::socket_base::reuse_address(true));
+
+    if (cfg.reuse_port || cfg.acceptors > 1u) {
+#ifdef SO_REUSEPORT
+      acceptor_.set_option(reuse_port(true));
+#else
+      throw std::invalid_argument("Multiple listeners require SO_REUSEPORT support"s);
+#endif
+    }
+
+#ifdef TCP_DEFER_ACCEPT
+    if (cfg.defer_accept) {
+      acceptor_.set_option(defer_accept(static_cast<int>(cfg.defer_accept->count())));
+    }
+#endif
+
     acceptor_.bind(endpoint);
-    acceptor_.listen(net::socket_base::max_listen_connections);
+    acceptor_.listen(cfg.backlog);
+  }
+
+  // Принимает соединения на уже слушающем сокете, полученном от другого процесса
+  template <typename Handler>
+  Listener(net::io_context& io, tcp::acceptor::native_handle_type socket, const config::ListenerConfig& cfg, 
+           admission::Controller* admission, Handler&& handler)
+    : io_(io)
+    , acceptor_(net::make_strand(io))
+    , retry_timer_(acceptor_.get_executor())
+    , tcp_nodelay_(cfg.tcp_nodelay)
+    , admission_(admission)
+    , request_handler_(std::forward<Handler>(handler)) {
+
+    sockaddr_storage addr {};
+    socklen_t len = sizeof(addr);
+
+    if (::getsockname(socket, reinterpret_cast<sockaddr*>(&addr), &len) != 0) {
+      throw std::invalid_argument("Invalid inherited socket"s);
+    }
+
+    acceptor_.assign(addr.ss_family == AF_INET6 ? tcp::v6() : tcp::v4(), socket);
   }
 
   void run() {
     do_accept();
   }
 
+  void stop() override {
+    net::post(acceptor_.get_executor(), [self = this->shared_from_this()] {
+      sys::error_code ec;
+      self->acceptor_.close(ec);
+      self->retry_timer_.cancel();
+    });
+  }
+
+  tcp::acceptor::native_handle_type native_handle() override {
+    return acceptor_.native_handle();
+  }
+
 private:
   void do_accept() {
     acceptor_.async_accept(
@@ -46,23 +165,93 @@ private:
   void on_accept(sys::error_code ec, tcp::socket socket) {
     using namespace std::literals;
     
+    if (ec == net::error::operation_aborted) {
+      return;
+    }
+
     if (ec) {
       LOG_SYSTEM_ERROR(ec.value(), ec.message())
+
+      // Нехватка дескрипторов и буферов проходит, когда закрываются другие
+      // соединения, поэтому приём возобновляется после паузы
+      if (is_transient(ec)) {
+        retry_timer_.expires_after(ACCEPT_RETRY_DELAY);
+        retry_timer_.async_wait(beast::bind_front_handler(&Listener::on_retry, this->shared_from_this()));
+      }
+
       return;
     }
 
-    run_session(std::move(socket));
+    admission::Ticket ticket;
+
+    if (admission_) {
+      const auto remote = socket.remote_endpoint(ec);
+
+      if (ec) {
+        return do_accept();
+      }
+
+      auto [verdict, admitted] = admission_->admit(remote.address());
+
+      if (verdict != admission::Verdict::accepted) {
+        reject(std::move(socket), verdict);
+        return do_accept();
+      }
+
+      ticket = std::move(admitted);
+    }
+
+    if (tcp_nodelay_) {
+      socket.set_option(tcp::no_delay(true), ec);
+    }
+
+    run_session(std::move(socket), std::move(ticket));
     do_accept();
   }
 
-  void run_session(tcp::socket&& socket) {
-    auto session = std::make_shared<Session<RequestHandler>>(std::move(socket), request_handler_);
+  void on_retry(sys::error_code ec) {
+    if (!ec && acceptor_.is_open()) {
+      do_accept();
+    }
+  }
+
+  [[nodiscard]] static bool is_transient(const sys::error_code& ec) noexcept {
+    return ec == net::error::no_descriptors
+        || ec == sys::error_code(ENFILE, sys::system_category())
+        || ec == net::error::no_buffer_space
+        || ec == net::error::connection_aborted;
+  }
+
+  void run_session(tcp::socket&& socket, admission::Ticket&& ticket) {
+    auto session = std::make_shared<Session<RequestHandler>>(std::move(socket), std::move(ticket), request_handler_);
     session->run();
   }
 
+  // Отказ отправляется сразу, запрос клиента не читается
+  static void reject(tcp::socket&& socket, admission::Verdict verdict) {
+    static constexpr std::string_view service_unavailable = 
+      "HTTP/1.1 503 Service Unavailable\r\nContent-Length: 0\r\nRetry-After: 1\r\nConnection: close\r\n\r\n"sv;
+    static constexpr std::string_view too_many_requests = 
+      "HTTP/1.1 429 Too Many Requests\r\nContent-Length: 0\r\nRetry-After: 1\r\nConnection: close\r\n\r\n"sv;
+
+    const auto response = (verdict == admission::Verdict::server_busy) ? service_unavailable : too_many_requests;
+    auto rejected = std::make_shared<tcp::socket>(std::move(socket));
+
+    net::async_write(*rejected, net::buffer(response), [rejected](sys::error_code, std::size_t) {
+      sys::error_code ec;
+      rejected->shutdown(tcp::socket::shutdown_send, ec);
+    });
+  }
+
 private:
+  constexpr static std::chrono::milliseconds ACCEPT_RETRY_DELAY { 100 };
+
   net::io_context& io_;
   tcp::acceptor acceptor_;
+  net::steady_timer retry_timer_;
+
+  bool tcp_nodelay_;
+  admission::Controller* admission_;
 
   RequestHandler request_handler_;
 };
@@ -71,12 +260,42 @@ private:
 
 namespace http_server {
 
+// Если задан admission, соединения сверх его пределов отклоняются до чтения запроса.
+// Открывает cfg.acceptors acceptor'ов на одном адресе, у каждого своя цепочка
+// async_accept, поэтому приём соединений не упирается в один strand
 template <typename RequestHandler>
-void serve_http(net::io_context& io, const tcp::endpoint& endpoint, RequestHandler&& handler) {
+Listeners serve_http(net::io_context& io, const tcp::endpoint& endpoint, const config::ListenerConfig& cfg, 
+                     admission::Controller* admission, RequestHandler&& handler) {
   using MyListener = Listener<std::decay_t<RequestHandler>>;
 
-  auto listener = std::make_shared<MyListener>(io, endpoint, std::forward<RequestHandler>(handler));
-  listener->run();
+  Listeners listeners;
+
+  for (unsigned i = 0; i < cfg.acceptors; i++) {
+    auto listener = std::make_shared<MyListener>(io, endpoint, cfg, admission, handler);
+    listener->run();
+
+    listeners.push_back(std::move(listener));
+  }
+
+  return listeners;
+}
+
+// Принимает соединения на слушающих сокетах sockets, переданных предыдущим процессом сервера
+template <typename RequestHandler>
+Listeners serve_http(net::io_context& io, std::span<const int> sockets, const config::ListenerConfig& cfg, 
+                     admission::Controller* admission, RequestHandler&& handler) {
+  using MyListener = Listener<std::decay_t<RequestHandler>>;
+
+  Listeners listeners;
+
+  for (const auto socket : sockets) {
+    auto listener = std::make_shared<MyListener>(io, socket, cfg, admission, handler);
+    listener->run();
+
+    listeners.push_back(std::move(listener));
+  }
+
+  return listeners;
 }
 
 } // namespace http_server
\ No newline at end of file
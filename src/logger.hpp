@@ -30,11 +30,12 @@ BOOST_LOG_ATTRIBUTE_KEYWORD(data, "Data", boost::json::value)
   )  \
   << "request received"sv;
 
-#define LOG_RESPONSE(response_time, code, content_type) \
+#define LOG_RESPONSE(response_time, code, content_type, body_size) \
   LOG_INFO << JSON_DATA( \
     {"response_time"sv, response_time}, \
     {"code"sv, code}, \
-    {"content_type"sv, content_type}  \
+    {"content_type"sv, content_type}, \
+    {"body_size"sv, body_size}  \
   )  \
   << "response sent"sv;
 
@@ -2,44 +2,57 @@
 
 #include <algorithm>
 #include <cmath>
+#include <stdexcept>
 
 namespace model {
 
-std::string_view Loot::name() const noexcept {
-  return name_;
-}
+using namespace std::literals;
 
-void Loot::position(const geom::Position position) {
-  position_ = std::move(position);
-}
+LootPool::Handle LootPool::add(const Loot& loot) {
+  size_++;
 
-void Loot::type(Type type) noexcept {
-  type_ = type;
-}
+  if (!free_.empty()) {
+    const auto handle = free_.back();
+    free_.pop_back();
+
+    slots_[handle] = { loot, true };
+    return handle;
+  }
 
-void Loot::value(Value value) noexcept {
-  value_ = value;
+  slots_.push_back({ loot, true });
+  return static_cast<Handle>(slots_.size() - 1);
 }
 
-void Loot::name(std::string_view name) noexcept {
-  name_ = name;
+void LootPool::remove(Handle handle) {
+  if (!contains(handle)) {
+    return;
+  }
+
+  slots_[handle].used = false;
+  free_.push_back(handle);
+  size_--;
 }
 
-const geom::Position& Loot::position() const noexcept {
-  return position_;
+void LootPool::clear() noexcept {
+  slots_.clear();
+  free_.clear();
+  size_ = 0u;
 }
 
-Loot::Type Loot::type() const noexcept {
-  return type_;
+bool LootPool::contains(Handle handle) const noexcept {
+  return handle < slots_.size() && slots_[handle].used;
 }
 
-Loot::Value Loot::value() const noexcept {
-  return value_;
+const Loot& LootPool::get(Handle handle) const {
+  if (!contains(handle)) {
+    throw std::out_of_range("Invalid loot handle"s);
+  }
+
+  return slots_[handle].loot;
 }
 
-LootGenerator& LootGenerator::instance() noexcept {
-  static LootGenerator lg;
-  return lg;
+std::size_t LootPool::size() const noexcept {
+  return size_;
 }
 
 void LootGenerator::config(LootGeneratorConfig cfg) {
@@ -50,24 +63,97 @@ void LootGenerator::generator(RandomGenerator&& random_generator) {
   random_generator_ = std::move(random_generator);
 }
 
-unsigned LootGenerator::generate(TimeInterval time_delta, unsigned loot_count, unsigned looter_count) {
-  using namespace std::literals;
-  
-  time_without_loot_ += time_delta;
+const LootGeneratorConfig& LootGenerator::config() const noexcept {
+  return cfg_;
+}
+
+LootGenerator::Slot LootGenerator::add() {
+  Slot slot;
+
+  if (!free_.empty()) {
+    slot = free_.back();
+    free_.pop_back();
+  } else {
+    slot = static_cast<Slot>(used_.size());
+
+    time_without_loot_.push_back(0.0);
+    loot_count_.push_back(0u);
+    looter_count_.push_back(0u);
+    used_.push_back(0u);
+    random_.push_back(0.0);
+    generated_.push_back(0u);
+  }
 
-  const unsigned loot_shortage = loot_count > looter_count ? 0u : looter_count - loot_count;
-  const double ratio = std::chrono::duration<double>{time_without_loot_} / cfg_.period;
+  time_without_loot_[slot] = 0.0;
+  loot_count_[slot] = looter_count_[slot] = generated_[slot] = 0u;
+  used_[slot] = 1u;
 
-  const double probability
-    = std::clamp((1.0 - std::pow(1.0 - cfg_.probability, ratio)) * random_generator_(), 0.0, 1.0);
+  return slot;
+}
 
-  const unsigned generated_loot = static_cast<unsigned>(std::round(loot_shortage * probability));
-  
-  if (generated_loot > 0) {
-    time_without_loot_ = {};
+void LootGenerator::remove(Slot slot) {
+  if (slot >= used_.size() || !used_[slot]) {
+    return;
   }
 
-  return generated_loot;
+  // Свободный слот участвует в generate, но ничего не создаёт
+  time_without_loot_[slot] = 0.0;
+  loot_count_[slot] = looter_count_[slot] = 0u;
+  used_[slot] = 0u;
+
+  free_.push_back(slot);
+}
+
+void LootGenerator::counts(Slot slot, unsigned loot_count, unsigned looter_count) noexcept {
+  loot_count_[slot] = loot_count;
+  looter_count_[slot] = looter_count;
+}
+
+void LootGenerator::generate(TimeInterval time_delta) {
+  // Случайные величины запрашиваются заранее и по порядку слотов, 
+  // чтобы основной цикл не содержал вызовов через std::function
+  for (std::size_t i = 0; i < used_.size(); i++) {
+    random_[i] = used_[i] ? random_generator_() : 0.0;
+  }
+
+  evaluate(0u, used_.size(), std::chrono::duration<double>(time_delta).count());
+}
+
+unsigned LootGenerator::generated(Slot slot) const noexcept {
+  return generated_[slot];
+}
+
+unsigned LootGenerator::generate(Slot slot, TimeInterval time_delta, unsigned loot_count, unsigned looter_count) {
+  counts(slot, loot_count, looter_count);
+  random_[slot] = random_generator_();
+
+  evaluate(slot, slot + 1, std::chrono::duration<double>(time_delta).count());
+
+  return generated_[slot];
+}
+
+void LootGenerator::evaluate(std::size_t first, std::size_t last, double time_delta) {
+  const double period = std::chrono::duration<double>(cfg_.period).count();
+  const double miss_probability = 1.0 - cfg_.probability;
+
+  double* time_without_loot = time_without_loot_.data();
+  const std::uint32_t* loot_count = loot_count_.data();
+  const std::uint32_t* looter_count = looter_count_.data();
+  const double* random = random_.data();
+  std::uint32_t* generated = generated_.data();
+
+  // Цикл без ветвлений по независимым элементам массивов, 
+  // компилятор может выполнить его векторными инструкциями
+  for (std::size_t i = first; i < last; i++) {
+    const double elapsed = time_without_loot[i] + time_delta;
+    const double shortage = looter_count[i] > loot_count[i] ? double(looter_count[i] - loot_count[i]) : 0.0;
+
+    const double probability = std::clamp((1.0 - std::pow(miss_probability, elapsed / period)) * random[i], 0.0, 1.0);
+    const auto amount = static_cast<std::uint32_t>(std::round(shortage * probability));
+
+    generated[i] = amount;
+    time_without_loot[i] = amount > 0 ? 0.0 : elapsed;
+  }
 }
 
 } // namespace model
\ No newline at end of file
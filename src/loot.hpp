@@ -3,81 +3,71 @@
 #include "geometry.hpp"
 
 #include <chrono>
+#include <cstdint>
 #include <functional>
-#include <memory>
+#include <type_traits>
+#include <vector>
 
 namespace model {
 
-class Loot {
-public:
+// Потерянный предмет. Хранит только индекс типа в таблице типов трофеев карты,
+// имена типов хранятся в этой таблице в единственном экземпляре
+struct Loot {
   using Id = std::uint64_t;
   using Type = std::uint64_t;
   using Value = std::uint64_t;
 
-  Loot() = default;
-  
-  void position(const geom::Position position);
-  void type(Type type) noexcept;
-  void value(Value value) noexcept;
-  void name(std::string_view name) noexcept;
-
-  [[nodiscard]] const geom::Position& position() const noexcept;
-  [[nodiscard]] Type type() const noexcept;
-  [[nodiscard]] Value value() const noexcept;
+  constexpr static double WIDTH { 0.0 };
 
-  [[nodiscard]] virtual double width() const noexcept {
-    return 0.0;
-  }
+  Id id;
+  Type type;
+  Value value;
 
-  [[nodiscard]] std::string_view name() const noexcept;
-
-protected: 
-  explicit Loot(std::string_view name, Type type, Value value)
-    : name_(name)
-    , type_(type) 
-    , value_(value) {
-  }
-
-protected:
-  Type type_;
-  Value value_;
-
-  geom::Position position_;
-
-  std::string name_;
+  geom::Position position;
 };
 
-class Key final : public Loot {
-public:
-  Key() = default;
+static_assert(std::is_trivially_copyable_v<Loot>);
 
-  explicit Key(std::string_view name, Type type, Value value)
-    : Loot(name, type, value) {
+/*
+ * Пул потерянных предметов игровой сессии.
+ * Предметы хранятся по значению в непрерывном массиве слотов, освободившиеся 
+ * слоты переиспользуются, поэтому появление и подбор предметов не приводят 
+ * к выделению памяти, как только пул достиг рабочего размера.
+ * Handle предмета остаётся действительным до его удаления из пула.
+ */
+class LootPool final {
+public:
+  using Handle = std::uint32_t;
+
+  Handle add(const Loot& loot);
+  void remove(Handle handle);
+  void clear() noexcept;
+
+  [[nodiscard]] bool contains(Handle handle) const noexcept;
+  [[nodiscard]] const Loot& get(Handle handle) const;
+  [[nodiscard]] std::size_t size() const noexcept;
+
+  // Обходит предметы, находящиеся в пуле: fn(Handle, const Loot&)
+  template <typename Fn>
+  void for_each(Fn&& fn) const {
+    for (Handle handle = 0; handle < slots_.size(); handle++) {
+      if (slots_[handle].used) {
+        fn(handle, slots_[handle].loot);
+      }
+    }
   }
-};
 
-class Wallet final : public Loot {
-public:  
-  Wallet() = default;
-
-  explicit Wallet(std::string_view name, Type type, Value value)
-    : Loot(name, type, value) {
-  }
-};
+private:
+  struct Slot {
+    Loot loot;
+    bool used;
+  };
 
-template <typename... Args>
-inline std::shared_ptr<Loot> create_loot(std::string_view name, Loot::Type type, Loot::Value value, Args&&... args) {
-  using namespace std::literals;
-  
-  if (name == "key"sv) {
-    return std::make_shared<Key>(name, type, value);
-  }
-  if (name == "wallet"sv) {
-    return std::make_shared<Wallet>(name, type, value);
-  }
+  std::vector<Slot> slots_;
+  std::vector<Handle> free_;
 
-  return nullptr;
-}
+  std::size_t size_ { 0u };
+};
 
 struct LootGeneratorConfig {
   // Вероятность появления на карте потерянного 
@@ -88,40 +78,76 @@ struct LootGeneratorConfig {
   double probability;
 };
 
+/*
+ * Генератор трофеев для набора игровых сессий.
+ *
+ * Каждой сессии соответствует слот со своим временем без появления трофеев.
+ * Состояние слотов хранится в отдельных непрерывных массивах, поэтому 
+ * generate для всех сессий выполняется одним проходом по этим массивам.
+ * Освободившиеся слоты переиспользуются.
+ */
 class LootGenerator final {
 public:
   using RandomGenerator = std::function<double()>;
   using TimeInterval = LootGeneratorConfig::TimeInterval;
+  using Slot = std::uint32_t;
 
-  static LootGenerator& instance() noexcept;
+  LootGenerator() = default;
+
+  explicit LootGenerator(LootGeneratorConfig cfg, RandomGenerator random_generator = default_generator)
+    : cfg_(std::move(cfg))
+    , random_generator_(std::move(random_generator)) {
+  }
 
   void config(LootGeneratorConfig cfg);
   void generator(RandomGenerator&& random_generator);
 
+  [[nodiscard]] const LootGeneratorConfig& config() const noexcept;
+
+  Slot add();
+  void remove(Slot slot);
+
   /*
-   * Возвращает количество трофеев, которые должны появиться на карте спустя
-   * заданный промежуток времени.
-   * Количество трофеев, появляющихся на карте не превышает количество мародёров.
-   *
-   * time_delta - отрезок времени, прошедший с момента предыдущего вызова generate
-   * loot_count - количество трофеев на карте до вызова generate
-   * looter_count - количество мародёров на карте
+   * Задаёт количество трофеев на карте (loot_count) и количество 
+   * мародёров (looter_count) сессии для следующего вызова generate
    */
-  [[nodiscard]] unsigned generate(TimeInterval time_delta, unsigned loot_count, unsigned looter_count);
+  void counts(Slot slot, unsigned loot_count, unsigned looter_count) noexcept;
 
-private:
-  LootGenerator() = default;
+  /*
+   * Для каждого занятого слота вычисляет количество трофеев, которые должны 
+   * появиться на карте спустя time_delta с момента предыдущего вызова generate.
+   * Количество трофеев, появляющихся на карте, не превышает количество мародёров.
+   * Результат возвращается методом generated
+   */
+  void generate(TimeInterval time_delta);
+
+  [[nodiscard]] unsigned generated(Slot slot) const noexcept;
+
+  // Задаёт количества и вычисляет результат для одного слота
+  [[nodiscard]] unsigned generate(Slot slot, TimeInterval time_delta, unsigned loot_count, unsigned looter_count);
 
 private:
   static constexpr double default_generator() noexcept {
     return 1.0;
   } 
 
-private: 
-  TimeInterval time_without_loot_ {};
+  void evaluate(std::size_t first, std::size_t last, double time_delta);
 
-  LootGeneratorConfig cfg_;
+private: 
+  LootGeneratorConfig cfg_ { .period = std::chrono::seconds(1), .probability = 0.0 };
   RandomGenerator random_generator_ { default_generator };
+
+  // Состояние слотов
+  std::vector<double> time_without_loot_;
+  std::vector<std::uint32_t> loot_count_;
+  std::vector<std::uint32_t> looter_count_;
+  std::vector<std::uint8_t> used_;
+
+  // Промежуточные значения и результат generate
+  std::vector<double> random_;
+  std::vector<std::uint32_t> generated_;
+
+  std::vector<Slot> free_;
 };
 
 
@@ -59,6 +59,10 @@ const Map::Offices& Map::get_offices() const noexcept {
   return offices_;
 }
 
+const Map::LootTypes& Map::get_loot_types() const noexcept {
+  return loot_types_;
+}
+
 void Map::add_road_position(const Road& road) {
   geom::Coord start, start_x, start_y, end;    
 
@@ -114,6 +118,11 @@ void Map::add_office(const Office& office) {
   }
 }
 
+void Map::add_loot_type(std::string name, Loot::Value value) {
+  const Loot::Type index = loot_types_.size();
+  loot_types_.push_back({ index, std::move(name), value });
+}
+
 const Road* Map::get_road_by_position(const geom::Position& position) const {
   const auto it = roads_positions.find({std::round(position.x), std::round(position.y)});
   if (it != roads_positions.cend()) 
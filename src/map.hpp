@@ -2,6 +2,7 @@
 
 #include "tagged.hpp"
 #include "geometry.hpp"
+#include "loot.hpp"
 
 #include <vector>
 #include <unordered_map>
@@ -81,12 +82,21 @@ private:
   geom::Offset offset_;
 };
 
+// Тип трофеев карты. Имя типа хранится только здесь, 
+// предметы ссылаются на него по индексу
+struct LootType {
+  Loot::Type index;
+  std::string name;
+  Loot::Value value;
+};
+
 class Map {
 public:
   using Id        = util::Tagged<std::string, Map>;
   using Roads     = std::vector<Road>;
   using Buildings = std::vector<Building>;
   using Offices   = std::vector<Office>;
+  using LootTypes = std::vector<LootType>;
 
   using IdHasher = util::TaggedHasher<Map::Id>;
 
@@ -102,12 +112,14 @@ public:
   const Buildings& get_buildings() const noexcept;
   const Roads& get_roads() const noexcept;
   const Offices& get_offices() const noexcept;
+  const LootTypes& get_loot_types() const noexcept;
 
   const Road* get_road_by_position(const geom::Position& position) const;
 
   void add_road(const Road& road);
   void add_building(const Building& building);
   void add_office(const Office& office);
+  void add_loot_type(std::string name, Loot::Value value);
 
 private:
   void add_road_position(const Road& road);
@@ -124,6 +136,8 @@ private:
   OfficeIdToIndex warehouse_id_to_index_;
   Offices offices_;
 
+  LootTypes loot_types_;
+
   std::unordered_map<geom::Position, Road, geom::PositionHasher> roads_positions;
 };
 
@@ -4,7 +4,7 @@ namespace mux {
 
 Route::Route() {
   not_allowed_handler_ = std::make_unique<http_handler::HandlerFunc>([this](http_string_request_t&& req) {
-    return response::make(response::MethodNotAllowed<ct::text_plain>(req.version(), req.keep_alive(), allowed_methods().as_string()));  
+    return response::make(response::MethodNotAllowed<ct::text_plain>(req.version(), req.keep_alive(), allowed_methods()));  
   });
 }
 
@@ -22,6 +22,15 @@ Route* Route::methods(http_methods::Method allowed_methods) noexcept {
   return this;
 }
 
+Route* Route::session_bound(bool value) noexcept {
+  session_bound_ = value;
+  return this;
+}
+
+[[nodiscard]] bool Route::session_bound() const noexcept {
+  return session_bound_;
+}
+
 [[nodiscard]] const http_handler::Handler& Route::handler() const noexcept {
   return *handler_.get();
 }
@@ -39,14 +48,19 @@ Route* Route::not_allowed_handler(http_handler::HandlerFunc::Type&& handler) {
   return this;
 }
 
-void Route::path(std::string_view path) noexcept {
+void Route::path(std::string_view path) {
   path_ = std::string(path);
+  regex_ = std::regex(path_, std::regex::optimize);
 }
 
 [[nodiscard]] const std::string& Route::path() const noexcept {
   return path_;
 }
 
+[[nodiscard]] const std::regex& Route::regex() const noexcept {
+  return regex_;
+}
+
 Route* Router::handle_func(std::string_view pattern, http_handler::HandlerFunc::Type&& handler) { 
   auto& el = routes_.emplace_back(std::make_unique<Route>());
   el->handler_func(std::move(handler));
@@ -30,6 +30,9 @@ struct RouteMatch {
   const http_handler::Handler* handler;
   MatchError error; 
 
+  // Обработчик должен выполняться на strand'е игровой сессии игрока
+  bool session_bound;
+
 public:
   RouteMatch() = default;
 
@@ -50,23 +53,29 @@ public:
   Route* not_allowed_handler(http_handler::HandlerFunc::Type&& handler);
 
   Route* methods(http_methods::Method allowed_methods) noexcept;
+  Route* session_bound(bool value = true) noexcept;
 
-  void path(std::string_view path) noexcept;
+  // Регулярное выражение пути компилируется один раз, при регистрации маршрута
+  void path(std::string_view path);
 
   [[nodiscard]] const http_handler::Handler& handler() const noexcept; 
   [[nodiscard]] const http_handler::Handler& not_allowed_handler() const;
 
   [[nodiscard]] const http_methods::AllowedMethod& allowed_methods() const noexcept;
+  [[nodiscard]] bool session_bound() const noexcept;
 
   [[nodiscard]] const std::string& path() const noexcept;
+  [[nodiscard]] const std::regex& regex() const noexcept;
 
 private:
   std::unique_ptr<http_handler::Handler> handler_;
   std::unique_ptr<http_handler::Handler> not_allowed_handler_;
 
   http_methods::AllowedMethod allowed_methods_;
+  bool session_bound_ { false };
 
   std::string path_;
+  std::regex regex_;
 }; 
  
 class Router final {
@@ -77,41 +86,47 @@ public:
 
   template <typename Body, typename Allocator>
   [[nodiscard]] RouteMatch process(http_request_t<Body, Allocator>& req) const { 
-    // decode url
-    urls::pct_string_view encoded_url = req.target();
+    // Буфер декодирования переиспользуется запросами потока и не выделяет память,
+    // пока цель запроса не длиннее уже встречавшихся
+    thread_local std::string path;
 
-    std::string path; 
-    path.resize(encoded_url.decoded_size());
+    urls::pct_string_view encoded_url = req.target();
 
     encoded_url.decode({}, urls::string_token::assign_to(path));      
     boost::trim_right(path);
 
     // remove last '/'
     if (path.length() > 1 && path.ends_with("/"sv) && !path.ends_with("//"sv)) {
-      path = path.substr(0, path.length()-1);
+      path.pop_back();
     }
 
     req.target(path);
 
+    // Строка запроса не участвует в выборе маршрута
+    const auto route_path = std::string_view(path).substr(0, path.find('?'));
+
     RouteMatch match;
 
     for (const auto& route : routes_) {
-      if (std::regex_match(path, std::regex(route->path()))) {
-        if (!route->allowed_methods().is_allowed(req.method_string())) {
+      if (std::regex_match(route_path.begin(), route_path.end(), route->regex())) {
+        if (!route->allowed_methods().is_allowed(req.method())) {
           match.error = MatchError::MethodMismatch;
           match.handler = &route->not_allowed_handler();
+          match.session_bound = false;
 
           break;
         }
 
         match.error = MatchError::NoError;
         match.handler = &route->handler();
+        match.session_bound = route->session_bound();
 
         break;
       }
 
       match.error = MatchError::NotFound;
       match.handler = nullptr;
+      match.session_bound = false;
     }
 
     return match;
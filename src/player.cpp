@@ -46,10 +46,28 @@ Token::Type PlayerToken::sha256(std::string_view str) {
   return ss.str();
 }
 
+std::string_view extract_token(std::string_view value) noexcept {
+  constexpr auto prefix = "Bearer "sv;
+
+  if (value.size() < prefix.size()) {
+    return {};
+  }
+
+  return value.substr(prefix.size());
+}
+
 const model::GameSession& Player::game_session() const noexcept {
   return game_session_;
 }
 
+model::GameSession& Player::game_session() noexcept {
+  return game_session_;
+}
+
+model::Character::Id Player::character_id() const noexcept {
+  return character_id_;
+}
+
 const model::Character& Player::character() const noexcept {
   return *character_.get();
 }
@@ -58,17 +76,27 @@ model::Character& Player::character() noexcept {
   return *character_.get();
 }
 
-Players::TokenPlayerPair Players::new_player(std::shared_ptr<model::Character> character, const model::GameSession& session) {
-  const auto it = players_by_token_.emplace(PlayerToken().get_new(), std::make_unique<Player>(character, session));
+Players::TokenPlayerPair Players::new_player(model::Character::Id character_id, std::shared_ptr<model::Character> character, model::GameSession& session) {
+  std::unique_lock lock(mutex_);
+
+  const auto it = players_by_token_.emplace(PlayerToken().get_new(), std::make_unique<Player>(character_id, character, session));
+  tokens_by_character_.emplace(character.get(), it.first->first);
+
   return { it.first->first, it.first->second.get() };
 }
 
 Players::TokenPlayerPair Players::add_player(const Token::Type& token, std::unique_ptr<Player> player) {
+  std::unique_lock lock(mutex_);
+
   const auto it = players_by_token_.emplace(std::move(token), std::move(player));
+  tokens_by_character_.emplace(&it.first->second->character(), it.first->first);
+
   return { it.first->first, it.first->second.get() };
 }
 
-Player* Players::find_by_token(const Token::Type& token) {
+Player* Players::find_by_token(std::string_view token) {
+  std::shared_lock lock(mutex_);
+
   const auto it = players_by_token_.find(token);
   if (it != players_by_token_.cend())
     return it->second.get();
@@ -76,6 +104,27 @@ Player* Players::find_by_token(const Token::Type& token) {
   return nullptr;
 }
 
+void Players::remove(const model::Character& character) {
+  std::unique_lock lock(mutex_);
+
+  const auto it = tokens_by_character_.find(&character);
+  if (it == tokens_by_character_.cend())
+    return;
+
+  players_by_token_.erase(it->second);
+  tokens_by_character_.erase(it);
+}
+
+std::optional<model::GameSession::Strand> Players::find_session_strand(std::string_view token) const {
+  std::shared_lock lock(mutex_);
+
+  const auto it = players_by_token_.find(token);
+  if (it != players_by_token_.cend())
+    return it->second->game_session().strand();
+
+  return std::nullopt;
+}
+
 Players& Players::instance() noexcept {
   static Players p;
   return p;
@@ -3,6 +3,9 @@
 #include "game.hpp"
 
 #include <random>
+#include <optional>
+#include <shared_mutex>
+#include <string_view>
 #include <unordered_map>
 
 namespace app {
@@ -28,41 +31,79 @@ private:
 private:
   Token::Type sha256(std::string_view str);
 };
+
+// Извлекает токен из значения заголовка вида "Bearer <token>"
+[[nodiscard]] std::string_view extract_token(std::string_view value) noexcept;
+
+// Позволяет искать игроков по std::string_view без создания строки
+struct TokenHasher {
+  using is_transparent = void;
+
+  [[nodiscard]] std::size_t operator()(std::string_view token) const noexcept {
+    return std::hash<std::string_view>{}(token);
+  }
+};
  
 class Player {
 public:
-  explicit Player(std::shared_ptr<model::Character> character, const model::GameSession& game_session)
-    : character_(std::move(character))
+  explicit Player(model::Character::Id character_id, std::shared_ptr<model::Character> character, model::GameSession& game_session)
+    : character_id_(character_id)
+    , character_(std::move(character))
     , game_session_(game_session) {
   }
 
   [[nodiscard]] const model::GameSession& game_session() const noexcept;
+  [[nodiscard]] model::GameSession& game_session() noexcept;
+  [[nodiscard]] model::Character::Id character_id() const noexcept;
   [[nodiscard]] const model::Character& character() const noexcept;
   [[nodiscard]] model::Character& character() noexcept;
 
 private:
-  const model::GameSession& game_session_;
+  model::Character::Id character_id_;
   std::shared_ptr<model::Character> character_;
+  model::GameSession& game_session_;
 };
 
 class Players {
 public:
-  using PlayersByToken = std::unordered_map<Token::Type, std::unique_ptr<Player>>;
+  using PlayersByToken = std::unordered_map<Token::Type, std::unique_ptr<Player>, TokenHasher, std::equal_to<>>;
   using TokenPlayerPair = std::pair<Token::Type, Player*>;
 
-  TokenPlayerPair new_player(std::shared_ptr<model::Character> character, const model::GameSession& session);
+  TokenPlayerPair new_player(model::Character::Id character_id, std::shared_ptr<model::Character> character, model::GameSession& session);
   TokenPlayerPair add_player(const Token::Type& token, std::unique_ptr<Player> player);
-  Player* find_by_token(const Token::Type& token);
+  Player* find_by_token(std::string_view token);
+
+  // Удаляет игрока, управляющего персонажем, вместе с его токеном
+  void remove(const model::Character& character);
+
+  // Возвращает strand игровой сессии, в которой находится игрок. 
+  // Может вызываться из любого потока
+  [[nodiscard]] std::optional<model::GameSession::Strand> find_session_strand(std::string_view token) const;
 
   [[nodiscard]] const PlayersByToken& all_players() const noexcept; 
 
+  // Обходит игроков под блокировкой: fn(const Token::Type&, const Player&)
+  template <typename Fn>
+  void for_each(Fn&& fn) const {
+    std::shared_lock lock(mutex_);
+
+    for (const auto& [token, player] : players_by_token_) {
+      fn(token, *player);
+    }
+  }
+
   static Players& instance() noexcept;
 
 private:
   Players() = default;
 
 private:
+  using TokensByCharacter = std::unordered_map<const model::Character*, Token::Type>;
+
+  mutable std::shared_mutex mutex_;
+
   PlayersByToken players_by_token_;
+  TokensByCharacter tokens_by_character_;
 };
 
 } // namespace app
\ No newline at end of file
@@ -0,0 +1,289 @@
+#include "profiler.hpp"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <map>
+#include <stdexcept>
+#include <thread>
+#include <unordered_map>
+
+#include <cxxabi.h>
+#include <dlfcn.h>
+#include <execinfo.h>
+#include <sys/time.h>
+#include <ucontext.h>
+
+namespace profiler {
+
+using namespace std::literals;
+
+namespace {
+
+std::int64_t now_ns() noexcept {
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(
+    std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+void* program_counter(void* context) noexcept {
+  const auto* uc = static_cast<const ucontext_t*>(context);
+
+#if defined(__x86_64__)
+  return reinterpret_cast<void*>(uc->uc_mcontext.gregs[REG_RIP]);
+#elif defined(__aarch64__)
+  return reinterpret_cast<void*>(uc->uc_mcontext.pc);
+#else
+  (void)uc;
+  return nullptr;
+#endif
+}
+
+void set_timer(std::chrono::microseconds interval) noexcept {
+  itimerval timer {};
+
+  timer.it_interval.tv_sec = static_cast<time_t>(interval.count() / 1'000'000);
+  timer.it_interval.tv_usec = static_cast<suseconds_t>(interval.count() % 1'000'000);
+  timer.it_value = timer.it_interval;
+
+  ::setitimer(ITIMER_PROF, &timer, nullptr);
+}
+
+// Имя функции по адресу. Функции исполняемого файла видны, только если
+// он собран с экспортом символов (-rdynamic)
+std::string symbolize(void* addr) {
+  Dl_info info {};
+
+  if (!::dladdr(addr, &info)) {
+    return "[unknown]"s;
+  }
+
+  if (info.dli_sname) {
+    int status = 0;
+    char* demangled = abi::__cxa_demangle(info.dli_sname, nullptr, nullptr, &status);
+
+    std::string name = (status == 0 && demangled) ? demangled : info.dli_sname;
+    std::free(demangled);
+
+    // ';' разделяет кадры в свёрнутом стеке
+    std::replace(name.begin(), name.end(), ';', ':');
+
+    return name;
+  }
+
+  if (info.dli_fname) {
+    const auto offset = static_cast<const char*>(addr) - static_cast<const char*>(info.dli_fbase);
+
+    char buf[32];
+    std::snprintf(buf, sizeof(buf), "+0x%tx]", offset);
+
+    return "["s + std::filesystem::path(info.dli_fname).filename().string() + buf;
+  }
+
+  return "[unknown]"s;
+}
+
+} // namespace
+
+bool Profiler::start(std::chrono::seconds duration, unsigned frequency) {
+  if (duration <= 0s || duration > MAX_DURATION) {
+    throw std::invalid_argument("Invalid profiling duration"s);
+  }
+
+  if (frequency == 0u || frequency > MAX_FREQUENCY) {
+    throw std::invalid_argument("Invalid sampling frequency"s);
+  }
+
+  std::lock_guard lock(mutex_);
+
+  if (active_) {
+    return false;
+  }
+
+  // Обработчики, начатые до остановки по времени, могут ещё писать в буфер
+  finish();
+
+  // Первый вызов backtrace загружает библиотеку раскрутки стека и выделяет память,
+  // поэтому он выполняется здесь, а не в обработчике сигнала
+  void* warmup[1];
+  ::backtrace(warmup, 1);
+
+  // Сигналы приходят за процессорное время всех потоков
+  const std::size_t threads = std::max(std::thread::hardware_concurrency(), 1u);
+
+  capacity_ = std::min<std::size_t>(MAX_SAMPLES, frequency * static_cast<std::size_t>(duration.count()) * threads);
+  samples_ = std::make_unique<Sample[]>(capacity_);
+
+  next_ = 0u;
+  dropped_ = 0u;
+  deadline_ = now_ns() + std::chrono::duration_cast<std::chrono::nanoseconds>(duration).count();
+
+  // Обработчик остаётся установленным: сигнал, пришедший после остановки
+  // таймера, не должен завершить процесс действием по умолчанию
+  if (!handler_installed_) {
+    struct sigaction action {};
+
+    action.sa_sigaction = &Profiler::on_signal;
+    action.sa_flags = SA_SIGINFO | SA_RESTART;
+    sigemptyset(&action.sa_mask);
+
+    if (::sigaction(SIGPROF, &action, nullptr) != 0) {
+      throw std::runtime_error("Unable to install SIGPROF handler: "s + std::strerror(errno));
+    }
+
+    handler_installed_ = true;
+  }
+
+  active_ = true;
+  set_timer(std::chrono::microseconds(1'000'000 / frequency));
+
+  return true;
+}
+
+void Profiler::stop() {
+  std::lock_guard lock(mutex_);
+  finish();
+}
+
+Profiler::Status Profiler::status() {
+  std::lock_guard lock(mutex_);
+  finish_if_expired();
+
+  Status status;
+
+  if (active_) {
+    status.state = State::running;
+    status.remaining = std::chrono::duration_cast<std::chrono::milliseconds>(
+      std::chrono::nanoseconds(std::max<std::int64_t>(deadline_ - now_ns(), 0)));
+  } else {
+    status.state = samples_ ? State::finished : State::idle;
+  }
+
+  status.samples = std::min(next_.load(), capacity_);
+  status.dropped = dropped_;
+
+  return status;
+}
+
+std::optional<std::string> Profiler::folded() {
+  std::lock_guard lock(mutex_);
+  finish_if_expired();
+
+  if (active_) {
+    return std::nullopt;
+  }
+
+  finish();
+
+  std::unordered_map<void*, std::string> names;
+  std::map<std::string, std::size_t> stacks;
+
+  const auto name_of = [&names](void* addr) -> const std::string& {
+    auto [it, inserted] = names.try_emplace(addr);
+
+    if (inserted) {
+      it->second = symbolize(addr);
+    }
+
+    return it->second;
+  };
+
+  const auto count = std::min(next_.load(), capacity_);
+
+  for (std::size_t i = 0; i < count; ++i) {
+    const auto& sample = samples_[i];
+
+    if (!sample.ready) {
+      continue;
+    }
+
+    const auto begin = sample.frames.begin();
+    const auto end = begin + sample.depth;
+
+    // Кадры до прерванной инструкции принадлежат обработчику сигнала
+    auto first = std::find(begin, end, sample.pc);
+
+    if (first == end) {
+      first = begin + std::min(sample.depth, 2);
+    }
+
+    std::string stack;
+
+    for (auto it = end; it != first;) {
+      --it;
+
+      if (!stack.empty()) {
+        stack += ';';
+      }
+
+      // Адрес возврата указывает на инструкцию после вызова
+      stack += name_of((it == first) ? *it : static_cast<char*>(*it) - 1);
+    }
+
+    if (!stack.empty()) {
+      ++stacks[std::move(stack)];
+    }
+  }
+
+  std::string result;
+
+  for (const auto& [stack, samples] : stacks) {
+    result += stack;
+    result += ' ';
+    result += std::to_string(samples);
+    result += '\n';
+  }
+
+  return result;
+}
+
+void Profiler::on_signal(int, siginfo_t*, void* context) noexcept {
+  const auto saved_errno = errno;
+
+  instance().take_sample(program_counter(context));
+
+  errno = saved_errno;
+}
+
+void Profiler::take_sample(void* pc) noexcept {
+  in_handler_++;
+
+  if (active_) {
+    if (now_ns() >= deadline_) {
+      // Время вышло: таймер выключается из обработчика, чтобы не ждать следующего запроса
+      if (active_.exchange(false)) {
+        set_timer(0us);
+      }
+    } else if (const auto index = next_.fetch_add(1u); index < capacity_) {
+      auto& sample = samples_[index];
+
+      sample.pc = pc;
+      sample.depth = ::backtrace(sample.frames.data(), static_cast<int>(MAX_DEPTH));
+      sample.ready.store(true, std::memory_order_release);
+    } else {
+      dropped_++;
+    }
+  }
+
+  in_handler_--;
+}
+
+void Profiler::finish() noexcept {
+  active_ = false;
+  set_timer(0us);
+
+  while (in_handler_ != 0u) {
+    std::this_thread::yield();
+  }
+}
+
+void Profiler::finish_if_expired() noexcept {
+  // Без нагрузки сигналы не приходят, и таймер выключается при следующем обращении
+  if (active_ && now_ns() >= deadline_) {
+    finish();
+  }
+}
+
+} // namespace profiler
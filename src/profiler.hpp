@@ -0,0 +1,107 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+
+#include <signal.h>
+
+namespace profiler {
+
+/*
+ * Выборочный профилировщик процессорного времени.
+ *
+ * На время профилирования включается таймер ITIMER_PROF: ядро отправляет
+ * SIGPROF потоку, потратившему очередной квант процессорного времени, поэтому
+ * выборки равномерно распределяются по всем работающим потокам. Обработчик
+ * сигнала только сохраняет стек вызовов в заранее выделенный буфер. Имена
+ * функций определяются после остановки, при построении свёрнутых стеков
+ * (формат "main;f;g 42" для flamegraph.pl и speedscope).
+ *
+ * Пока профилирование не запущено, таймер выключен и накладных расходов нет.
+ */
+class Profiler {
+public:
+  enum class State : std::uint8_t {
+    idle,
+    running,
+    finished
+  };
+
+  struct Status {
+    State state { State::idle };
+    std::size_t samples { 0u };
+    std::size_t dropped { 0u };
+    std::chrono::milliseconds remaining { 0 };
+  };
+
+  constexpr static unsigned DEFAULT_FREQUENCY = 99u;
+  constexpr static unsigned MAX_FREQUENCY = 1000u;
+  constexpr static std::chrono::seconds MAX_DURATION { 300 };
+
+  static Profiler& instance() {
+    static Profiler profiler;
+    return profiler;
+  }
+
+  Profiler(const Profiler&) = delete;
+  Profiler& operator=(const Profiler&) = delete;
+
+  // Запускает профилирование на duration с частотой frequency выборок в секунду
+  // процессорного времени. Возвращает false, если профилирование уже идёт
+  bool start(std::chrono::seconds duration, unsigned frequency = DEFAULT_FREQUENCY);
+
+  // Останавливает профилирование досрочно
+  void stop();
+
+  [[nodiscard]] Status status();
+
+  // Свёрнутые стеки последнего профилирования, по строке на стек.
+  // Если профилирование ещё идёт, возвращает std::nullopt
+  [[nodiscard]] std::optional<std::string> folded();
+
+private:
+  constexpr static std::size_t MAX_DEPTH = 48u;
+  constexpr static std::size_t MAX_SAMPLES = 1u << 15;
+
+  struct Sample {
+    std::atomic<bool> ready { false };
+    int depth { 0 };
+
+    // Адрес прерванной инструкции: кадры стека до него относятся к обработчику сигнала
+    void* pc { nullptr };
+    std::array<void*, MAX_DEPTH> frames {};
+  };
+
+  Profiler() = default;
+
+  static void on_signal(int signal, siginfo_t* info, void* context) noexcept;
+  void take_sample(void* pc) noexcept;
+
+  // Выключает таймер и дожидается завершения начатых обработчиков сигнала
+  void finish() noexcept;
+  void finish_if_expired() noexcept;
+
+private:
+  std::mutex mutex_;
+
+  std::unique_ptr<Sample[]> samples_;
+  std::size_t capacity_ { 0u };
+
+  std::atomic<bool> active_ { false };
+  std::atomic<std::size_t> next_ { 0u };
+  std::atomic<std::size_t> dropped_ { 0u };
+  std::atomic<unsigned> in_handler_ { 0u };
+
+  // Время окончания в наносекундах steady_clock, читается обработчиком сигнала
+  std::atomic<std::int64_t> deadline_ { 0 };
+
+  bool handler_installed_ { false };
+};
+
+} // namespace profiler
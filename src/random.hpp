@@ -0,0 +1,74 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <limits>
+
+namespace util {
+
+// Шаг генератора SplitMix64. Используется для получения
+// начального состояния xoshiro и производных зерен из одного числа
+[[nodiscard]] constexpr std::uint64_t splitmix64(std::uint64_t& state) noexcept {
+  std::uint64_t z = (state += 0x9E37'79B9'7F4A'7C15u);
+
+  z = (z ^ (z >> 30)) * 0xBF58'476D'1CE4'E5B9u;
+  z = (z ^ (z >> 27)) * 0x94D0'49BB'1331'11EBu;
+
+  return z ^ (z >> 31);
+}
+
+// Зерно генератора игровой сессии, производное от общего зерна игры
+[[nodiscard]] constexpr std::uint64_t derive_seed(std::uint64_t seed, std::uint64_t stream) noexcept {
+  std::uint64_t state = seed ^ splitmix64(stream);
+  return splitmix64(state);
+}
+
+/**
+ * Генератор псевдослучайных чисел xoshiro256**.
+ * Удовлетворяет требованиям UniformRandomBitGenerator, поэтому используется
+ * со стандартными распределениями. Состояние занимает 32 байта и не требует
+ * обращения к системе, а одинаковое зерно даёт одинаковую последовательность
+ */
+class Xoshiro256 final {
+public:
+  using result_type = std::uint64_t;
+
+  explicit constexpr Xoshiro256(std::uint64_t seed) noexcept {
+    for (auto& s : state_) {
+      s = splitmix64(seed);
+    }
+  }
+
+  [[nodiscard]] static constexpr result_type min() noexcept {
+    return std::numeric_limits<result_type>::min();
+  }
+
+  [[nodiscard]] static constexpr result_type max() noexcept {
+    return std::numeric_limits<result_type>::max();
+  }
+
+  constexpr result_type operator()() noexcept {
+    const result_type result = rotl(state_[1] * 5, 7) * 9;
+    const result_type t = state_[1] << 17;
+
+    state_[2] ^= state_[0];
+    state_[3] ^= state_[1];
+    state_[1] ^= state_[2];
+    state_[0] ^= state_[3];
+
+    state_[2] ^= t;
+    state_[3] = rotl(state_[3], 45);
+
+    return result;
+  }
+
+private:
+  static constexpr result_type rotl(result_type x, int k) noexcept {
+    return (x << k) | (x >> (64 - k));
+  }
+
+private:
+  std::array<result_type, 4> state_ {};
+};
+
+} // namespace util
@@ -0,0 +1,220 @@
+#include "replay.hpp"
+
+#include <stdexcept>
+
+namespace replay {
+
+using namespace std::literals;
+
+namespace {
+
+using journal::put;
+using journal::put_string;
+using journal::get;
+using journal::get_string;
+
+constexpr std::uint32_t JOURNAL_MAGIC { 0x4A50'5247 }; // "GRPJ"
+constexpr std::uint16_t JOURNAL_VERSION { 3u };
+
+enum class EventType : std::uint8_t {
+  session_created = 1,
+  join,
+  move,
+  tick,
+  reconfigure
+};
+
+} // namespace
+
+Recorder::Recorder(const fs::path& file, bool randomize_spawn)
+  : file_(file, std::ios::binary | std::ios::trunc) {
+
+  if (!file_) {
+    throw std::runtime_error("Unable to open the replay journal"s);
+  }
+
+  buffer_.reserve(BUFFER_SIZE);
+  spare_.reserve(BUFFER_SIZE);
+
+  put(buffer_, JOURNAL_MAGIC);
+  put(buffer_, JOURNAL_VERSION);
+  put(buffer_, static_cast<std::uint8_t>(randomize_spawn));
+}
+
+Recorder::~Recorder() {
+  flush();
+}
+
+void Recorder::session_created(std::uint64_t session, std::uint64_t seed, std::string_view map_id) {
+  std::unique_lock lock(mutex_);
+
+  put(buffer_, EventType::session_created);
+  put(buffer_, session);
+  put(buffer_, seed);
+  put_string(buffer_, map_id);
+
+  write_if_full(lock);
+}
+
+void Recorder::join(std::uint64_t session, std::uint64_t character, std::string_view name) {
+  std::unique_lock lock(mutex_);
+
+  put(buffer_, EventType::join);
+  put(buffer_, session);
+  put(buffer_, character);
+  put_string(buffer_, name);
+
+  write_if_full(lock);
+}
+
+void Recorder::move(std::uint64_t session, std::uint64_t character, std::uint8_t direction) {
+  std::unique_lock lock(mutex_);
+
+  put(buffer_, EventType::move);
+  put(buffer_, session);
+  put(buffer_, character);
+  put(buffer_, direction);
+
+  write_if_full(lock);
+}
+
+void Recorder::tick(std::uint64_t session, std::int64_t delta, std::uint32_t spawned) {
+  std::unique_lock lock(mutex_);
+
+  put(buffer_, EventType::tick);
+  put(buffer_, session);
+  put(buffer_, delta);
+  put(buffer_, spawned);
+
+  write_if_full(lock);
+}
+
+void Recorder::reconfigure(const Reconfigure& event) {
+  std::unique_lock lock(mutex_);
+
+  put(buffer_, EventType::reconfigure);
+  put(buffer_, event.session);
+  put(buffer_, event.max_players);
+  put(buffer_, event.bag_capacity);
+  put(buffer_, event.speed);
+  put(buffer_, event.retirement_time);
+
+  write_if_full(lock);
+}
+
+void Recorder::flush() {
+  std::unique_lock lock(mutex_);
+  write(lock);
+}
+
+bool Recorder::good() const noexcept {
+  return good_.load();
+}
+
+void Recorder::write_if_full(std::unique_lock<std::mutex>& lock) {
+  if (buffer_.size() >= BUFFER_SIZE) {
+    write(lock);
+  }
+}
+
+void Recorder::write(std::unique_lock<std::mutex>& lock) {
+  if (buffer_.empty()) {
+    return;
+  }
+
+  std::lock_guard file_lock(file_mutex_);
+
+  // Запасной буфер пуст, но сохраняет выделенную память
+  spare_.swap(buffer_);
+  lock.unlock();
+
+  // Ошибка записи не должна прерывать тик сессии: 
+  // журнал просто перестаёт пополняться
+  if (file_) {
+    file_.write(spare_.data(), spare_.size());
+    file_.flush();
+  }
+
+  good_ = static_cast<bool>(file_);
+  spare_.clear();
+}
+
+Reader::Reader(const fs::path& file)
+  : file_(file, std::ios::binary) {
+
+  std::uint32_t magic;
+  std::uint16_t version;
+  std::uint8_t randomize_spawn;
+
+  if (!file_ || !get(file_, magic) || magic != JOURNAL_MAGIC) {
+    throw std::invalid_argument("Invalid replay journal"s);
+  }
+
+  if (!get(file_, version) || version != JOURNAL_VERSION || !get(file_, randomize_spawn)) {
+    throw std::invalid_argument("Unsupported replay journal version"s);
+  }
+
+  randomize_spawn_ = randomize_spawn != 0;
+}
+
+bool Reader::randomize_spawn() const noexcept {
+  return randomize_spawn_;
+}
+
+std::optional<Event> Reader::next() {
+  EventType type;
+
+  if (!get(file_, type)) {
+    return std::nullopt;
+  }
+
+  switch (type) {
+    case EventType::session_created : {
+      SessionCreated event;
+
+      if (get(file_, event.session) && get(file_, event.seed) && get_string(file_, event.map_id)) {
+        return event;
+      }
+
+      break;
+    } case EventType::join : {
+      Join event;
+
+      if (get(file_, event.session) && get(file_, event.character) && get_string(file_, event.name)) {
+        return event;
+      }
+
+      break;
+    } case EventType::move : {
+      Move event;
+
+      if (get(file_, event.session) && get(file_, event.character) && get(file_, event.direction)) {
+        return event;
+      }
+
+      break;
+    } case EventType::tick : {
+      Tick event;
+
+      if (get(file_, event.session) && get(file_, event.delta) && get(file_, event.spawned)) {
+        return event;
+      }
+
+      break;
+    } case EventType::reconfigure : {
+      Reconfigure event;
+
+      if (get(file_, event.session) && get(file_, event.max_players) && get(file_, event.bag_capacity)
+          && get(file_, event.speed) && get(file_, event.retirement_time)) {
+        return event;
+      }
+
+      break;
+    } default : 
+      throw std::runtime_error("Corrupted replay journal"s);
+  }
+
+  return std::nullopt;
+}
+
+} // namespace replay
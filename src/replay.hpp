@@ -0,0 +1,114 @@
+#pragma once
+
+#include "journal_codec.hpp"
+
+#include <atomic>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <variant>
+#include <vector>
+
+namespace replay {
+
+namespace fs = std::filesystem;
+
+/*
+ * Журнал входных данных игровых сессий.
+ *
+ * В журнал попадает всё, что влияет на состояние сессии: создание сессии
+ * с зерном генератора случайных чисел, вход персонажей, команды движения,
+ * длительности тиков, количество появившихся за тик трофеев и параметры
+ * сессии после перезагрузки конфигурации. События одной сессии записываются
+ * на её strand'е, поэтому их порядок в журнале совпадает с порядком применения.
+ *
+ * Формат файла:
+ *   заголовок { u32 magic, u16 version, u8 randomize_spawn }
+ *   события  { u8 type, поля события }
+ */
+
+using SessionCreated = journal::SessionCreated;
+
+struct Join {
+  std::uint64_t session;
+  std::uint64_t character;
+  std::string name;
+};
+
+using Move = journal::Move;
+
+struct Tick {
+  std::uint64_t session;
+  std::int64_t delta;
+  std::uint32_t spawned;
+};
+
+using Reconfigure = journal::Reconfigure;
+
+using Event = std::variant<SessionCreated, Join, Move, Tick, Reconfigure>;
+
+// Пишет события в файл через буфер, который сбрасывается на диск
+// при заполнении и при уничтожении объекта. Методы потокобезопасны.
+// Заполненный буфер меняется местами с запасным, и запись на диск идёт
+// без блокировки, которую берут strand'ы сессий.
+// После ошибки записи события отбрасываются, good() возвращает false
+class Recorder final {
+public:
+  constexpr static std::size_t BUFFER_SIZE { 64u * 1024u };
+
+  Recorder(const fs::path& file, bool randomize_spawn);
+  ~Recorder();
+
+  Recorder(const Recorder&) = delete;
+  Recorder& operator=(const Recorder&) = delete;
+
+  void session_created(std::uint64_t session, std::uint64_t seed, std::string_view map_id);
+  void join(std::uint64_t session, std::uint64_t character, std::string_view name);
+  void move(std::uint64_t session, std::uint64_t character, std::uint8_t direction);
+  void tick(std::uint64_t session, std::int64_t delta, std::uint32_t spawned);
+  void reconfigure(const Reconfigure& event);
+
+  void flush();
+
+  [[nodiscard]] bool good() const noexcept;
+
+private:
+  void write_if_full(std::unique_lock<std::mutex>& lock);
+  // Записывает буфер в файл, отпуская lock на время записи
+  void write(std::unique_lock<std::mutex>& lock);
+
+private:
+  // Защищает buffer_
+  std::mutex mutex_;
+  // Защищает file_ и spare_. Берётся до освобождения mutex_, 
+  // поэтому буферы попадают в файл в порядке заполнения
+  std::mutex file_mutex_;
+
+  std::ofstream file_;
+  std::vector<char> buffer_;
+  std::vector<char> spare_;
+
+  std::atomic<bool> good_ { true };
+};
+
+// Последовательно читает события журнала
+class Reader final {
+public:
+  explicit Reader(const fs::path& file);
+
+  [[nodiscard]] bool randomize_spawn() const noexcept;
+
+  // Возвращает std::nullopt по достижении конца журнала. Событие,
+  // запись которого была прервана, считается концом журнала
+  [[nodiscard]] std::optional<Event> next();
+
+private:
+  std::ifstream file_;
+  bool randomize_spawn_ { false };
+};
+
+} // namespace replay
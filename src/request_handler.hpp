@@ -3,6 +3,8 @@
 #include "listener.hpp"
 #include "mux.hpp"
 #include "logger.hpp"
+#include "player.hpp"
+#include "tracing.hpp"
 
 #include <chrono>
 
@@ -26,80 +28,94 @@ public:
   RequestHandler(const RequestHandler&) = delete;
   RequestHandler& operator=(const RequestHandler&) = delete;
 
+  // span отмечает этапы обработки запроса и должен существовать до вызова send
   template <typename Body, typename Allocator, typename Send>
-  http_response_t operator()(http_request_t<Body, Allocator>&& req, Send&& send) { 
+  void operator()(http_request_t<Body, Allocator>&& req, tracing::Span& span, Send&& send) { 
     if (req.target().starts_with("/api/"sv))
-      return handle_api_request(std::move(req), std::forward<decltype(send)>(send));
+      return handle_api_request(std::move(req), span, std::forward<decltype(send)>(send));
 
-    return handle_file_request(std::move(req), std::forward<decltype(send)>(send));
+    return handle_file_request(std::move(req), span, std::forward<decltype(send)>(send));
   }
 
 private:
   http_string_response_t handle_error(std::exception_ptr eptr, std::string_view where, 
                                       unsigned ver, bool keep_alive) const;
 
+  // Запросы конкретного игрока выполняются на strand'е его игровой сессии,
+  // все остальные API-запросы - на общем api_strand_
+  template <typename Body, typename Allocator>
+  Strand select_strand(const http_request_t<Body, Allocator>& req, const mux::RouteMatch& match) const {
+    if (!match.session_bound) {
+      return api_strand_;
+    }
+
+    const auto it = req.base().find(http::field::authorization);
+
+    if ((it == req.base().cend()) || !it->value().starts_with("Bearer "sv)) {
+      return api_strand_;
+    }
+
+    if (auto strand = app::Players::instance().find_session_strand(app::extract_token(it->value()))) {
+      return *strand;
+    }
+
+    return api_strand_;
+  }
+
   template <typename Body, typename Allocator, typename Send>
-  http_response_t handle_api_request(http_request_t<Body, Allocator>&& req, Send&& send) {
+  void handle_api_request(http_request_t<Body, Allocator>&& req, tracing::Span& span, Send&& send) {
     auto match = router_.process(req);
+    span.mark(tracing::Stage::routed);
     
     if (match.error == mux::MatchError::NotFound && !match.handler) {
-      auto resp = response::make(response::BadRequest<ct::app_json>(req.version(), req.keep_alive())
-        .add_body(response::basic_json_body::bad_request()));
-
-      http_response_t saved_response = resp;
-      send(std::move(resp));
-
-      return saved_response;
+      return send(response::make(response::BadRequest<ct::app_json>(req.version(), req.keep_alive())
+        .add_body(response::basic_json_body::bad_request())));
     }
 
-    return std::visit([self = shared_from_this(), &req, send = std::forward<decltype(send)>(send)](auto&& response) {
-      http_response_t saved_response = static_cast<http_string_response_t>(response);
-      
-      try {            
-        auto handle = [self, &req, send = std::forward<decltype(send)>(send), &response, &saved_response] {
-          try {
-            assert(self->api_strand_.running_in_this_thread());
-            send(std::forward<decltype(response)>(response));
-          } catch (...) {
-            auto err_resp = self->handle_error(std::current_exception(), __FUNCTION__, req.version(), req.keep_alive());
-            saved_response = err_resp;
-    
-            send(std::move(err_resp)); 
-          }
-        };
+    const auto strand = select_strand(req, match);
 
-        http_server::net::dispatch(self->api_strand_, handle);
-      } catch (...) {
-        auto err_resp = self->handle_error(std::current_exception(), __FUNCTION__, req.version(), req.keep_alive());
-        saved_response = err_resp;
+    http_server::net::dispatch(strand, 
+      [self = shared_from_this(), strand, handler = match.handler, req = std::move(req), span = &span, send = std::forward<decltype(send)>(send)]() mutable {
+        assert(strand.running_in_this_thread());
+        span->mark(tracing::Stage::strand);
 
-        send(std::move(err_resp)); 
-      }
+        const auto version = req.version();
+        const auto keep_alive = req.keep_alive();
 
-      return saved_response;
-    }, 
-    (*match.handler)(std::move(req))); 
+        try {
+          std::visit([&send, span](auto&& response) {
+            span->mark(tracing::Stage::handled);
+            send(std::forward<decltype(response)>(response));
+          }, 
+          (*handler)(std::move(req)));
+        } catch (...) {
+          span->mark(tracing::Stage::handled);
+          send(self->handle_error(std::current_exception(), __FUNCTION__, version, keep_alive)); 
+        }
+      });
   }
 
   template <typename Body, typename Allocator, typename Send>
-  http_response_t handle_file_request(http_request_t<Body, Allocator>&& req, Send&& send) {  
+  void handle_file_request(http_request_t<Body, Allocator>&& req, tracing::Span& span, Send&& send) {  
     auto match = router_.process(req);
-    
-    return std::visit([self = shared_from_this(), req, send = std::forward<decltype(send)>(send)](auto&& response) {
-      http_response_t saved_response = static_cast<http_string_response_t>(response);
-      
-      try {            
-        send(std::forward<decltype(response)>(response));
-      } catch (...) {
-        auto err_resp = self->handle_error(std::current_exception(), __FUNCTION__, req.version(), req.keep_alive());
-        saved_response = err_resp;
 
-        send(std::move(err_resp)); 
-      }
+    // Файлы отдаются без перехода на strand
+    span.mark(tracing::Stage::routed);
+    span.mark(tracing::Stage::strand);
 
-      return saved_response;
-    }, 
-    (*match.handler)(std::move(req)));
+    const auto version = req.version();
+    const auto keep_alive = req.keep_alive();
+    
+    try {            
+      std::visit([&send, &span](auto&& response) {
+        span.mark(tracing::Stage::handled);
+        send(std::forward<decltype(response)>(response));
+      }, 
+      (*match.handler)(std::move(req)));
+    } catch (...) {
+      span.mark(tracing::Stage::handled);
+      send(handle_error(std::current_exception(), __FUNCTION__, version, keep_alive)); 
+    }
   }
 
 private:
@@ -114,18 +130,20 @@ public:
     : handler_(std::move(handler)) {
   }
 
+  // Ответ может быть сформирован асинхронно на strand'е игровой сессии,
+  // поэтому он логируется по завершении записи: время ответа включает
+  // отправку, а в журнал попадают только метаданные ответа
   template <typename Body, typename Allocator, typename Send>
-  void operator()(http_server::tcp::endpoint remote_endpoint, http_request_t<Body, Allocator>&& req, Send&& send) {
+  void operator()(http_server::tcp::endpoint remote_endpoint, http_request_t<Body, Allocator>&& req, tracing::Span& span, Send&& send) {
     LOG_REQUEST(remote_endpoint.address().to_string(), req.target(), req.method_string())
 
-    const auto request_time  = steady_clock::now(); 
-    const auto response = handler_(std::move(req), std::forward<decltype(send)>(send));
-    const auto response_time = duration_cast<milliseconds>(steady_clock::now() - request_time);
-
-    return std::visit([&response_time](auto&& response) {
-      LOG_RESPONSE(response_time.count(), response.result_int(), response[http::field::content_type])
-    }, 
-    response);   
+    handler_(std::move(req), span, 
+      [send = std::forward<decltype(send)>(send), request_time = steady_clock::now()](auto&& response) {
+        send(std::forward<decltype(response)>(response), [request_time](const http_server::ResponseInfo& info) {
+          const auto response_time = duration_cast<milliseconds>(steady_clock::now() - request_time);
+          LOG_RESPONSE(response_time.count(), info.status, info.content_type, info.body_size)
+        });
+      });
   }
 
 private:
@@ -4,47 +4,29 @@
 namespace response {
 
 BadRequestBase::BadRequestBase(const unsigned ver, bool keep_alive, ct::Type content_type)
-  : ResponseFields(ver, keep_alive) {
-  
-  status_ = http::status::bad_request;
-  http_fields_[http::field::content_type] = std::move(ct::get_as_text(content_type));
+  : ResponseFields(ver, keep_alive, { http::status::bad_request, content_type }) {
 } 
 
 InternalServerErrorBase::InternalServerErrorBase(const unsigned ver, bool keep_alive, ct::Type content_type)
-  : ResponseFields(ver, keep_alive) {
-  
-  status_ = http::status::internal_server_error;
-  http_fields_[http::field::content_type] = std::move(ct::get_as_text(content_type));
+  : ResponseFields(ver, keep_alive, { http::status::internal_server_error, content_type }) {
 }
 
-MethodNotAllowedBase::MethodNotAllowedBase(const unsigned ver, bool keep_alive, ct::Type content_type, std::string_view allowed)
-  : ResponseFields(ver, keep_alive) {
-  
-  status_ = http::status::method_not_allowed;
+MethodNotAllowedBase::MethodNotAllowedBase(const unsigned ver, bool keep_alive, ct::Type content_type, http_methods::AllowedMethod allowed)
+  : ResponseFields(ver, keep_alive, { http::status::method_not_allowed, content_type }) {
 
-  http_fields_[http::field::allow] = std::move(allowed);
-  http_fields_[http::field::content_type] = std::move(ct::get_as_text(content_type));
+  allow_ = allowed.as_string_view();
 }
 
 NotFoundBase::NotFoundBase(const unsigned ver, bool keep_alive, ct::Type content_type)
-  : ResponseFields(ver, keep_alive) {
-  
-  status_ = http::status::not_found;
-  http_fields_[http::field::content_type] = std::move(ct::get_as_text(content_type));
+  : ResponseFields(ver, keep_alive, { http::status::not_found, content_type }) {
 }
 
 UnauthorizedBase::UnauthorizedBase(const unsigned ver, bool keep_alive, ct::Type content_type)
-  : ResponseFields(ver, keep_alive) {
-  
-  status_ = http::status::unauthorized;
-  http_fields_[http::field::content_type] = std::move(ct::get_as_text(content_type));
+  : ResponseFields(ver, keep_alive, { http::status::unauthorized, content_type }) {
 }
 
 MapInfo::MapInfo(const unsigned ver, bool keep_alive, const model::Game& game, std::string_view id)
-  : ResponseFields(ver, keep_alive) {
-  
-  status_ = http::status::ok;
-  http_fields_[http::field::content_type] = std::move(ct::get_as_text(ct::app_json));
+  : ResponseFields(ver, keep_alive, templates::json) {
 
   body_ = std::move(get_map_info(game, id));
 }
@@ -117,10 +99,7 @@ std::string MapInfo::get_map_info(const model::Game& game, std::string_view id)
 }
 
 MapsShortList::MapsShortList(const unsigned ver, bool keep_alive, const model::Game& game)
-  : ResponseFields(ver, keep_alive) {
-  
-  status_ = http::status::ok;
-  http_fields_[http::field::content_type] = std::move(ct::get_as_text(ct::app_json));
+  : ResponseFields(ver, keep_alive, templates::json) {
 
   body_ = std::move(get_map_list(game));
 }  
@@ -142,12 +121,7 @@ std::string MapsShortList::get_map_list(const model::Game& game) const {
 }
 
 File::File(const unsigned ver, bool keep_alive, std::filesystem::path file_path)
-  : ResponseFields(ver, keep_alive) {
-  
-  status_ = http::status::ok;
-
-  std::string ext(file_path.extension());
-  http_fields_[http::field::content_type] = std::move(ct::get_as_text(ct::get_ext_as_type(std::move(ext))));
+  : ResponseFields(ver, keep_alive, { http::status::ok, ct::get_ext_as_type(file_path.extension().native()) }) {
 
   http::file_body::value_type value;
   boost::system::error_code ec;
@@ -161,12 +135,7 @@ File::File(const unsigned ver, bool keep_alive, std::filesystem::path file_path)
 } 
 
 SuccessJoin::SuccessJoin(const unsigned ver, bool keep_alive, std::string_view token, model::Character::Id id)
-  : ResponseFields(ver, keep_alive) {
-  
-  status_ = http::status::ok;
-
-  http_fields_[http::field::content_type] = std::move(ct::get_as_text(ct::app_json));
-  http_fields_[http::field::cache_control] = "no-cache"sv;
+  : ResponseFields(ver, keep_alive, templates::json_no_cache) {
 
   body_ = json::serialize(json::object{
     { "authToken"sv, std::move(token) },
@@ -175,12 +144,7 @@ SuccessJoin::SuccessJoin(const unsigned ver, bool keep_alive, std::string_view t
 }
 
 PlayersList::PlayersList(const unsigned ver, bool keep_alive, const model::GameSession::Characters& characters)
-  : ResponseFields(ver, keep_alive) {
-  
-  status_ = http::status::ok;
-
-  http_fields_[http::field::content_type] = std::move(ct::get_as_text(ct::app_json));
-  http_fields_[http::field::cache_control] = "no-cache"sv;
+  : ResponseFields(ver, keep_alive, templates::json_no_cache) {
 
   json::object obj;
   
@@ -192,12 +156,7 @@ PlayersList::PlayersList(const unsigned ver, bool keep_alive, const model::GameS
 }
 
 GameState::GameState(const unsigned ver, bool keep_alive, const model::GameSession& game_session)
-  : ResponseFields(ver, keep_alive) {
-  
-  status_ = http::status::ok;
-
-  http_fields_[http::field::content_type] = std::move(ct::get_as_text(ct::app_json));
-  http_fields_[http::field::cache_control] = "no-cache"sv;
+  : ResponseFields(ver, keep_alive, templates::json_no_cache) {
 
   json::object players;
 
@@ -220,8 +179,8 @@ GameState::GameState(const unsigned ver, bool keep_alive, const model::GameSessi
 
     for (const auto& loot : ch->bagpack.get()) {
       bag.emplace_back(json::object {
-        {"id", loot.first}, 
-        {"type", loot.second->type()}
+        {"id", loot.id}, 
+        {"type", loot.type}
       });
     }
 
@@ -233,19 +192,19 @@ GameState::GameState(const unsigned ver, bool keep_alive, const model::GameSessi
 
   json::object lost_objects; 
 
-  for (const auto& [id, loot] : game_session.lost_objects()) {
+  game_session.lost_objects().for_each([&lost_objects](model::LootPool::Handle, const model::Loot& loot) {
     json::array pos;
 
-    pos.push_back(loot->position().x);
-    pos.push_back(loot->position().y);
+    pos.push_back(loot.position.x);
+    pos.push_back(loot.position.y);
 
     json::object loot_info;
 
-    loot_info["type"] = loot->type();    
+    loot_info["type"] = loot.type;    
     loot_info["pos"] = std::move(pos);
     
-    lost_objects[std::to_string(id)] = std::move(loot_info);
-  }
+    lost_objects[std::to_string(loot.id)] = std::move(loot_info);
+  });
 
   body_ = json::serialize(json::object {
     {"players"sv, std::move(players)},
@@ -253,26 +212,249 @@ GameState::GameState(const unsigned ver, bool keep_alive, const model::GameSessi
   });
 } 
 
+Records::Records(const unsigned ver, bool keep_alive, const std::vector<leaderboard::Record>& records)
+  : ResponseFields(ver, keep_alive, templates::json_no_cache) {
+
+  json::array arr;
+  arr.reserve(records.size());
+
+  for (const auto& record : records) {
+    arr.push_back(json::object {
+      {"name"sv, record.name},
+      {"score"sv, record.score},
+      {"playTime"sv, std::chrono::duration<double>(record.play_time).count()}
+    });
+  }
+
+  body_ = json::serialize(arr);
+}
+
+PlacementStats::PlacementStats(const unsigned ver, bool keep_alive, const model::GameSessionManager::PlacementStats& stats)
+  : ResponseFields(ver, keep_alive, templates::json_no_cache) {
+
+  json::object maps;
+
+  for (const auto& [id, map_stats] : stats.maps) {
+    maps[*id] = json::object {
+      {"sessions"sv, map_stats.sessions},
+      {"players"sv, map_stats.players}
+    };
+  }
+
+  body_ = json::serialize(json::object {
+    {"sessions"sv, stats.sessions},
+    {"players"sv, stats.players},
+    {"placements"sv, stats.placements},
+    {"sessionsCreated"sv, stats.sessions_created},
+    {"sessionsReclaimed"sv, stats.sessions_reclaimed},
+    {"maps"sv, std::move(maps)}
+  });
+}
+
+AdmissionStats::AdmissionStats(const unsigned ver, bool keep_alive, const admission::Controller::Stats& stats)
+  : ResponseFields(ver, keep_alive, templates::json_no_cache) {
+
+  body_ = json::serialize(json::object {
+    {"connections"sv, stats.connections},
+    {"addresses"sv, stats.addresses},
+    {"accepted"sv, stats.accepted},
+    {"rejectedBusy"sv, stats.rejected_busy},
+    {"rejectedPerIp"sv, stats.rejected_per_ip},
+    {"rejectedRequests"sv, stats.rejected_requests}
+  });
+}
+
+TraceStats::TraceStats(const unsigned ver, bool keep_alive, const tracing::Tracer::Stats& stats)
+  : ResponseFields(ver, keep_alive, templates::json_no_cache) {
+
+  const auto to_us = [](std::chrono::nanoseconds ns) {
+    return std::chrono::duration<double, std::micro>(ns).count();
+  };
+
+  json::array bounds;
+  bounds.reserve(tracing::Histogram::BUCKETS);
+
+  for (std::size_t i = 0; i < tracing::Histogram::BUCKETS; ++i) {
+    bounds.push_back(tracing::Histogram::upper_bound(i).count());
+  }
+
+  json::object stages;
+
+  for (std::size_t i = 0; i < tracing::INTERVALS; ++i) {
+    const auto& histogram = stats.intervals[i];
+
+    json::array buckets;
+    buckets.reserve(histogram.buckets.size());
+
+    for (const auto count : histogram.buckets) {
+      buckets.push_back(count);
+    }
+
+    stages[tracing::interval_name(static_cast<tracing::Interval>(i))] = json::object {
+      {"count"sv, histogram.count},
+      {"meanUs"sv, to_us(histogram.mean())},
+      {"p50Us"sv, histogram.percentile(0.5).count()},
+      {"p90Us"sv, histogram.percentile(0.9).count()},
+      {"p99Us"sv, histogram.percentile(0.99).count()},
+      {"histogram"sv, std::move(buckets)}
+    };
+  }
+
+  body_ = json::serialize(json::object {
+    {"enabled"sv, stats.enabled},
+    {"requests"sv, stats.requests},
+    {"bucketUpperBoundsUs"sv, std::move(bounds)},
+    {"stages"sv, std::move(stages)}
+  });
+}
+
+TraceEvents::TraceEvents(const unsigned ver, bool keep_alive, const std::vector<tracing::Record>& records)
+  : ResponseFields(ver, keep_alive, templates::json_no_cache) {
+
+  const auto to_us = [](std::int64_t ns) {
+    return static_cast<double>(ns) / 1000.0;
+  };
+
+  json::array events;
+  events.reserve(records.size() * tracing::INTERVALS);
+
+  // Каждый запрос выводится отдельной дорожкой: событие всего запроса и вложенные в него этапы
+  for (const auto& record : records) {
+    const auto start = record.stamps[static_cast<std::size_t>(tracing::Stage::read)];
+    const auto total = record.duration(tracing::Interval::total);
+
+    if (!start || total < 0ns) {
+      continue;
+    }
+
+    events.push_back(json::object {
+      {"name"sv, record.target_view()},
+      {"cat"sv, "request"sv},
+      {"ph"sv, "X"sv},
+      {"ts"sv, to_us(start)},
+      {"dur"sv, to_us(total.count())},
+      {"pid"sv, 1},
+      {"tid"sv, record.id},
+      {"args"sv, json::object {{"status"sv, record.status}}}
+    });
+
+    for (std::size_t i = 0; i + 1 < tracing::INTERVALS; ++i) {
+      const auto interval = static_cast<tracing::Interval>(i);
+      const auto duration = record.duration(interval);
+
+      if (duration < 0ns) {
+        continue;
+      }
+
+      events.push_back(json::object {
+        {"name"sv, tracing::interval_name(interval)},
+        {"cat"sv, "stage"sv},
+        {"ph"sv, "X"sv},
+        {"ts"sv, to_us(record.started(interval))},
+        {"dur"sv, to_us(duration.count())},
+        {"pid"sv, 1},
+        {"tid"sv, record.id}
+      });
+    }
+  }
+
+  body_ = json::serialize(json::object {
+    {"traceEvents"sv, std::move(events)},
+    {"displayTimeUnit"sv, "ms"sv}
+  });
+}
+
+ProfileStatus::ProfileStatus(const unsigned ver, bool keep_alive, const profiler::Profiler::Status& status)
+  : ResponseFields(ver, keep_alive, templates::json_no_cache) {
+
+  const auto state = [&status] {
+    switch (status.state) {
+      case profiler::Profiler::State::running  : return "running"sv;
+      case profiler::Profiler::State::finished : return "finished"sv;
+      default                                  : return "idle"sv;
+    }
+  }();
+
+  body_ = json::serialize(json::object {
+    {"state"sv, state},
+    {"samples"sv, status.samples},
+    {"dropped"sv, status.dropped},
+    {"remainingMs"sv, status.remaining.count()}
+  });
+}
+
+FoldedStacks::FoldedStacks(const unsigned ver, bool keep_alive, std::string&& stacks)
+  : ResponseFields(ver, keep_alive, { http::status::ok, ct::text_plain, CachePolicy::no_cache }) {
+
+  body_ = std::move(stacks);
+}
+
+GameParameters::GameParameters(const unsigned ver, bool keep_alive, const model::Game::Maps& maps, 
+                               const model::GameConfig& cfg, bool pending)
+  : ResponseFields(ver, keep_alive, templates::json_no_cache) {
+
+  const auto seconds = [](std::chrono::milliseconds ms) {
+    return std::chrono::duration<double>(ms).count();
+  };
+
+  json::array maps_arr;
+  maps_arr.reserve(maps.size());
+
+  for (const auto& map : maps) {
+    json::object obj {{"id"sv, *map.get_id()}};
+
+    if (const auto it = cfg.map_character_speed.find(map.get_id()); it != cfg.map_character_speed.cend()) {
+      obj["dogSpeed"sv] = it->second;
+    }
+
+    if (const auto it = cfg.map_bag_capacity.find(map.get_id()); it != cfg.map_bag_capacity.cend()) {
+      obj["bagCapacity"sv] = it->second;
+    }
+
+    if (const auto it = cfg.map_max_players.find(map.get_id()); it != cfg.map_max_players.cend()) {
+      obj["maxPlayers"sv] = it->second;
+    }
+
+    maps_arr.push_back(std::move(obj));
+  }
+
+  body_ = json::serialize(json::object {
+    {"pending"sv, pending},
+    {"sessionIdleTimeout"sv, seconds(cfg.session_idle_timeout)},
+    {"dogRetirementTime"sv, seconds(cfg.retirement_time)},
+    {"lootGeneratorConfig"sv, json::object {
+      {"period"sv, seconds(cfg.loot_generator.period)},
+      {"probability"sv, cfg.loot_generator.probability}
+    }},
+    {"maps"sv, std::move(maps_arr)}
+  });
+}
+
+Accepted::Accepted(const unsigned ver, bool keep_alive)
+  : ResponseFields(ver, keep_alive, { http::status::accepted, ct::app_json, CachePolicy::no_cache }) {
+
+  body_ = basic_json_body::empty_object;
+}
+
 MovePlayer::MovePlayer(const unsigned ver, bool keep_alive)
-  : ResponseFields(ver, keep_alive) {
-  
-  status_ = http::status::ok;
+  : ResponseFields(ver, keep_alive, templates::json_no_cache) {
 
-  http_fields_[http::field::content_type] = std::move(ct::get_as_text(ct::app_json));
-  http_fields_[http::field::cache_control] = "no-cache"sv;
+  body_ = basic_json_body::empty_object;
+}
+
+ActionsBatch::ActionsBatch(const unsigned ver, bool keep_alive, std::size_t accepted, std::size_t unknown)
+  : ResponseFields(ver, keep_alive, templates::json_no_cache) {
 
-  body_ = json::serialize(json::object{});
+  body_ = json::serialize(json::object {
+    {"accepted"sv, accepted},
+    {"unknownTokens"sv, unknown}
+  });
 }
 
 UpdatePlayersPositions::UpdatePlayersPositions(const unsigned ver, bool keep_alive)
-  : ResponseFields(ver, keep_alive) {
-  
-  status_ = http::status::ok;
-
-  http_fields_[http::field::content_type] = std::move(ct::get_as_text(ct::app_json));
-  http_fields_[http::field::cache_control] = "no-cache"sv;
+  : ResponseFields(ver, keep_alive, templates::json_no_cache) {
 
-  body_ = json::serialize(json::object{});
+  body_ = basic_json_body::empty_object;
 } 
 
 } // namespace response
\ No newline at end of file
@@ -3,7 +3,10 @@
 #include "game.hpp"
 #include "common_http.hpp"
 #include "content_type.hpp"
+#include "http_methods.hpp"
 #include "config.hpp"
+#include "tracing.hpp"
+#include "profiler.hpp"
 
 #include <string>
 #include <filesystem>
@@ -19,6 +22,9 @@ using namespace std::literals;
 
 namespace basic_json_body {
 
+// Тело ответов, не возвращающих данных
+inline constexpr std::string_view empty_object = "{}"sv;
+
 inline std::string bad_response(std::string_view code, std::string_view message) {
   const auto ans = json::serialize(json::object{
     {"code"sv, std::move(code)}, 
@@ -55,11 +61,31 @@ inline std::string header_missing(std::string_view message) {
 
 } // namespace basic_json_body 
 
+// Политика кеширования ответа
+enum class CachePolicy : std::uint8_t {
+  none,
+  no_cache
+};
+
+// Шаблон заголовков, общий для ответов одного вида. Все значения
+// заголовков берутся из статических таблиц, поэтому ответ по шаблону
+// собирается без выделения памяти под строки заголовков
+struct Head {
+  http::status status { http::status::ok };
+  ct::Type content_type { ct::text_plain };
+  CachePolicy cache { CachePolicy::none };
+};
+
+namespace templates {
+
+inline constexpr Head json { http::status::ok, ct::app_json, CachePolicy::none };
+inline constexpr Head json_no_cache { http::status::ok, ct::app_json, CachePolicy::no_cache };
+
+} // namespace templates
+
 template <typename BodyType = http::string_body::value_type>
 class ResponseFields {
 public:
-  using HttpFields = std::unordered_map<http::field, std::string>;
-  
   ResponseFields() = default;
 
   ResponseFields(ResponseFields&&) = default;
@@ -68,13 +94,14 @@ public:
   ResponseFields& operator=(ResponseFields&&) = default;
   ResponseFields& operator=(const ResponseFields&) = default;
 
-  explicit ResponseFields(const unsigned ver, bool keep_alive)
-    : version_(ver)
-    , keep_alive_(keep_alive) {
+  explicit ResponseFields(const unsigned ver, bool keep_alive, const Head& head = {})
+    : keep_alive_(keep_alive)
+    , version_(ver)
+    , head_(head) {
   }
 
-  ResponseFields& add_field(http::field field, std::string_view value) {
-    http_fields_.try_emplace(field, std::string(value));
+  ResponseFields& cache(CachePolicy cache) noexcept {
+    head_.cache = cache;
     return *this;
   }
 
@@ -83,8 +110,13 @@ public:
     return *this;
   }
 
-  const HttpFields& http_fields() const noexcept {
-    return http_fields_;
+  const Head& head() const noexcept {
+    return head_;
+  }
+
+  // Значение заголовка Allow, пустое для остальных ответов
+  std::string_view allow() const noexcept {
+    return allow_;
   }
 
   const BodyType& body() const noexcept {
@@ -100,7 +132,7 @@ public:
   }
 
   http::status http_status() const noexcept {
-    return status_;
+    return head_.status;
   }
 
   unsigned http_version() const noexcept {
@@ -110,13 +142,13 @@ public:
   virtual ~ResponseFields() = default;
 
 protected:
-  bool keep_alive_;
-  
-  http::status status_;
-  unsigned version_;
+  bool keep_alive_ { false };
+  unsigned version_ { 11u };
+
+  Head head_;
+  std::string_view allow_;
 
   BodyType body_;
-  HttpFields http_fields_;
 };
 
 // Bad responses
@@ -175,7 +207,7 @@ struct InternalServerError<ct::app_json> final : public InternalServerErrorBase
 
 struct MethodNotAllowedBase : public ResponseFields<> {
   MethodNotAllowedBase() = delete;
-  explicit MethodNotAllowedBase(const unsigned ver, bool keep_alive, ct::Type content_type, std::string_view allowed);
+  explicit MethodNotAllowedBase(const unsigned ver, bool keep_alive, ct::Type content_type, http_methods::AllowedMethod allowed);
 };
 
 template <ct::Type T>
@@ -185,8 +217,8 @@ struct MethodNotAllowed final : public MethodNotAllowedBase {
 
 template <>
 struct MethodNotAllowed<ct::text_plain> final : public MethodNotAllowedBase {
-  explicit MethodNotAllowed(const unsigned ver, bool keep_alive, std::string_view allowed_methods, std::string_view msg = "Invalid method"sv) 
-    : MethodNotAllowedBase(ver, keep_alive, ct::text_plain, std::move(allowed_methods)) {
+  explicit MethodNotAllowed(const unsigned ver, bool keep_alive, http_methods::AllowedMethod allowed_methods, std::string_view msg = "Invalid method"sv) 
+    : MethodNotAllowedBase(ver, keep_alive, ct::text_plain, allowed_methods) {
 
     body_ = std::move(msg);
   } 
@@ -194,8 +226,8 @@ struct MethodNotAllowed<ct::text_plain> final : public MethodNotAllowedBase {
 
 template <>
 struct MethodNotAllowed<ct::app_json> final : public MethodNotAllowedBase {
-  explicit MethodNotAllowed(const unsigned ver, bool keep_alive, std::string_view allowed_methods)
-    : MethodNotAllowedBase(ver, keep_alive, ct::app_json, std::move(allowed_methods)) {
+  explicit MethodNotAllowed(const unsigned ver, bool keep_alive, http_methods::AllowedMethod allowed_methods)
+    : MethodNotAllowedBase(ver, keep_alive, ct::app_json, allowed_methods) {
   } 
 };
 
@@ -284,10 +316,54 @@ struct GameState final : public ResponseFields<> {
   explicit GameState(const unsigned ver, bool keep_alive, const model::GameSession& game_session);
 };
 
+struct Records final : public ResponseFields<> {
+  explicit Records(const unsigned ver, bool keep_alive, const std::vector<leaderboard::Record>& records);
+};
+
+struct PlacementStats final : public ResponseFields<> {
+  explicit PlacementStats(const unsigned ver, bool keep_alive, const model::GameSessionManager::PlacementStats& stats);
+};
+
+struct AdmissionStats final : public ResponseFields<> {
+  explicit AdmissionStats(const unsigned ver, bool keep_alive, const admission::Controller::Stats& stats);
+};
+
+struct TraceStats final : public ResponseFields<> {
+  explicit TraceStats(const unsigned ver, bool keep_alive, const tracing::Tracer::Stats& stats);
+};
+
+struct TraceEvents final : public ResponseFields<> {
+  explicit TraceEvents(const unsigned ver, bool keep_alive, const std::vector<tracing::Record>& records);
+};
+
+struct ProfileStatus final : public ResponseFields<> {
+  explicit ProfileStatus(const unsigned ver, bool keep_alive, const profiler::Profiler::Status& status);
+};
+
+struct FoldedStacks final : public ResponseFields<> {
+  explicit FoldedStacks(const unsigned ver, bool keep_alive, std::string&& stacks);
+};
+
+// Параметры игры в формате конфигурационного файла. pending - параметры
+// ещё не применены и вступят в силу на границе следующего тика
+struct GameParameters final : public ResponseFields<> {
+  explicit GameParameters(const unsigned ver, bool keep_alive, const model::Game::Maps& maps, 
+                          const model::GameConfig& cfg, bool pending);
+};
+
+// Запрос принят, а результат его выполнения в ответ не входит
+struct Accepted final : public ResponseFields<> {
+  explicit Accepted(const unsigned ver, bool keep_alive);
+};
+
 struct MovePlayer final : public ResponseFields<> {
   explicit MovePlayer(const unsigned ver, bool keep_alive);
 };
 
+struct ActionsBatch final : public ResponseFields<> {
+  explicit ActionsBatch(const unsigned ver, bool keep_alive, std::size_t accepted, std::size_t unknown);
+};
+
 struct UpdatePlayersPositions final : public ResponseFields<> {
   explicit UpdatePlayersPositions(const unsigned ver, bool keep_alive); 
 };
@@ -298,9 +374,17 @@ inline ResponseType make_basic_response(ResponseFields<BodyType>&& fields) {
 
   response.body() = std::move(fields.body());
   response.keep_alive(fields.keep_alive());
-  
-  for (const auto& [field, value] : fields.http_fields()) {
-    response.set(field, value);
+
+  const auto& head = fields.head();
+
+  response.set(http::field::content_type, ct::get_as_text(head.content_type));
+
+  if (head.cache == CachePolicy::no_cache) {
+    response.set(http::field::cache_control, "no-cache"sv);
+  }
+
+  if (!fields.allow().empty()) {
+    response.set(http::field::allow, fields.allow());
   }
 
   return response; 
@@ -2,6 +2,8 @@
 
 namespace serialization {
 
+using namespace std::literals;
+
 void CharacterSerializer::serialize(InputArchive& ar, unsigned) {
   ar & name_;
   ar & pos_;
@@ -44,34 +46,116 @@ const model::Bagpack& CharacterSerializer::bagpack() const noexcept {
   return bagpack_;
 }
 
-void LootSerializer::serialize(InputArchive& ar, unsigned) {
-  ar & name_;
-  ar & pos_;
-  ar & type_;
-  ar & value_;
+std::shared_ptr<model::Character> DogSerializer::restore() const {
+  auto dog = model::create_character<model::Dog>(name_, bagpack_.capacity());
+
+  dog->position(pos_);
+  dog->speed(speed_);
+  dog->direction(direction_);
+  dog->add_points(points_);
+
+  for (const auto& loot : bagpack_.get()) {
+    dog->bagpack.add(loot);
+  }
+
+  return dog;
 }
 
-void LootSerializer::serialize(OutputArchive& ar, unsigned) {
-  ar & name_;
-  ar & pos_;
-  ar & type_;
-  ar & value_;
+SessionSerializer::SessionSerializer(const model::GameSession& session, std::uint64_t journal_seq)
+  : id_(session.id())
+  , map_id_(*session.map().get_id())
+  , seed_(session.seed())
+  , next_character_id_(session.next_character_id())
+  , next_loot_id_(session.next_loot_id())
+  , journal_seq_(journal_seq) {
+
+  characters_.reserve(session.characters_count());
+
+  for (const auto& [id, character] : session.characters()) {
+    characters_.emplace_back(id, DogSerializer(static_cast<const model::Dog&>(*character)));
+  }
+
+  lost_objects_.reserve(session.lost_objects().size());
+
+  session.lost_objects().for_each([this](model::LootPool::Handle, const model::Loot& loot) {
+    lost_objects_.push_back(loot);
+  });
 }
 
-std::string_view LootSerializer::name() const noexcept {
-  return name_;
+void SessionSerializer::serialize(InputArchive& ar, unsigned) {
+  ar & id_;
+  ar & map_id_;
+  ar & seed_;
+  ar & next_character_id_;
+  ar & next_loot_id_;
+  ar & journal_seq_;
+  ar & characters_;
+  ar & lost_objects_;
 }
 
-const geom::Position& LootSerializer::position() const noexcept {
-  return pos_;
+void SessionSerializer::serialize(OutputArchive& ar, unsigned) {
+  ar & id_;
+  ar & map_id_;
+  ar & seed_;
+  ar & next_character_id_;
+  ar & next_loot_id_;
+  ar & journal_seq_;
+  ar & characters_;
+  ar & lost_objects_;
+}
+
+model::GameSession& SessionSerializer::restore(model::Game& game) const {
+  const auto map = game.find_map(model::Map::Id(map_id_));
+
+  if (!map) {
+    throw std::invalid_argument("Saved game session refers to an unknown map "s + map_id_);
+  }
+
+  auto& session = game.restore_session(*map, id_, seed_);
+
+  for (const auto& [id, character] : characters_) {
+    session.restore_character(id, character.restore());
+  }
+
+  for (const auto& loot : lost_objects_) {
+    session.restore_lost_object(loot);
+  }
+
+  session.restore_counters(next_character_id_, next_loot_id_);
+
+  return session;
+}
+
+model::GameSession::Id SessionSerializer::id() const noexcept {
+  return id_;
+}
+
+std::uint64_t SessionSerializer::journal_seq() const noexcept {
+  return journal_seq_;
+}
+
+void GameStateSerializer::serialize(InputArchive& ar, unsigned) {
+  ar & sessions_;
+  ar & players_;
+  ar & players_journal_seq_;
+}
+
+void GameStateSerializer::serialize(OutputArchive& ar, unsigned) {
+  ar & sessions_;
+  ar & players_;
+  ar & players_journal_seq_;
+}
+
+const GameStateSerializer::Sessions& GameStateSerializer::sessions() const noexcept {
+  return sessions_;
 }
 
-model::Loot::Type LootSerializer::type() const noexcept {
-  return type_;
+const GameStateSerializer::Players& GameStateSerializer::players() const noexcept {
+  return players_;
 }
 
-model::Loot::Value LootSerializer::value() const noexcept {
-  return value_;
+std::uint64_t GameStateSerializer::players_journal_seq() const noexcept {
+  return players_journal_seq_;
 }
 
 } // namespace serialization
\ No newline at end of file
@@ -4,9 +4,12 @@
 #include "loot.hpp"
 #include "character.hpp"
 #include "player.hpp"
+#include "game.hpp"
 
+#include <boost/serialization/string.hpp>
+#include <boost/serialization/utility.hpp>
+#include <boost/serialization/vector.hpp>
 #include <boost/serialization/unordered_map.hpp>
-#include <boost/serialization/shared_ptr.hpp>
 #include <boost/serialization/unique_ptr.hpp>
 #include <boost/archive/text_iarchive.hpp>
 #include <boost/archive/text_oarchive.hpp>
@@ -34,8 +37,8 @@ public:
     bagpack_.clear();
     bagpack_.capacity(character.bagpack.capacity());
 
-    for (const auto& [id, loot] : character.bagpack.get()) {   
-      bagpack_.add(id, loot);
+    for (const auto& loot : character.bagpack.get()) {   
+      bagpack_.add(loot);
     }
   }
 
@@ -72,32 +75,84 @@ public:
   explicit DogSerializer(const model::Dog& dog) 
     : CharacterSerializer(dog) {
   }
+
+  [[nodiscard]] std::shared_ptr<model::Character> restore() const;
 };
 
-class LootSerializer {
+// Состояние игровой сессии. journal_seq - номер первого события
+// журнала упреждающей записи, не вошедшего в снимок сессии
+class SessionSerializer {
+public:
+  using Characters = std::vector<std::pair<model::Character::Id, DogSerializer>>;
+  using LostObjects = std::vector<model::Loot>;
+
+  SessionSerializer() = default;
+
+  // Должен вызываться на strand'е сессии
+  explicit SessionSerializer(const model::GameSession& session, std::uint64_t journal_seq);
+
+  void serialize(InputArchive& ar, unsigned);
+  void serialize(OutputArchive& ar, unsigned);
+
+  // Создаёт сессию в игре и восстанавливает её состояние
+  model::GameSession& restore(model::Game& game) const;
+
+  [[nodiscard]] model::GameSession::Id id() const noexcept;
+  [[nodiscard]] std::uint64_t journal_seq() const noexcept;
+
+private:
+  model::GameSession::Id id_;
+  std::string map_id_;
+  std::uint64_t seed_;
+
+  model::Character::Id next_character_id_;
+  model::Loot::Id next_loot_id_;
+
+  std::uint64_t journal_seq_;
+
+  Characters characters_;
+  LostObjects lost_objects_;
+};
+
+struct PlayerRecord {
+  app::Token::Type token;
+  model::GameSession::Id session;
+  model::Character::Id character;
+};
+
+template <typename Archive>
+inline void serialize(Archive& ar, PlayerRecord& player, unsigned) {
+  ar & player.token;
+  ar & player.session;
+  ar & player.character;
+}
+
+// Снимок состояния игры: сессии и токены вошедших игроков
+class GameStateSerializer {
 public:
-  LootSerializer() = default;
+  using Sessions = std::vector<SessionSerializer>;
+  using Players = std::vector<PlayerRecord>;
+
+  GameStateSerializer() = default;
 
-  explicit LootSerializer(const model::Loot& loot)
-    : name_(loot.name())
-    , pos_(loot.position())
-    , type_(loot.type())
-    , value_(loot.value()) {
+  explicit GameStateSerializer(Sessions sessions, Players players, std::uint64_t players_journal_seq)
+    : sessions_(std::move(sessions))
+    , players_(std::move(players))
+    , players_journal_seq_(players_journal_seq) {
   }
 
-  virtual void serialize(InputArchive& ar, unsigned);
-  virtual void serialize(OutputArchive& ar, unsigned);
+  void serialize(InputArchive& ar, unsigned);
+  void serialize(OutputArchive& ar, unsigned);
 
-  [[nodiscard]] std::string_view name() const noexcept;
-  [[nodiscard]] const geom::Position& position() const noexcept;
-  [[nodiscard]] model::Loot::Type type() const noexcept;
-  [[nodiscard]] model::Loot::Value value() const noexcept;
+  [[nodiscard]] const Sessions& sessions() const noexcept;
+  [[nodiscard]] const Players& players() const noexcept;
+  [[nodiscard]] std::uint64_t players_journal_seq() const noexcept;
 
-protected:
-  std::string name_;
-  geom::Position pos_;
-  model::Loot::Type type_;
-  model::Loot::Value value_;
+private:
+  Sessions sessions_;
+  Players players_;
+
+  std::uint64_t players_journal_seq_ { 0u };
 };
 
 } // namespace serialization
@@ -134,45 +189,41 @@ inline void serialize(serialization::OutputArchive& ar, model::Character::Direct
 
 // Bagpack
 inline void serialize(serialization::InputArchive& ar, model::Bagpack& bagpack, unsigned) {  
-  model::Bagpack::BagType bag;
+  std::size_t capacity, size;
 
-  ar & bag;
+  ar & capacity;
+  ar & size;
 
   bagpack.clear();
-  bagpack.capacity(bag.size());
+  bagpack.capacity(capacity);
 
-  for (auto& [id, loot] : bag) {
-    bagpack.add(id, std::move(loot));
+  for (std::size_t i = 0; i < size; i++) {
+    model::Loot loot;
+    ar & loot;
+
+    bagpack.add(loot);
   }
 }
 
 inline void serialize(serialization::OutputArchive& ar, model::Bagpack& bagpack, unsigned) {
-  ar & bagpack.get();
-}
+  std::size_t capacity = bagpack.capacity();
+  std::size_t size = bagpack.size();
 
-// Loot
-inline void serialize(serialization::InputArchive& ar, model::Loot& loot, unsigned) {
-  serialization::LootSerializer ser_loot;
-  ar & ser_loot;
-
-  loot.name(ser_loot.name());
-  loot.position(ser_loot.position()); 
-  loot.type(ser_loot.type());
-  loot.value(ser_loot.value());
-}
+  ar & capacity;
+  ar & size;
 
-inline void serialize(serialization::OutputArchive& ar, model::Loot& loot, unsigned) {
-  ar & serialization::LootSerializer(loot);
+  for (auto loot : bagpack.get()) {
+    ar & loot;
+  }
 }
 
+// Loot
 template <typename Archive>
-inline void serialize(Archive& ar, model::Key& key, unsigned) {
-  ar & boost::serialization::base_object<model::Loot>(key);
+inline void serialize(Archive& ar, model::Loot& loot, unsigned) {
+  ar & loot.id;
+  ar & loot.type;
+  ar & loot.value;
+  ar & loot.position;
 }
 
-template <typename Archive>
-inline void serialize(Archive& ar, model::Wallet& wallet, unsigned) {
-  ar & boost::serialization::base_object<model::Loot>(wallet);
-} 
-
 } // namespace model 
\ No newline at end of file
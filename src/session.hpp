@@ -2,12 +2,17 @@
 
 #include "config.hpp"
 #include "logger.hpp"
+#include "admission.hpp"
+#include "tracing.hpp"
 
 #include <boost/asio/ip/tcp.hpp>
 #include <boost/beast/core.hpp>
 #include <boost/beast/http.hpp>
 #include <boost/asio/dispatch.hpp>
 
+#include <atomic>
+#include <optional>
+
 namespace http_server {
 
 namespace net = boost::asio;
@@ -18,6 +23,52 @@ using tcp = net::ip::tcp;
 
 using namespace std::literals;
 
+// Учёт обрабатываемых запросов для плавной остановки сервера.
+// После start() соединения закрываются, как только отправлен ответ
+class Drain {
+public:
+  static Drain& instance() {
+    static Drain drain;
+    return drain;
+  }
+
+  void start() noexcept {
+    draining_ = true;
+  }
+
+  [[nodiscard]] bool active() const noexcept {
+    return draining_;
+  }
+
+  [[nodiscard]] std::size_t in_flight() const noexcept {
+    return in_flight_;
+  }
+
+  void request_started() noexcept {
+    in_flight_++;
+  }
+
+  void request_finished() noexcept {
+    in_flight_--;
+  }
+
+private:
+  Drain() = default;
+
+private:
+  std::atomic<bool> draining_ { false };
+  std::atomic<std::size_t> in_flight_ { 0u };
+};
+
+// Сведения об отправленном ответе. Передаются вместо самого ответа
+// слоям, которым нужны только метаданные (например, журналированию)
+struct ResponseInfo {
+  unsigned status { 0u };
+  std::string_view content_type;
+  std::uint64_t body_size { 0u };
+  std::size_t bytes_written { 0u };
+};
+
 class SessionBase  {
 public:
   SessionBase(const SessionBase&) = delete;
@@ -35,18 +86,35 @@ protected:
 
   ~SessionBase() = default; 
 
-  explicit SessionBase(tcp::socket&& socket)
-    : stream_(std::move(socket)) {
+  SessionBase(tcp::socket&& socket, admission::Ticket&& ticket)
+    : stream_(std::move(socket))
+    , ticket_(std::move(ticket)) {
   }
 
-  template <typename Body, typename Fields>
-  void write(http::response<Body, Fields>&& response) {
+  // on_written вызывается по завершении записи ответа, пока ответ ещё существует
+  template <typename Body, typename Fields, typename OnWritten = void(*)(const ResponseInfo&)>
+  void write(http::response<Body, Fields>&& response, OnWritten&& on_written = [](const ResponseInfo&) {}) {
+    if (Drain::instance().active()) {
+      response.keep_alive(false);
+    }
+
     auto safe_response = std::make_shared<http::response<Body, Fields>>(std::move(response));
 
     stream_.expires_after(config::get().server.write_timeout);
+    span_.mark(tracing::Stage::write_start);
 
     http::async_write(stream_, *safe_response, 
-      [safe_response, self = get_shared_from_this()](beast::error_code ec, std::size_t bytes_written) {
+      [safe_response, self = get_shared_from_this(), on_written = std::forward<OnWritten>(on_written)]
+      (beast::error_code ec, std::size_t bytes_written) mutable {
+        self->span_.finish(safe_response->result_int());
+
+        on_written(ResponseInfo {
+          .status = safe_response->result_int(),
+          .content_type = (*safe_response)[http::field::content_type],
+          .body_size = safe_response->payload_size().value_or(0u),
+          .bytes_written = bytes_written
+        });
+
         self->on_write(safe_response->need_eof(), ec, bytes_written);
       });
   }
@@ -55,26 +123,74 @@ protected:
     return stream_.socket().remote_endpoint();
   }
 
+  // Трасса обрабатываемого запроса. Сессия обрабатывает запросы по одному
+  tracing::Span& span() noexcept {
+    return span_;
+  }
+
 private:
+  // Сначала читается только заголовок: запрос сверх лимита адреса отклоняется
+  // до чтения и разбора тела, а затем и до маршрутизации
   void read() {
-    request_ = {};
+    parser_.emplace();
     stream_.expires_after(config::get().server.read_timeout);
 
-    http::async_read(stream_, buf_, request_,
+    http::async_read_header(stream_, buf_, *parser_,
+      beast::bind_front_handler(&SessionBase::on_read_header, get_shared_from_this()));
+  }
+
+  void on_read_header(beast::error_code ec, [[maybe_unused]] std::size_t bytes_read) {
+    if (ec) {
+      return on_read_error(ec);
+    }
+
+    if (!ticket_.allow_request()) {
+      const auto& header = parser_->get();
+
+      Drain::instance().request_started();
+      span_.begin(header.target());
+
+      // Непрочитанное тело не даёт разобрать следующий запрос соединения, поэтому оно закрывается
+      return write(too_many_requests(header.version(), parser_->is_done() && header.keep_alive()));
+    }
+
+    http::async_read(stream_, buf_, *parser_,
       beast::bind_front_handler(&SessionBase::on_read, get_shared_from_this()));
   }
 
   void on_read(beast::error_code ec, [[maybe_unused]] std::size_t bytes_read) {
     if (ec) {
-      if (ec == http::error::end_of_stream) {
-        return close();
-      }
-      
-      LOG_SYSTEM_ERROR(ec.value(), ec.message())
-      return;
+      return on_read_error(ec);
     }
 
-    handle_request(std::move(request_));
+    // Запрос считается обрабатываемым, пока не отправлен ответ
+    Drain::instance().request_started();
+
+    auto request = parser_->release();
+    span_.begin(request.target());
+
+    handle_request(std::move(request));
+  }
+
+  void on_read_error(beast::error_code ec) {
+    if (ec == http::error::end_of_stream) {
+      return close();
+    }
+
+    LOG_SYSTEM_ERROR(ec.value(), ec.message())
+  }
+
+  static http::response<http::string_body> too_many_requests(unsigned version, bool keep_alive) {
+    http::response<http::string_body> response { http::status::too_many_requests, version };
+
+    response.set(http::field::content_type, "application/json"sv);
+    response.set(http::field::cache_control, "no-cache"sv);
+    response.set(http::field::retry_after, "1"sv);
+    response.body() = R"({"code":"tooManyRequests","message":"Request rate limit exceeded"})"sv;
+    response.keep_alive(keep_alive);
+    response.prepare_payload();
+
+    return response;
   }
 
   void close() {
@@ -83,6 +199,8 @@ private:
   }
 
   void on_write(bool close_socket, beast::error_code ec, [[maybe_unused]] std::size_t bytes_written) {
+    Drain::instance().request_finished();
+
     if (close_socket) {
       return close();
     }
@@ -102,15 +220,18 @@ private:
   beast::tcp_stream stream_;
   beast::flat_buffer buf_;
 
-  HttpRequest request_;
+  std::optional<http::request_parser<http::string_body>> parser_;
+
+  admission::Ticket ticket_;
+  tracing::Span span_;
 };
 
 template <typename RequestHandler>
 class Session : public SessionBase, public std::enable_shared_from_this<Session<RequestHandler>> {
 public:
   template <typename Handler>
-  Session(tcp::socket&& socket, Handler&& handler) 
-    : SessionBase(std::move(socket))
+  Session(tcp::socket&& socket, admission::Ticket&& ticket, Handler&& handler) 
+    : SessionBase(std::move(socket), std::move(ticket))
     , request_handler_(std::forward<Handler>(handler)) {
   }
 
@@ -120,8 +241,8 @@ private:
   }
 
   void handle_request(HttpRequest&& request) override {
-    request_handler_(remote_endpoint(), std::move(request), [self = this->shared_from_this()](auto&& response) {
-      self->write(std::move(response));
+    request_handler_(remote_endpoint(), std::move(request), span(), [self = this->shared_from_this()](auto&& response, auto&&... on_written) {
+      self->write(std::move(response), std::forward<decltype(on_written)>(on_written)...);
     });
   }
 
@@ -0,0 +1,365 @@
+#include "state.hpp"
+#include "serialization.hpp"
+#include "player.hpp"
+
+#include <fstream>
+#include <map>
+#include <mutex>
+#include <sstream>
+#include <unordered_map>
+#include <vector>
+
+#include <boost/asio/post.hpp>
+
+#include <fcntl.h>
+#include <unistd.h>
+
+namespace state {
+
+namespace net = boost::asio;
+
+using namespace std::literals;
+
+struct StateManager::Capture {
+  using PlayerKey = std::pair<model::GameSession::Id, model::Character::Id>;
+
+  std::mutex mutex;
+  std::size_t remaining { 0u };
+
+  serialization::GameStateSerializer::Sessions sessions;
+  serialization::GameStateSerializer::Players players;
+  wal::Journal::Seq players_seq { 0u };
+
+  // Используются при восстановлении
+  std::unordered_map<model::GameSession::Id, wal::Journal::Seq> session_seqs;
+  std::map<PlayerKey, app::Token::Type> tokens;
+};
+
+StateManager::StateManager(model::Game& game, fs::path state_file, std::optional<fs::path> journal_file,
+                           std::chrono::milliseconds fsync_interval)
+  : game_(game)
+  , state_file_(std::move(state_file))
+  , journal_file_(std::move(journal_file))
+  , fsync_interval_(fsync_interval) {
+}
+
+void StateManager::recover() {
+  Capture capture;
+
+  if (fs::exists(state_file_)) {
+    std::ifstream in(state_file_);
+    serialization::InputArchive ia { in };
+
+    serialization::GameStateSerializer snapshot;
+    ia >> snapshot;
+
+    for (const auto& session : snapshot.sessions()) {
+      session.restore(game_);
+
+      capture.session_seqs[session.id()] = session.journal_seq();
+      seq_ = std::max(seq_, session.journal_seq());
+    }
+
+    for (const auto& player : snapshot.players()) {
+      capture.tokens[{player.session, player.character}] = player.token;
+    }
+
+    capture.players_seq = snapshot.players_journal_seq();
+    seq_ = std::max(seq_, capture.players_seq);
+  }
+
+  if (journal_file_) {
+    const auto visitor = [this, &capture](wal::Journal::Seq seq, const wal::Event& event) {
+      apply(seq, event, capture);
+      seq_ = std::max(seq_, seq + 1);
+    };
+
+    // Файл, оставшийся от прерванного сохранения снимка, содержит более ранние события
+    wal::Journal::read(wal::Journal::rotated_path(*journal_file_), visitor);
+    wal::Journal::read(*journal_file_, visitor);
+  }
+
+  std::unordered_map<model::GameSession::Id, model::GameSession*> sessions;
+
+  for (const auto& session : game_.sessions()) {
+    sessions[session->id()] = session.get();
+  }
+
+  for (const auto& [key, token] : capture.tokens) {
+    const auto it_session = sessions.find(key.first);
+
+    if (it_session == sessions.cend()) {
+      continue;
+    }
+
+    auto& session = *it_session->second;
+    const auto it_character = session.characters().find(key.second);
+
+    if (it_character != session.characters().cend()) {
+      app::Players::instance().add_player(token, std::make_unique<app::Player>(key.second, it_character->second, session));
+    }
+  }
+
+  game_.recount_players();
+
+  // Восстановленное состояние сохраняется сразу, после чего старый журнал не нужен
+  save();
+
+  if (journal_file_) {
+    fs::remove(wal::Journal::rotated_path(*journal_file_));
+    fs::remove(*journal_file_);
+
+    journal_ = std::make_shared<wal::Journal>(*journal_file_, fsync_interval_);
+    journal_->next_seq(seq_);
+
+    if (error_handler_) {
+      journal_->error_handler(error_handler_);
+    }
+
+    game_.journal(journal_);
+  }
+}
+
+void StateManager::apply(wal::Journal::Seq seq, const wal::Event& event, Capture& capture) {
+  const auto find_session = [this](model::GameSession::Id id) -> model::GameSession* {
+    for (const auto& session : game_.sessions()) {
+      if (session->id() == id) {
+        return session.get();
+      }
+    }
+
+    return nullptr;
+  };
+
+  // Событие сессии применяется, если оно не вошло в её снимок
+  const auto session_event = [&](model::GameSession::Id id) -> model::GameSession* {
+    if (const auto it = capture.session_seqs.find(id); it != capture.session_seqs.cend() && seq < it->second) {
+      return nullptr;
+    }
+
+    return find_session(id);
+  };
+
+  const auto find_character = [](model::GameSession& session, model::Character::Id id) -> model::Character* {
+    const auto it = session.characters().find(id);
+    return it != session.characters().cend() ? it->second.get() : nullptr;
+  };
+
+  if (const auto e = std::get_if<wal::SessionCreated>(&event)) {
+    const auto map = game_.find_map(model::Map::Id(e->map_id));
+
+    if (map && !find_session(e->session)) {
+      game_.restore_session(*map, e->session, e->seed);
+    }
+  } else if (const auto e = std::get_if<wal::Join>(&event)) {
+    if (const auto session = session_event(e->session)) {
+      auto dog = model::create_character<model::Dog>(e->name, session->config().bag_capacity);
+      dog->position(e->position);
+
+      session->restore_character(e->character, std::move(dog));
+    }
+  } else if (const auto e = std::get_if<wal::Token>(&event)) {
+    if (seq >= capture.players_seq) {
+      capture.tokens[{e->session, e->character}] = e->token;
+    }
+  } else if (const auto e = std::get_if<wal::Move>(&event)) {
+    // Тики в журнал не пишутся, поэтому восстанавливается только направление и скорость.
+    // Персонаж остаётся в позиции из снимка (или из события Join), а перемещения
+    // за тики после снимка теряются
+    if (const auto session = session_event(e->session)) {
+      if (const auto character = find_character(*session, e->character)) {
+        const auto direction = static_cast<model::Character::Direction::Direct>(e->direction);
+        character->move(direction, session->config().characters_speed);
+      }
+    }
+  } else if (const auto e = std::get_if<wal::Collect>(&event)) {
+    if (const auto session = session_event(e->session)) {
+      if (const auto character = find_character(*session, e->character)) {
+        character->bagpack.add(e->loot);
+      }
+
+      session->remove_lost_object(e->loot.id);
+      session->restore_counters(session->next_character_id(), e->loot.id + 1);
+    }
+  } else if (const auto e = std::get_if<wal::Score>(&event)) {
+    if (const auto session = session_event(e->session)) {
+      if (const auto character = find_character(*session, e->character)) {
+        character->bagpack.clear();
+
+        if (e->score > character->score()) {
+          character->add_points(e->score - character->score());
+        }
+      }
+    }
+  } else if (const auto e = std::get_if<wal::Retire>(&event)) {
+    if (const auto session = session_event(e->session)) {
+      session->remove_character(e->character);
+    }
+  } else if (const auto e = std::get_if<wal::Reconfigure>(&event)) {
+    // Параметры сессии в снимок не входят, поэтому применяются независимо от его номера
+    if (const auto session = find_session(e->session)) {
+      auto cfg = session->config();
+
+      cfg.max_players = e->max_players;
+      cfg.bag_capacity = e->bag_capacity;
+      cfg.characters_speed = e->speed;
+      cfg.retirement_time = std::chrono::milliseconds(e->retirement_time);
+
+      session->restore_config(std::move(cfg));
+    }
+  }
+}
+
+void StateManager::save_async(Strand strand) {
+  if (saving_.exchange(true)) {
+    return;
+  }
+
+  // События, записанные до переключения журнала, попадут в снимок:
+  // состояние сессий и игроков захватывается после него
+  if (journal_) {
+    journal_->rotate([this, strand] {
+      net::post(strand, [this, strand] {
+        capture_async(strand);
+      });
+    });
+  } else {
+    capture_async(strand);
+  }
+}
+
+void StateManager::capture_async(Strand strand) {
+  auto capture = std::make_shared<Capture>();
+  const auto sessions = game_.sessions();
+
+  capture->players_seq = next_seq();
+
+  app::Players::instance().for_each([&capture](const app::Token::Type& token, const app::Player& player) {
+    capture->players.push_back({ token, player.game_session().id(), player.character_id() });
+  });
+
+  const auto finish = [this, capture, strand] {
+    net::post(strand, [this, capture] {
+      try {
+        write(*capture);
+
+        if (journal_) {
+          journal_->remove_rotated();
+        }
+      } catch (const std::exception& e) {
+        if (error_handler_) {
+          error_handler_(e);
+        }
+      }
+
+      saving_ = false;
+    });
+  };
+
+  if (sessions.empty()) {
+    finish();
+    return;
+  }
+
+  capture->remaining = sessions.size();
+
+  for (const auto& session : sessions) {
+    net::post(session->strand(), [this, capture, session, finish] {
+      serialization::SessionSerializer serialized(*session, next_seq());
+      bool last = false;
+
+      {
+        std::lock_guard lock(capture->mutex);
+
+        capture->sessions.push_back(std::move(serialized));
+        last = --capture->remaining == 0;
+      }
+
+      if (last) {
+        finish();
+      }
+    });
+  }
+}
+
+void StateManager::save() {
+  Capture capture;
+  capture.players_seq = next_seq();
+
+  for (const auto& session : game_.sessions()) {
+    capture.sessions.emplace_back(*session, next_seq());
+  }
+
+  app::Players::instance().for_each([&capture](const app::Token::Type& token, const app::Player& player) {
+    capture.players.push_back({ token, player.game_session().id(), player.character_id() });
+  });
+
+  write(capture);
+
+  if (journal_) {
+    journal_->rotate();
+    journal_->remove_rotated();
+  }
+}
+
+void StateManager::error_handler(ErrorHandler handler) {
+  error_handler_ = std::move(handler);
+
+  // После ошибки журнал перестаёт пополняться, и сервер работает без защиты от потери событий
+  if (journal_) {
+    journal_->error_handler(error_handler_);
+  }
+}
+
+void StateManager::write(const Capture& capture) const {
+  std::ostringstream ss;
+
+  {
+    serialization::OutputArchive oa { ss };
+    oa << serialization::GameStateSerializer(capture.sessions, capture.players, capture.players_seq);
+  }
+
+  const auto data = ss.str();
+
+  auto tmp_file = state_file_;
+  tmp_file += ".tmp";
+
+  const int fd = ::open(tmp_file.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+
+  if (fd < 0) {
+    throw std::runtime_error("Unable to open the state file"s);
+  }
+
+  std::size_t written = 0;
+
+  while (written < data.size()) {
+    const auto n = ::write(fd, data.data() + written, data.size() - written);
+
+    if (n < 0 && errno == EINTR) {
+      continue;
+    }
+
+    if (n < 0) {
+      ::close(fd);
+      throw std::runtime_error("Failed to write the state file"s);
+    }
+
+    written += n;
+  }
+
+  const bool synced = ::fsync(fd) == 0;
+  ::close(fd);
+
+  if (!synced) {
+    throw std::runtime_error("Failed to sync the state file"s);
+  }
+
+  // Переименование атомарно: при сбое на диске остаётся предыдущий снимок
+  fs::rename(tmp_file, state_file_);
+}
+
+wal::Journal::Seq StateManager::next_seq() const noexcept {
+  return journal_ ? journal_->next_seq() : seq_;
+}
+
+} // namespace state
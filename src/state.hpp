@@ -0,0 +1,81 @@
+#pragma once
+
+#include "game.hpp"
+#include "wal.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <filesystem>
+#include <functional>
+#include <memory>
+#include <optional>
+
+namespace state {
+
+namespace fs = std::filesystem;
+
+/*
+ * Сохранение и восстановление состояния игры.
+ *
+ * Снимок состояния периодически записывается в state_file. Если задан файл
+ * журнала, между снимками изменения записываются в журнал упреждающей записи.
+ * Перед сохранением снимка журнал переключается на новый файл, а после
+ * успешной записи снимка предыдущий файл журнала удаляется.
+ *
+ * При запуске загружается снимок и к нему применяются события журнала,
+ * не вошедшие в снимок, после чего сразу сохраняется новый снимок.
+ *
+ * Журнал не содержит тиков, поэтому позиции персонажей восстанавливаются
+ * только на момент снимка: перемещения после него теряются, а команды
+ * движения восстанавливают лишь направление и скорость.
+ */
+class StateManager final {
+public:
+  using Strand = model::GameSession::Strand;
+  using ErrorHandler = std::function<void(const std::exception& e)>;
+
+  StateManager(model::Game& game, fs::path state_file, std::optional<fs::path> journal_file,
+               std::chrono::milliseconds fsync_interval);
+
+  // Восстанавливает состояние и подключает журнал к игре.
+  // Вызывается до запуска io_context
+  void recover();
+
+  // Переключает файл журнала, захватывает состояние каждой сессии на её
+  // strand'е, а затем записывает снимок на strand'е strand. Ни один из шагов
+  // не ждёт диска в потоке, который его запустил. Вызов, пришедшийся на
+  // незавершённое сохранение, пропускается
+  void save_async(Strand strand);
+
+  // Сохраняет снимок синхронно. Вызывается, когда задачи сессий не выполняются
+  void save();
+
+  // Получает ошибки сохранения снимков и ошибку, после которой прекращается запись журнала
+  void error_handler(ErrorHandler handler);
+
+private:
+  struct Capture;
+
+  void apply(wal::Journal::Seq seq, const wal::Event& event, Capture& capture);
+  void capture_async(Strand strand);
+  void write(const Capture& capture) const;
+
+  [[nodiscard]] wal::Journal::Seq next_seq() const noexcept;
+
+private:
+  model::Game& game_;
+
+  fs::path state_file_;
+  std::optional<fs::path> journal_file_;
+  std::chrono::milliseconds fsync_interval_;
+
+  std::shared_ptr<wal::Journal> journal_;
+
+  // Номер следующего события, пока журнал не подключён
+  wal::Journal::Seq seq_ { 1u };
+
+  std::atomic<bool> saving_ { false };
+  ErrorHandler error_handler_;
+};
+
+} // namespace state
@@ -36,10 +36,13 @@ void Ticker::on_tick(sys::error_code ec) {
 
   last_tick_ = tick;
 
+  // Ошибка одного тика не останавливает следующие
   try {
     handler_(delta);
+  } catch (const std::exception& e) {
+    LOG_ERROR << JSON_DATA({"what"sv, e.what()}) << "tick handler failed"sv;
   } catch (...) {
-    //
+    LOG_ERROR << "tick handler failed"sv;
   }
 
   shedule_tick();
@@ -0,0 +1,96 @@
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <vector>
+#include <stdexcept>
+
+namespace util {
+
+/**
+ * Хешированное колесо таймеров.
+ * Время делится на интервалы длиной resolution, каждому интервалу
+ * соответствует ячейка колеса. Значение, срок которого наступает через
+ * delay, кладётся в ячейку (cursor + ticks) % slots с числом полных оборотов,
+ * которые колесо должно сделать до его срабатывания.
+ *
+ * Продвижение колеса обрабатывает только ячейки, мимо которых прошёл курсор,
+ * поэтому стоимость одного шага не зависит от общего количества таймеров.
+ * Отменённые таймеры не удаляются: проверять актуальность сработавшего
+ * значения должен вызывающий код.
+ */
+template <typename T>
+class TimingWheel {
+public:
+  using Duration = std::chrono::milliseconds;
+
+  TimingWheel(Duration resolution, std::size_t slots)
+    : resolution_(resolution)
+    , slots_(slots) {
+
+    if (resolution_ <= Duration::zero() || slots_.empty()) {
+      throw std::invalid_argument("Invalid timing wheel parameters");
+    }
+  }
+
+  void schedule(T value, Duration delay) {
+    if (delay < Duration::zero()) {
+      delay = Duration::zero();
+    }
+
+    // Количество сдвигов курсора, после которого истечёт delay
+    const std::size_t ticks = std::max<std::size_t>(1u, (delay + elapsed_ + resolution_ - Duration(1)) / resolution_);
+    const std::size_t slot = (cursor_ + ticks) % slots_.size();
+
+    slots_[slot].push_back({std::move(value), (ticks - 1) / slots_.size()});
+    size_++;
+  }
+
+  // Продвигает колесо на delta и вызывает fn для каждого значения, срок которого истёк
+  template <typename Fn>
+  void advance(Duration delta, Fn&& fn) {
+    elapsed_ += delta;
+
+    while (elapsed_ >= resolution_) {
+      elapsed_ -= resolution_;
+      cursor_ = (cursor_ + 1) % slots_.size();
+
+      auto& entries = slots_[cursor_];
+
+      for (std::size_t i = 0; i < entries.size();) {
+        if (entries[i].rounds > 0) {
+          entries[i++].rounds--;
+          continue;
+        }
+
+        T value = std::move(entries[i].value);
+
+        entries[i] = std::move(entries.back());
+        entries.pop_back();
+        size_--;
+
+        fn(std::move(value));
+      }
+    }
+  }
+
+  [[nodiscard]] std::size_t size() const noexcept {
+    return size_;
+  }
+
+private:
+  struct Entry {
+    T value;
+    std::size_t rounds;
+  };
+
+  Duration resolution_;
+  Duration elapsed_ { 0 };
+
+  std::vector<std::vector<Entry>> slots_;
+
+  std::size_t cursor_ { 0u };
+  std::size_t size_ { 0u };
+};
+
+} // namespace util
@@ -0,0 +1,276 @@
+#include "tracing.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+
+namespace tracing {
+
+using namespace std::literals;
+
+namespace {
+
+std::int64_t now_ns() noexcept {
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now().time_since_epoch()).count();
+}
+
+constexpr std::pair<Stage, Stage> interval_stages(Interval interval) noexcept {
+  switch (interval) {
+    case Interval::route   : return { Stage::read, Stage::routed };
+    case Interval::queue   : return { Stage::routed, Stage::strand };
+    case Interval::handler : return { Stage::strand, Stage::handled };
+    case Interval::send    : return { Stage::handled, Stage::write_start };
+    case Interval::write   : return { Stage::write_start, Stage::write_done };
+    default                : return { Stage::read, Stage::write_done };
+  }
+}
+
+} // namespace
+
+std::string_view interval_name(Interval interval) noexcept {
+  switch (interval) {
+    case Interval::route   : return "route"sv;
+    case Interval::queue   : return "queue"sv;
+    case Interval::handler : return "handler"sv;
+    case Interval::send    : return "send"sv;
+    case Interval::write   : return "write"sv;
+    default                : return "total"sv;
+  }
+}
+
+std::string_view Record::target_view() const noexcept {
+  return { target.data(), target_size };
+}
+
+std::int64_t Record::started(Interval interval) const noexcept {
+  return stamps[static_cast<std::size_t>(interval_stages(interval).first)];
+}
+
+std::chrono::nanoseconds Record::duration(Interval interval) const noexcept {
+  const auto [from, to] = interval_stages(interval);
+
+  const auto start = stamps[static_cast<std::size_t>(from)];
+  const auto end = stamps[static_cast<std::size_t>(to)];
+
+  if (!start || !end) {
+    return -1ns;
+  }
+
+  return std::chrono::nanoseconds(end - start);
+}
+
+void Span::begin(std::string_view target) noexcept {
+  auto& tracer = Tracer::instance();
+
+  active_ = tracer.enabled();
+
+  if (!active_) {
+    return;
+  }
+
+  record_ = {};
+  record_.id = tracer.next_id();
+
+  // Строка запроса в имя не входит
+  target = target.substr(0, target.find('?'));
+
+  record_.target_size = static_cast<std::uint8_t>(std::min(target.size(), Record::MAX_TARGET));
+  std::memcpy(record_.target.data(), target.data(), record_.target_size);
+
+  mark(Stage::read);
+}
+
+void Span::mark(Stage stage) noexcept {
+  if (active_) {
+    record_.stamps[static_cast<std::size_t>(stage)] = now_ns();
+  }
+}
+
+void Span::finish(unsigned status) noexcept {
+  if (!active_) {
+    return;
+  }
+
+  mark(Stage::write_done);
+  record_.status = status;
+
+  Tracer::instance().record(record_);
+  active_ = false;
+}
+
+bool Span::active() const noexcept {
+  return active_;
+}
+
+const Record& Span::record() const noexcept {
+  return record_;
+}
+
+std::chrono::nanoseconds Histogram::Snapshot::mean() const noexcept {
+  return count ? sum / static_cast<std::int64_t>(count) : 0ns;
+}
+
+std::chrono::microseconds Histogram::Snapshot::percentile(double q) const noexcept {
+  if (!count) {
+    return 0us;
+  }
+
+  const auto rank = static_cast<std::uint64_t>(std::clamp(q, 0.0, 1.0) * static_cast<double>(count - 1u)) + 1u;
+  std::uint64_t seen = 0u;
+
+  for (std::size_t i = 0; i < BUCKETS; ++i) {
+    seen += buckets[i];
+
+    if (seen >= rank) {
+      return upper_bound(i);
+    }
+  }
+
+  return upper_bound(BUCKETS - 1u);
+}
+
+void Histogram::add(std::chrono::nanoseconds duration) noexcept {
+  count_.fetch_add(1u, std::memory_order_relaxed);
+  sum_ns_.fetch_add(duration.count(), std::memory_order_relaxed);
+  buckets_[bucket(duration)].fetch_add(1u, std::memory_order_relaxed);
+}
+
+Histogram::Snapshot Histogram::snapshot() const noexcept {
+  Snapshot snapshot;
+
+  snapshot.count = count_.load(std::memory_order_relaxed);
+  snapshot.sum = std::chrono::nanoseconds(sum_ns_.load(std::memory_order_relaxed));
+
+  for (std::size_t i = 0; i < BUCKETS; ++i) {
+    snapshot.buckets[i] = buckets_[i].load(std::memory_order_relaxed);
+  }
+
+  return snapshot;
+}
+
+void Histogram::reset() noexcept {
+  count_.store(0u, std::memory_order_relaxed);
+  sum_ns_.store(0, std::memory_order_relaxed);
+
+  for (auto& bucket : buckets_) {
+    bucket.store(0u, std::memory_order_relaxed);
+  }
+}
+
+std::size_t Histogram::bucket(std::chrono::nanoseconds duration) noexcept {
+  const auto us = std::chrono::duration_cast<std::chrono::microseconds>(duration).count();
+
+  if (us <= 0) {
+    return 0u;
+  }
+
+  // Длительность [2^(i-1), 2^i) мкс попадает в корзину i
+  return std::min<std::size_t>(std::bit_width(static_cast<std::uint64_t>(us)), BUCKETS - 1u);
+}
+
+std::chrono::microseconds Histogram::upper_bound(std::size_t bucket) noexcept {
+  return std::chrono::microseconds(std::int64_t{1} << std::min(bucket, BUCKETS - 1u));
+}
+
+void Tracer::enable(std::size_t capacity) {
+  if (capacity == 0u) {
+    throw std::invalid_argument("Trace buffer capacity must be positive"s);
+  }
+
+  const auto per_shard = (capacity + SHARDS - 1u) / SHARDS;
+
+  for (auto& shard : shards_) {
+    std::lock_guard lock(shard.mutex);
+
+    shard.ring.assign(per_shard, Record{});
+    shard.next = 0u;
+  }
+
+  enabled_ = true;
+}
+
+void Tracer::disable() noexcept {
+  enabled_ = false;
+}
+
+bool Tracer::enabled() const noexcept {
+  return enabled_.load(std::memory_order_relaxed);
+}
+
+void Tracer::record(const Record& record) noexcept {
+  requests_.fetch_add(1u, std::memory_order_relaxed);
+
+  for (std::size_t i = 0; i < INTERVALS; ++i) {
+    if (const auto duration = record.duration(static_cast<Interval>(i)); duration >= 0ns) {
+      histograms_[i].add(duration);
+    }
+  }
+
+  auto& shard = shards_[record.id % SHARDS];
+  std::lock_guard lock(shard.mutex);
+
+  if (shard.ring.empty()) {
+    return;
+  }
+
+  shard.ring[shard.next] = record;
+  shard.next = (shard.next + 1u) % shard.ring.size();
+}
+
+std::vector<Record> Tracer::recent() const {
+  std::vector<Record> records;
+
+  for (const auto& shard : shards_) {
+    std::lock_guard lock(shard.mutex);
+
+    for (const auto& record : shard.ring) {
+      if (record.id) {
+        records.push_back(record);
+      }
+    }
+  }
+
+  std::sort(records.begin(), records.end(), [](const Record& lhs, const Record& rhs) {
+    return lhs.id < rhs.id;
+  });
+
+  return records;
+}
+
+Tracer::Stats Tracer::stats() const {
+  Stats stats;
+
+  stats.enabled = enabled();
+  stats.requests = requests_.load(std::memory_order_relaxed);
+
+  for (std::size_t i = 0; i < INTERVALS; ++i) {
+    stats.intervals[i] = histograms_[i].snapshot();
+  }
+
+  return stats;
+}
+
+void Tracer::reset() {
+  for (auto& shard : shards_) {
+    std::lock_guard lock(shard.mutex);
+
+    std::fill(shard.ring.begin(), shard.ring.end(), Record{});
+    shard.next = 0u;
+  }
+
+  // Гистограммы сбрасываются без блокировки: запросы, записанные во время сброса,
+  // могут учитываться частично
+  for (auto& histogram : histograms_) {
+    histogram.reset();
+  }
+
+  requests_ = 0u;
+}
+
+std::uint64_t Tracer::next_id() noexcept {
+  return ids_.fetch_add(1u, std::memory_order_relaxed) + 1u;
+}
+
+} // namespace tracing
@@ -0,0 +1,177 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <mutex>
+#include <string_view>
+#include <vector>
+
+namespace tracing {
+
+using Clock = std::chrono::steady_clock;
+
+/*
+ * Трассировка жизненного цикла запросов.
+ *
+ * Сессия хранит Span обрабатываемого запроса, и каждый этап обработки
+ * отмечает в нём время. После записи ответа Span передаётся в Tracer:
+ * длительности промежутков между этапами попадают в гистограммы, а сам
+ * запрос - в кольцевой буфер последних запросов. Пока трассировка
+ * выключена, отметки этапов ничего не делают.
+ */
+
+// Этапы обработки запроса в порядке их прохождения
+enum class Stage : std::uint8_t {
+  read,         // запрос прочитан
+  routed,       // найден маршрут
+  strand,       // обработчик запущен на своём strand'е
+  handled,      // обработчик сформировал ответ
+  write_start,  // начата запись ответа
+  write_done    // ответ записан
+};
+
+constexpr std::size_t STAGES = 6u;
+
+// Промежутки между этапами, для которых строятся гистограммы
+enum class Interval : std::uint8_t {
+  route,    // read -> routed
+  queue,    // routed -> strand: ожидание в очереди strand'а
+  handler,  // strand -> handled
+  send,     // handled -> write_start
+  write,    // write_start -> write_done
+  total     // read -> write_done
+};
+
+constexpr std::size_t INTERVALS = 6u;
+
+[[nodiscard]] std::string_view interval_name(Interval interval) noexcept;
+
+// Запись о завершённом запросе. Время этапов хранится в наносекундах
+// от эпохи steady_clock, ноль означает, что этап не проходился
+struct Record {
+  constexpr static std::size_t MAX_TARGET = 48u;
+
+  std::uint64_t id { 0u };
+  unsigned status { 0u };
+
+  std::array<std::int64_t, STAGES> stamps {};
+
+  std::array<char, MAX_TARGET> target {};
+  std::uint8_t target_size { 0u };
+
+  [[nodiscard]] std::string_view target_view() const noexcept;
+
+  // Время начала промежутка, ноль если этап не проходился
+  [[nodiscard]] std::int64_t started(Interval interval) const noexcept;
+
+  // Длительность промежутка или отрицательное значение, если один из этапов пропущен
+  [[nodiscard]] std::chrono::nanoseconds duration(Interval interval) const noexcept;
+};
+
+class Span {
+public:
+  // Начинает трассировку нового запроса, если трассировка включена
+  void begin(std::string_view target) noexcept;
+  void mark(Stage stage) noexcept;
+
+  // Передаёт запрос в Tracer и завершает трассировку
+  void finish(unsigned status) noexcept;
+
+  [[nodiscard]] bool active() const noexcept;
+  [[nodiscard]] const Record& record() const noexcept;
+
+private:
+  Record record_;
+  bool active_ { false };
+};
+
+// Гистограмма с границами корзин, растущими степенями двойки: корзина i
+// содержит длительности меньше 2^i мкс, последняя - все остальные
+class Histogram {
+public:
+  constexpr static std::size_t BUCKETS = 24u;
+
+  struct Snapshot {
+    std::uint64_t count { 0u };
+    std::chrono::nanoseconds sum { 0 };
+    std::array<std::uint64_t, BUCKETS> buckets {};
+
+    [[nodiscard]] std::chrono::nanoseconds mean() const noexcept;
+
+    // Верхняя граница корзины, в которую попадает квантиль q
+    [[nodiscard]] std::chrono::microseconds percentile(double q) const noexcept;
+  };
+
+  void add(std::chrono::nanoseconds duration) noexcept;
+  void reset() noexcept;
+
+  [[nodiscard]] Snapshot snapshot() const noexcept;
+
+  [[nodiscard]] static std::size_t bucket(std::chrono::nanoseconds duration) noexcept;
+  [[nodiscard]] static std::chrono::microseconds upper_bound(std::size_t bucket) noexcept;
+
+private:
+  std::atomic<std::uint64_t> count_ { 0u };
+  std::atomic<std::int64_t> sum_ns_ { 0 };
+  std::array<std::atomic<std::uint64_t>, BUCKETS> buckets_ {};
+};
+
+class Tracer {
+public:
+  struct Stats {
+    bool enabled { false };
+    std::uint64_t requests { 0u };
+    std::array<Histogram::Snapshot, INTERVALS> intervals {};
+  };
+
+  static Tracer& instance() {
+    static Tracer tracer;
+    return tracer;
+  }
+
+  Tracer(const Tracer&) = delete;
+  Tracer& operator=(const Tracer&) = delete;
+
+  // Включает трассировку. capacity - число последних запросов в кольцевом буфере
+  void enable(std::size_t capacity);
+  void disable() noexcept;
+
+  [[nodiscard]] bool enabled() const noexcept;
+
+  void record(const Record& record) noexcept;
+
+  // Последние запросы в порядке их поступления
+  [[nodiscard]] std::vector<Record> recent() const;
+  [[nodiscard]] Stats stats() const;
+
+  // Очищает буфер и гистограммы
+  void reset();
+
+private:
+  friend class Span;
+
+  Tracer() = default;
+
+  [[nodiscard]] std::uint64_t next_id() noexcept;
+
+private:
+  constexpr static std::size_t SHARDS = 16u;
+
+  // Буфер разделён на шарды с отдельными мьютексами, запрос попадает в шард по номеру
+  struct Shard {
+    mutable std::mutex mutex;
+    std::vector<Record> ring;
+    std::size_t next { 0u };
+  };
+
+  std::atomic<bool> enabled_ { false };
+  std::atomic<std::uint64_t> ids_ { 0u };
+  std::atomic<std::uint64_t> requests_ { 0u };
+
+  std::array<Shard, SHARDS> shards_;
+  std::array<Histogram, INTERVALS> histograms_;
+};
+
+} // namespace tracing
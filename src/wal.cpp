@@ -0,0 +1,471 @@
+#include "wal.hpp"
+
+#include <cerrno>
+#include <cstring>
+#include <fstream>
+#include <optional>
+#include <stdexcept>
+
+#include <boost/crc.hpp>
+
+#include <fcntl.h>
+#include <unistd.h>
+
+namespace wal {
+
+using namespace std::literals;
+
+namespace {
+
+enum class EventType : std::uint8_t {
+  session_created = 1,
+  join,
+  token,
+  move,
+  collect,
+  score,
+  retire,
+  reconfigure
+};
+
+struct RecordHeader {
+  std::uint32_t size;
+  std::uint32_t crc;
+};
+
+class Writer {
+public:
+  explicit Writer(std::vector<char>& buffer)
+    : buffer_(buffer) {
+  }
+
+  template <typename T>
+  void put(const T& value) {
+    journal::put(buffer_, value);
+  }
+
+  void put_string(std::string_view str) {
+    journal::put_string(buffer_, str);
+  }
+
+  void put_position(const geom::Position& pos) {
+    put(pos.x);
+    put(pos.y);
+  }
+
+  void operator()(const SessionCreated& e) {
+    put(EventType::session_created);
+    put(e.session);
+    put(e.seed);
+    put_string(e.map_id);
+  }
+
+  void operator()(const Join& e) {
+    put(EventType::join);
+    put(e.session);
+    put(e.character);
+    put_string(e.name);
+    put_position(e.position);
+  }
+
+  void operator()(const Token& e) {
+    put(EventType::token);
+    put(e.session);
+    put(e.character);
+    put_string(e.token);
+  }
+
+  void operator()(const Move& e) {
+    put(EventType::move);
+    put(e.session);
+    put(e.character);
+    put(e.direction);
+  }
+
+  void operator()(const Collect& e) {
+    put(EventType::collect);
+    put(e.session);
+    put(e.character);
+    put(e.loot);
+  }
+
+  void operator()(const Score& e) {
+    put(EventType::score);
+    put(e.session);
+    put(e.character);
+    put(e.score);
+  }
+
+  void operator()(const Retire& e) {
+    put(EventType::retire);
+    put(e.session);
+    put(e.character);
+  }
+
+  void operator()(const Reconfigure& e) {
+    put(EventType::reconfigure);
+    put(e.session);
+    put(e.max_players);
+    put(e.bag_capacity);
+    put(e.speed);
+    put(e.retirement_time);
+  }
+
+private:
+  std::vector<char>& buffer_;
+};
+
+class Parser : public journal::BufferReader {
+public:
+  using BufferReader::BufferReader;
+
+  bool get_position(geom::Position& pos) {
+    return get(pos.x) && get(pos.y);
+  }
+
+  std::optional<Event> event() {
+    EventType type;
+
+    if (!get(type)) {
+      return std::nullopt;
+    }
+
+    switch (type) {
+      case EventType::session_created : {
+        SessionCreated e;
+        if (get(e.session) && get(e.seed) && get_string(e.map_id)) return e;
+        break;
+      } case EventType::join : {
+        Join e;
+        if (get(e.session) && get(e.character) && get_string(e.name) && get_position(e.position)) return e;
+        break;
+      } case EventType::token : {
+        Token e;
+        if (get(e.session) && get(e.character) && get_string(e.token)) return e;
+        break;
+      } case EventType::move : {
+        Move e;
+        if (get(e.session) && get(e.character) && get(e.direction)) return e;
+        break;
+      } case EventType::collect : {
+        Collect e;
+        if (get(e.session) && get(e.character) && get(e.loot)) return e;
+        break;
+      } case EventType::score : {
+        Score e;
+        if (get(e.session) && get(e.character) && get(e.score)) return e;
+        break;
+      } case EventType::retire : {
+        Retire e;
+        if (get(e.session) && get(e.character)) return e;
+        break;
+      } case EventType::reconfigure : {
+        Reconfigure e;
+        if (get(e.session) && get(e.max_players) && get(e.bag_capacity) && get(e.speed) && get(e.retirement_time)) return e;
+        break;
+      }
+    }
+
+    return std::nullopt;
+  }
+};
+
+std::uint32_t crc32(const char* data, std::size_t size) {
+  boost::crc_32_type crc;
+  crc.process_bytes(data, size);
+
+  return crc.checksum();
+}
+
+} // namespace
+
+Journal::Journal(fs::path file, std::chrono::milliseconds fsync_interval)
+  : file_(std::move(file))
+  , fsync_interval_(fsync_interval) {
+
+  open();
+
+  last_sync_ = std::chrono::steady_clock::now();
+  thread_ = std::thread([this] { run(); });
+}
+
+Journal::~Journal() {
+  {
+    std::lock_guard lock(mutex_);
+    stop_ = true;
+  }
+
+  cv_.notify_one();
+  thread_.join();
+
+  if (fd_ >= 0) {
+    ::close(fd_);
+  }
+}
+
+Journal::Seq Journal::append(const Event& event) {
+  std::unique_lock lock(mutex_);
+
+  const auto seq = next_seq_.fetch_add(1u);
+
+  // Заголовок заполняется после того, как станет известен размер записи
+  const auto header_pos = pending_.size();
+  pending_.resize(header_pos + sizeof(RecordHeader));
+
+  Writer writer(pending_);
+  writer.put(seq);
+  std::visit(writer, event);
+
+  const char* payload = pending_.data() + header_pos + sizeof(RecordHeader);
+  const auto payload_size = pending_.size() - header_pos - sizeof(RecordHeader);
+
+  if (payload_size > MAX_RECORD_SIZE) {
+    pending_.resize(header_pos);
+    throw std::length_error("Write-ahead log record is too large"s);
+  }
+
+  const RecordHeader header {
+    .size = static_cast<std::uint32_t>(payload_size),
+    .crc = crc32(payload, payload_size)
+  };
+
+  std::memcpy(pending_.data() + header_pos, &header, sizeof(header));
+
+  lock.unlock();
+  cv_.notify_one();
+
+  return seq;
+}
+
+Journal::Seq Journal::next_seq() const noexcept {
+  return next_seq_.load();
+}
+
+void Journal::next_seq(Seq seq) noexcept {
+  next_seq_.store(seq);
+}
+
+void Journal::rotate(RotateHandler handler) {
+  {
+    std::lock_guard lock(mutex_);
+
+    rotate_requested_ = true;
+    rotate_handlers_.push_back(std::move(handler));
+  }
+
+  cv_.notify_one();
+}
+
+void Journal::rotate() {
+  std::unique_lock lock(mutex_);
+
+  const auto rotations = rotations_;
+  rotate_requested_ = true;
+
+  cv_.notify_one();
+  rotated_cv_.wait(lock, [this, rotations] {
+    return rotations_ != rotations;
+  });
+}
+
+void Journal::remove_rotated() {
+  std::error_code ec;
+  fs::remove(rotated_path(file_), ec);
+}
+
+bool Journal::good() const noexcept {
+  return !failed_.load();
+}
+
+void Journal::error_handler(ErrorHandler handler) {
+  std::lock_guard lock(mutex_);
+  error_handler_ = std::move(handler);
+}
+
+const fs::path& Journal::path() const noexcept {
+  return file_;
+}
+
+fs::path Journal::rotated_path(const fs::path& file) {
+  auto rotated = file;
+  rotated += ".old";
+
+  return rotated;
+}
+
+void Journal::read(const fs::path& file, const Visitor& visitor) {
+  std::ifstream in(file, std::ios::binary);
+
+  if (!in) {
+    return;
+  }
+
+  std::vector<char> payload;
+  RecordHeader header;
+
+  while (in.read(reinterpret_cast<char*>(&header), sizeof(header))) {
+    // Размер из повреждённого заголовка не должен приводить к огромному выделению памяти
+    if (header.size > MAX_RECORD_SIZE) {
+      return;
+    }
+
+    payload.resize(header.size);
+
+    if (!in.read(payload.data(), payload.size()) || crc32(payload.data(), payload.size()) != header.crc) {
+      return;
+    }
+
+    Parser parser(payload.data(), payload.data() + payload.size());
+    Seq seq;
+
+    if (!parser.get(seq)) {
+      return;
+    }
+
+    const auto event = parser.event();
+
+    if (!event) {
+      return;
+    }
+
+    visitor(seq, *event);
+  }
+}
+
+void Journal::run() {
+  std::vector<char> batch;
+  std::vector<RotateHandler> handlers;
+  std::unique_lock lock(mutex_);
+
+  while (true) {
+    const auto has_work = [this] {
+      return stop_ || rotate_requested_ || !pending_.empty();
+    };
+
+    // Пока есть не сброшенные на диск данные, поток просыпается хотя бы раз за fsync_interval
+    if (dirty_ && fsync_interval_ > std::chrono::milliseconds::zero()) {
+      cv_.wait_for(lock, fsync_interval_, has_work);
+    } else {
+      cv_.wait(lock, has_work);
+    }
+
+    // Групповая запись: всё, что накопилось за время предыдущей
+    // записи и fsync, уходит на диск одним вызовом write
+    batch.swap(pending_);
+    handlers.swap(rotate_handlers_);
+
+    const bool rotate = rotate_requested_;
+    const bool stop = stop_;
+
+    lock.unlock();
+
+    write(batch);
+    batch.clear();
+
+    if (rotate || stop || std::chrono::steady_clock::now() - last_sync_ >= fsync_interval_) {
+      sync();
+    }
+
+    std::error_code ec;
+
+    // Файл с событиями, не вошедшими в снимок, не перезаписывается
+    if (rotate && !failed_ && !fs::exists(rotated_path(file_), ec) && !ec) {
+      ::close(fd_);
+      fd_ = -1;
+
+      fs::rename(file_, rotated_path(file_), ec);
+
+      if (ec) {
+        fail("rename", ec.value());
+      } else if (fd_ = ::open(file_.c_str(), O_WRONLY | O_CREAT | O_APPEND | O_CLOEXEC, 0644); fd_ < 0) {
+        fail("open", errno);
+      }
+    }
+
+    for (const auto& handler : handlers) {
+      if (handler) {
+        handler();
+      }
+    }
+
+    handlers.clear();
+
+    lock.lock();
+
+    if (rotate) {
+      rotate_requested_ = false;
+      rotations_++;
+      rotated_cv_.notify_all();
+    }
+
+    if (stop && pending_.empty()) {
+      break;
+    }
+  }
+}
+
+void Journal::open() {
+  fd_ = ::open(file_.c_str(), O_WRONLY | O_CREAT | O_APPEND | O_CLOEXEC, 0644);
+
+  if (fd_ < 0) {
+    throw std::runtime_error("Unable to open the write-ahead log"s);
+  }
+}
+
+void Journal::write(const std::vector<char>& batch) {
+  if (failed_) {
+    return;
+  }
+
+  const char* data = batch.data();
+  std::size_t left = batch.size();
+
+  while (left > 0) {
+    const auto written = ::write(fd_, data, left);
+
+    if (written < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+
+      // Продолжать запись после ошибки нельзя: в файле останется
+      // разрыв, а следующие события будут проигнорированы при чтении
+      fail("write", errno);
+      return;
+    }
+
+    data += written;
+    left -= written;
+  }
+
+  dirty_ = dirty_ || !batch.empty();
+}
+
+void Journal::sync() {
+  if (dirty_ && !failed_ && ::fdatasync(fd_) != 0) {
+    fail("fdatasync", errno);
+  }
+
+  dirty_ = false;
+
+  last_sync_ = std::chrono::steady_clock::now();
+}
+
+void Journal::fail(const char* operation, int error) {
+  if (failed_.exchange(true)) {
+    return;
+  }
+
+  ErrorHandler handler;
+
+  {
+    std::lock_guard lock(mutex_);
+    handler = error_handler_;
+  }
+
+  if (handler) {
+    handler(std::runtime_error("Write-ahead log stopped after failed "s + operation + ": "s + std::strerror(error)));
+  }
+}
+
+} // namespace wal
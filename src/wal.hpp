@@ -0,0 +1,167 @@
+#pragma once
+
+#include "loot.hpp"
+#include "geometry.hpp"
+#include "journal_codec.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <filesystem>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <variant>
+#include <vector>
+
+namespace wal {
+
+namespace fs = std::filesystem;
+
+/*
+ * Журнал упреждающей записи (write-ahead log) изменений состояния игры.
+ *
+ * Между снимками состояния в журнал пишутся события, изменяющие сохраняемое
+ * состояние. При запуске сервер загружает последний снимок и применяет к нему
+ * события журнала, поэтому при аварийном завершении теряются только события,
+ * не успевшие попасть на диск за интервал fsync.
+ *
+ * Каждое событие получает возрастающий номер. Снимок сессии запоминает номер,
+ * начиная с которого события сессии в него не вошли, поэтому при восстановлении
+ * события, уже учтённые в снимке, пропускаются.
+ *
+ * Формат записи: { u32 size, u32 crc32, payload { u64 seq, u8 type, поля события } }
+ */
+
+using SessionCreated = journal::SessionCreated;
+
+struct Join {
+  std::uint64_t session;
+  std::uint64_t character;
+  std::string name;
+  geom::Position position;
+};
+
+struct Token {
+  std::uint64_t session;
+  std::uint64_t character;
+  std::string token;
+};
+
+using Move = journal::Move;
+
+struct Collect {
+  std::uint64_t session;
+  std::uint64_t character;
+  model::Loot loot;
+};
+
+struct Score {
+  std::uint64_t session;
+  std::uint64_t character;
+  std::uint64_t score;
+};
+
+struct Retire {
+  std::uint64_t session;
+  std::uint64_t character;
+};
+
+using Reconfigure = journal::Reconfigure;
+
+using Event = std::variant<SessionCreated, Join, Token, Move, Collect, Score, Retire, Reconfigure>;
+
+class Journal final {
+public:
+  using Seq = std::uint64_t;
+  using Visitor = std::function<void(Seq seq, const Event& event)>;
+  using ErrorHandler = std::function<void(const std::exception& e)>;
+  using RotateHandler = std::function<void()>;
+
+  // Предельный размер записи. Строки событий не длиннее 65535 байт, поэтому
+  // настоящие записи меньше, а заголовок с большим размером считается повреждённым
+  constexpr static std::uint32_t MAX_RECORD_SIZE { 128u * 1024u };
+
+  // fsync_interval - максимальное время, в течение которого записанные
+  // события могут оставаться не сброшенными на диск. При нулевом значении
+  // fsync выполняется после записи каждой группы событий
+  Journal(fs::path file, std::chrono::milliseconds fsync_interval);
+  ~Journal();
+
+  Journal(const Journal&) = delete;
+  Journal& operator=(const Journal&) = delete;
+
+  // Кладёт событие в буфер и возвращает его номер. Запись на диск выполняет
+  // поток журнала, поэтому вызов не ждёт ввода-вывода. Потокобезопасен
+  Seq append(const Event& event);
+
+  // Номер, который получит следующее событие
+  [[nodiscard]] Seq next_seq() const noexcept;
+  void next_seq(Seq seq) noexcept;
+
+  // Дописывает накопленные события, закрывает текущий файл журнала,
+  // переименовывая его в rotated_path(), и начинает новый. Не ждёт
+  // переключения: handler вызывается в потоке журнала, когда оно выполнено.
+  // Если файл rotated_path() остался от неудачного сохранения, переключение
+  // пропускается, чтобы не потерять его события, и запись продолжается
+  // в текущий файл
+  void rotate(RotateHandler handler);
+
+  // То же, но блокирует вызывающий поток до завершения переключения
+  void rotate();
+
+  // Удаляет файл, полученный при последнем переключении.
+  // Вызывается после успешного сохранения снимка
+  void remove_rotated();
+
+  // Возвращает false, если запись в журнал прекращена из-за ошибки ввода-вывода
+  [[nodiscard]] bool good() const noexcept;
+
+  // Вызывается один раз, в потоке журнала, когда запись прекращается из-за ошибки
+  void error_handler(ErrorHandler handler);
+
+  [[nodiscard]] const fs::path& path() const noexcept;
+  [[nodiscard]] static fs::path rotated_path(const fs::path& file);
+
+  // Читает события журнала по порядку. Запись, которая была прервана
+  // или повреждена, и все следующие за ней игнорируются
+  static void read(const fs::path& file, const Visitor& visitor);
+
+private:
+  void run();
+  void open();
+  void write(const std::vector<char>& batch);
+  void sync();
+
+  // Прекращает запись в журнал и сообщает об ошибке обработчику
+  void fail(const char* operation, int error);
+
+private:
+  fs::path file_;
+  std::chrono::milliseconds fsync_interval_;
+
+  int fd_ { -1 };
+  bool dirty_ { false };
+  std::atomic<bool> failed_ { false };
+  std::chrono::steady_clock::time_point last_sync_;
+
+  mutable std::mutex mutex_;
+  std::condition_variable cv_;
+  std::condition_variable rotated_cv_;
+
+  std::vector<char> pending_;
+  std::atomic<Seq> next_seq_ { 1u };
+
+  bool stop_ { false };
+  bool rotate_requested_ { false };
+  std::vector<RotateHandler> rotate_handlers_;
+  std::uint64_t rotations_ { 0u };
+
+  ErrorHandler error_handler_;
+
+  std::thread thread_;
+};
+
+} // namespace wal
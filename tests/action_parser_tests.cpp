@@ -0,0 +1,42 @@
+#include "../src/action_parser.hpp"
+
+#include <catch2/catch_test_macros.hpp>
+
+using namespace std::literals;
+
+using Direction = model::Character::Direction;
+
+static_assert(action_parser::parse_move(R"({"move":"L"})"sv) == Direction::west);
+static_assert(action_parser::parse_move(R"({"move":""})"sv) == Direction::nomove);
+static_assert(!action_parser::parse_move(R"({"move":"X"})"sv));
+
+SCENARIO("Player action parsing") {
+  GIVEN("bodies matching the action schema") {
+    THEN("directions are decoded") {
+      CHECK(action_parser::parse_move(R"({"move":"U"})"sv) == Direction::north);
+      CHECK(action_parser::parse_move(R"({"move":"D"})"sv) == Direction::south);
+      CHECK(action_parser::parse_move(R"({"move":"R"})"sv) == Direction::east);
+      CHECK(action_parser::parse_move(" {\n  \"move\" : \"L\"\r\n}\n"sv) == Direction::west);
+    }
+  }
+
+  GIVEN("bodies outside the fast path") {
+    THEN("the parser leaves them to the general JSON parser") {
+      CHECK_FALSE(action_parser::parse_move(""sv));
+      CHECK_FALSE(action_parser::parse_move(R"({"move":"LR"})"sv));
+      CHECK_FALSE(action_parser::parse_move(R"({"move":"\u004C"})"sv));
+      CHECK_FALSE(action_parser::parse_move(R"({"move":"L","extra":1})"sv));
+      CHECK_FALSE(action_parser::parse_move(R"({"move":"L"} x)"sv));
+      CHECK_FALSE(action_parser::parse_move(R"({"move":"L")"sv));
+      CHECK_FALSE(action_parser::parse_move(R"({"mov":"L"})"sv));
+    }
+  }
+
+  GIVEN("direction letters") {
+    THEN("they are decoded by the same table") {
+      CHECK(Direction::from_letter("U"sv) == Direction::north);
+      CHECK(Direction("L"sv).value() == Direction::west);
+      CHECK_THROWS_AS(Direction("l"sv), std::invalid_argument);
+    }
+  }
+}
@@ -0,0 +1,188 @@
+#include "../src/endpoint.hpp"
+#include "../src/player.hpp"
+
+#include <boost/asio/io_context.hpp>
+#include <boost/json.hpp>
+#include <catch2/catch_test_macros.hpp>
+
+namespace net = boost::asio;
+namespace json = boost::json;
+namespace http = common::http;
+
+using common::http_string_request_t;
+using common::http_string_response_t;
+
+using namespace std::literals;
+
+using Direction = model::Character::Direction;
+
+namespace {
+
+const model::Map::Id MAP_ID { "map1"s };
+
+const auto FIRST_TOKEN = "0123456789abcdef0123456789abcdef"s;
+const auto SECOND_TOKEN = "fedcba9876543210fedcba9876543210"s;
+const auto UNKNOWN_TOKEN = "00000000000000000000000000000000"s;
+
+model::Map make_map() {
+  model::Map map { MAP_ID, "Map 1"s };
+  map.add_road(model::Road(model::Road::HORIZONTAL, { 0.0, 0.0 }, 10.0));
+
+  return map;
+}
+
+// В сессии помещается один игрок, поэтому игроки оказываются в разных сессиях
+model::GameConfig make_config() {
+  model::GameConfig cfg;
+
+  cfg.randomize_spawn = false;
+  cfg.loot_generator = { .period = 5s, .probability = 0.0 };
+  cfg.map_character_speed[MAP_ID] = 1.0;
+  cfg.map_max_players[MAP_ID] = 1u;
+
+  return cfg;
+}
+
+struct Fixture {
+  Fixture() {
+    game.add_map(make_map());
+    game.io_context(io);
+
+    first = add_player(FIRST_TOKEN);
+    second = add_player(SECOND_TOKEN);
+
+    io.run();
+    io.restart();
+  }
+
+  ~Fixture() {
+    app::Players::instance().remove(*first);
+    app::Players::instance().remove(*second);
+
+    io.run();
+  }
+
+  std::shared_ptr<model::Character> add_player(const std::string& token) {
+    const auto session = game.get_session(game.find_map(MAP_ID));
+    auto [id, dog] = session->add_character(model::create_character<model::Dog>("Rex"sv, 3u));
+
+    app::Players::instance().add_player(token, std::make_unique<app::Player>(id, dog, *session));
+
+    return dog;
+  }
+
+  http_string_response_t post(const mux::Route& route, std::string body) const {
+    http_string_request_t req { http::verb::post, "/api/v1/game/player/actions"sv, 11 };
+
+    req.set(http::field::content_type, "application/json"sv);
+    req.body() = std::move(body);
+    req.prepare_payload();
+
+    return std::get<http_string_response_t>(route.handler()(std::move(req)));
+  }
+
+  // Тело пакета из count одинаковых действий
+  static std::string actions(std::size_t count, std::string_view token, std::string_view move) {
+    json::array items;
+
+    for (std::size_t i = 0; i < count; ++i) {
+      items.push_back(json::object { {"token"sv, token}, {"move"sv, move} });
+    }
+
+    return json::serialize(json::object { {"actions"sv, std::move(items)} });
+  }
+
+  net::io_context io;
+  model::Game game { make_config() };
+
+  std::shared_ptr<model::Character> first;
+  std::shared_ptr<model::Character> second;
+
+  endpoint::PlayerActionsBatch batch;
+  endpoint::PlayerAction action;
+};
+
+} // namespace
+
+SCENARIO_METHOD(Fixture, "Player actions batch") {
+  const auto route = batch.route();
+
+  GIVEN("actions of players from different sessions and an unknown token") {
+    const auto response = post(*route, R"({"actions": [
+      {"token": ")"s + FIRST_TOKEN + R"(", "move": "R"},
+      {"token": ")"s + SECOND_TOKEN + R"(", "move": "D"},
+      {"token": ")"s + UNKNOWN_TOKEN + R"(", "move": "U"},
+      {"token": ")"s + FIRST_TOKEN + R"(", "move": "L"}
+    ]})"s);
+
+    THEN("known and unknown actions are counted") {
+      REQUIRE(response.result() == http::status::ok);
+
+      const auto body = json::parse(response.body()).as_object();
+
+      CHECK(body.at("accepted"sv).as_int64() == 3);
+      CHECK(body.at("unknownTokens"sv).as_int64() == 1);
+    }
+
+    THEN("moves are applied after the response, by one task per session") {
+      CHECK(first->speed() == geom::Speed{0.0, 0.0});
+
+      CHECK(io.run() == 2u);
+
+      CHECK(first->direction().value() == Direction::west);
+      CHECK(second->direction().value() == Direction::south);
+    }
+  }
+
+  GIVEN("a batch with an invalid move") {
+    const auto response = post(*route, actions(1u, FIRST_TOKEN, "X"sv));
+
+    THEN("the whole batch is rejected") {
+      CHECK(response.result() == http::status::bad_request);
+      CHECK(io.poll() == 0u);
+    }
+  }
+
+  GIVEN("batches around the size limit") {
+    THEN("1000 actions are accepted") {
+      const auto response = post(*route, actions(1000u, UNKNOWN_TOKEN, "U"sv));
+
+      REQUIRE(response.result() == http::status::ok);
+      CHECK(json::parse(response.body()).at("unknownTokens"sv).as_int64() == 1000);
+    }
+
+    THEN("1001 actions are rejected") {
+      CHECK(post(*route, actions(1001u, UNKNOWN_TOKEN, "U"sv)).result() == http::status::bad_request);
+    }
+  }
+
+  GIVEN("malformed batches") {
+    THEN("they are rejected") {
+      CHECK(post(*route, R"({"actions": {}})"s).result() == http::status::bad_request);
+      CHECK(post(*route, R"({"actions": [{"move": "U"}]})"s).result() == http::status::bad_request);
+      CHECK(post(*route, R"({"actions": [{"token": 1, "move": "U"}]})"s).result() == http::status::bad_request);
+      CHECK(post(*route, R"([])"s).result() == http::status::bad_request);
+    }
+  }
+
+  GIVEN("a single action endpoint") {
+    const auto single = action.route();
+
+    THEN("moves are validated the same way") {
+      for (const auto move : { ""sv, "U"sv, "D"sv, "L"sv, "R"sv, "X"sv, "u"sv, "LR"sv }) {
+        http_string_request_t req { http::verb::post, "/api/v1/game/player/action"sv, 11 };
+
+        req.set(http::field::content_type, "application/json"sv);
+        req.set(http::field::authorization, "Bearer "s + UNKNOWN_TOKEN);
+        req.body() = json::serialize(json::object { {"move"sv, move} });
+        req.prepare_payload();
+
+        // Неизвестный игрок отклоняется после разбора действия, поэтому 400 означает неверное действие
+        const auto single_response = std::get<http_string_response_t>(single->handler()(std::move(req)));
+        const auto batch_response = post(*route, actions(1u, UNKNOWN_TOKEN, move));
+
+        CHECK((single_response.result() == http::status::bad_request) == (batch_response.result() == http::status::bad_request));
+      }
+    }
+  }
+}
@@ -0,0 +1,106 @@
+#include "../src/admission.hpp"
+
+#include <catch2/catch_test_macros.hpp>
+
+using namespace std::literals;
+
+namespace net = boost::asio;
+
+SCENARIO("Connection admission") {
+  const auto now = admission::Clock::now();
+  const auto first = net::ip::make_address("10.0.0.1"sv);
+  const auto second = net::ip::make_address("10.0.0.2"sv);
+
+  GIVEN("a controller with connection limits") {
+    admission::Controller controller({ .max_connections = 3u, .max_connections_per_ip = 2u });
+
+    WHEN("an address opens more connections than allowed") {
+      auto [v1, t1] = controller.admit(first, now);
+      auto [v2, t2] = controller.admit(first, now);
+      auto [v3, t3] = controller.admit(first, now);
+
+      THEN("extra connections are rejected") {
+        CHECK(v1 == admission::Verdict::accepted);
+        CHECK(v2 == admission::Verdict::accepted);
+        CHECK(v3 == admission::Verdict::too_many_connections);
+        CHECK(t1);
+        CHECK_FALSE(t3);
+      }
+
+      AND_WHEN("another address connects beyond the global limit") {
+        auto [v4, t4] = controller.admit(second, now);
+        auto [v5, t5] = controller.admit(second, now);
+
+        THEN("the server is reported busy") {
+          CHECK(v4 == admission::Verdict::accepted);
+          CHECK(v5 == admission::Verdict::server_busy);
+
+          const auto stats = controller.stats();
+
+          CHECK(stats.connections == 3u);
+          CHECK(stats.accepted == 3u);
+          CHECK(stats.rejected_busy == 1u);
+          CHECK(stats.rejected_per_ip == 1u);
+        }
+      }
+
+      AND_WHEN("a connection is closed") {
+        { auto released = std::move(t1); }
+
+        THEN("the address may connect again") {
+          auto [verdict, ticket] = controller.admit(first, now);
+
+          CHECK(verdict == admission::Verdict::accepted);
+          CHECK(controller.stats().connections == 2u);
+        }
+      }
+    }
+  }
+
+  GIVEN("a controller with a request rate limit") {
+    admission::Controller controller({ .requests_per_second = 2.0, .request_burst = 3.0 });
+    auto [verdict, ticket] = controller.admit(first, now);
+
+    REQUIRE(verdict == admission::Verdict::accepted);
+
+    WHEN("requests exceed the burst") {
+      THEN("they are rejected until tokens are refilled") {
+        CHECK(ticket.allow_request(now));
+        CHECK(ticket.allow_request(now));
+        CHECK(ticket.allow_request(now));
+        CHECK_FALSE(ticket.allow_request(now));
+
+        CHECK(ticket.allow_request(now + 500ms));
+        CHECK_FALSE(ticket.allow_request(now + 500ms));
+
+        CHECK(controller.stats().rejected_requests == 2u);
+      }
+    }
+
+    WHEN("connections of one address share the bucket") {
+      auto [other_verdict, other] = controller.admit(first, now);
+
+      CHECK(ticket.allow_request(now));
+      CHECK(other.allow_request(now));
+      CHECK(ticket.allow_request(now));
+
+      THEN("the limit applies to the address") {
+        CHECK_FALSE(other.allow_request(now));
+      }
+    }
+
+    WHEN("the address disconnects and its bucket refills") {
+      CHECK(ticket.allow_request(now));
+      { auto released = std::move(ticket); }
+
+      controller.prune(now);
+      CHECK(controller.stats().addresses == 1u);
+
+      controller.prune(now + 1s);
+
+      THEN("its entry is removed") {
+        CHECK(controller.stats().addresses == 0u);
+      }
+    }
+  }
+}
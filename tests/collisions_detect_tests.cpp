@@ -180,4 +180,55 @@ SCENARIO("Collisions detect") {
     provider.clear_objects();
     provider.clear_gatherers();
   }
-}
\ No newline at end of file
+}
+
+SCENARIO("Batch collisions detect") {
+  GIVEN("objects around a gatherer path") {
+    // Количество объектов не кратно ширине векторов, чтобы проверить обработку остатка
+    constexpr std::size_t OBJECTS_COUNT = 203;
+
+    collisions::ObjectsBatch objects;
+
+    for (std::size_t i = 0; i < OBJECTS_COUNT; i++) {
+      const double t = static_cast<double>(i);
+      objects.add({ std::fmod(t * 0.37, 12.0) - 1.0, std::fmod(t * 0.61, 3.0) - 1.5 }, (i % 3) * 0.1);
+    }
+
+    // Объекты точно на концах отрезка и на границе радиуса сбора
+    objects.add({ 0.0, 0.0 }, 0.0);
+    objects.add({ 10.0, 0.0 }, 0.0);
+    objects.add({ 5.0, 0.6 }, 0.0);
+
+    const std::vector<collisions::Gatherer> gatherers {
+      { .start_pos = { 0.0, 0.0 }, .end_pos = { 10.0, 0.0 }, .width = 0.6, .id = 0 },
+      { .start_pos = { 3.0, -1.0 }, .end_pos = { 3.0, 1.0 }, .width = 0.3, .id = 1 },
+      { .start_pos = { -1.0, -1.0 }, .end_pos = { 9.5, 1.3 }, .width = 0.4, .id = 2 }
+    };
+
+    THEN("every supported kernel gives the same hits as the scalar check") {
+      for (const auto& gatherer : gatherers) {
+        collisions::HitMask expected;
+        collisions::find_hits(gatherer, objects, expected, collisions::Kernel::scalar);
+
+        for (std::size_t i = 0; i < objects.size(); i++) {
+          const auto result = collisions::try_collect_point(gatherer.start_pos, gatherer.end_pos, { objects.x[i], objects.y[i] });
+          const bool hit = (expected[i / 64] >> (i % 64)) & 1u;
+
+          REQUIRE(hit == result.is_collected(gatherer.width + objects.width[i]));
+        }
+
+        for (const auto kernel : { collisions::Kernel::sse2, collisions::Kernel::avx2 }) {
+          if (!collisions::is_supported(kernel)) {
+            continue;
+          }
+
+          collisions::HitMask hits;
+          collisions::find_hits(gatherer, objects, hits, kernel);
+
+          INFO("kernel: " << static_cast<int>(kernel) << ", gatherer: " << gatherer.id);
+          CHECK(hits == expected);
+        }
+      }
+    }
+  }
+}
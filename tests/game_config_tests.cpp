@@ -0,0 +1,158 @@
+#include "../src/game.hpp"
+
+#include <filesystem>
+
+#include <boost/asio/io_context.hpp>
+#include <boost/asio/post.hpp>
+#include <catch2/catch_test_macros.hpp>
+
+namespace net = boost::asio;
+
+using namespace std::literals;
+
+namespace {
+
+const model::Map::Id MAP_ID { "map1"s };
+
+model::Map make_map() {
+  model::Map map { MAP_ID, "Map 1"s };
+
+  map.add_road(model::Road(model::Road::HORIZONTAL, { 0.0, 0.0 }, 100.0));
+  map.add_loot_type("key", 10u);
+
+  return map;
+}
+
+model::GameConfig make_config(double speed, std::uint64_t bag_capacity, std::uint16_t max_players) {
+  model::GameConfig cfg;
+
+  cfg.randomize_spawn = false;
+  cfg.seed = 42u;
+  cfg.loot_generator = { .period = 5s, .probability = 0.0 };
+
+  cfg.map_character_speed[MAP_ID] = speed;
+  cfg.map_bag_capacity[MAP_ID] = bag_capacity;
+  cfg.map_max_players[MAP_ID] = max_players;
+
+  return cfg;
+}
+
+// Выполняет задачи, переданные на strand'ы сессий
+void run(net::io_context& io) {
+  io.restart();
+  io.run();
+}
+
+} // namespace
+
+SCENARIO("Game config reload") {
+  GIVEN("a game with a moving character") {
+    net::io_context io;
+
+    model::Game game(make_config(1.0, 3u, 8u));
+    game.add_map(make_map());
+    game.io_context(io);
+
+    const auto session = game.get_session(game.find_map(MAP_ID));
+    const auto [id, dog] = session->add_character(model::create_character<model::Dog>("Rex"sv, 3u));
+
+    net::post(session->strand(), [session, id = id] {
+      session->move_character(id, model::Character::Direction::east);
+    });
+
+    run(io);
+
+    WHEN("a new config is reloaded") {
+      auto next = make_config(2.0, 5u, 4u);
+      next.seed = 7u;
+
+      game.reload(std::move(next));
+
+      THEN("it is not applied before the next tick") {
+        CHECK(game.reload_pending());
+        CHECK(game.config()->map_character_speed.at(MAP_ID) == 1.0);
+        CHECK(session->config().characters_speed == 1.0);
+      }
+
+      AND_WHEN("the game ticks") {
+        game.refresh_state(10);
+        run(io);
+
+        THEN("running sessions use the new parameters") {
+          CHECK_FALSE(game.reload_pending());
+          CHECK(game.config()->map_character_speed.at(MAP_ID) == 2.0);
+
+          CHECK(session->config().characters_speed == 2.0);
+          CHECK(session->config().bag_capacity == 5u);
+          CHECK(session->config().max_players == 4u);
+
+          CHECK(dog->speed() == geom::Speed{2.0, 0.0});
+          CHECK(dog->bagpack.capacity() == 5u);
+        }
+
+        THEN("the seed is kept") {
+          CHECK(game.config()->seed == 42u);
+          CHECK(session->config().seed == session->seed());
+        }
+      }
+    }
+  }
+}
+
+SCENARIO("Game config reload is journaled") {
+  GIVEN("a game with a replay journal and a write-ahead log") {
+    const auto replay_path = std::filesystem::temp_directory_path() / "game_config_tests_replay.bin";
+    const auto wal_path = std::filesystem::temp_directory_path() / "game_config_tests_wal.bin";
+
+    std::filesystem::remove(wal_path);
+
+    {
+      net::io_context io;
+
+      model::Game game(make_config(1.0, 3u, 8u));
+      game.add_map(make_map());
+      game.io_context(io);
+      game.recorder(std::make_shared<replay::Recorder>(replay_path, false));
+      game.journal(std::make_shared<wal::Journal>(wal_path, 0ms));
+
+      game.get_session(game.find_map(MAP_ID));
+
+      game.reload(make_config(2.0, 5u, 4u));
+      game.refresh_state(10);
+      run(io);
+    }
+
+    THEN("the replay journal records the new session parameters") {
+      replay::Reader reader(replay_path);
+      std::optional<replay::Reconfigure> reconfigure;
+
+      while (const auto event = reader.next()) {
+        if (const auto e = std::get_if<replay::Reconfigure>(&*event)) {
+          reconfigure = *e;
+        }
+      }
+
+      REQUIRE(reconfigure.has_value());
+      CHECK(reconfigure->speed == 2.0);
+      CHECK(reconfigure->bag_capacity == 5u);
+      CHECK(reconfigure->max_players == 4u);
+    }
+
+    THEN("the write-ahead log records them too") {
+      std::optional<wal::Reconfigure> reconfigure;
+
+      wal::Journal::read(wal_path, [&reconfigure](wal::Journal::Seq, const wal::Event& event) {
+        if (const auto e = std::get_if<wal::Reconfigure>(&event)) {
+          reconfigure = *e;
+        }
+      });
+
+      REQUIRE(reconfigure.has_value());
+      CHECK(reconfigure->speed == 2.0);
+      CHECK(reconfigure->bag_capacity == 5u);
+    }
+
+    std::filesystem::remove(replay_path);
+    std::filesystem::remove(wal_path);
+  }
+}
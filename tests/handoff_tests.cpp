@@ -0,0 +1,100 @@
+#include "../src/handoff.hpp"
+
+#include <thread>
+#include <catch2/catch_test_macros.hpp>
+
+#include <sys/socket.h>
+#include <unistd.h>
+
+using namespace std::literals;
+
+SCENARIO("Listening sockets handoff") {
+  GIVEN("a connected pair of Unix sockets") {
+    int channel[2];
+    REQUIRE(::socketpair(AF_UNIX, SOCK_STREAM, 0, channel) == 0);
+
+    int pipe_fds[2];
+    REQUIRE(::pipe(pipe_fds) == 0);
+
+    WHEN("descriptors are sent over the channel") {
+      const int fds[] = { pipe_fds[0], pipe_fds[1] };
+      handoff::send_sockets(channel[0], fds);
+
+      const auto received = handoff::receive_sockets(channel[1]);
+
+      THEN("the receiver gets working duplicates") {
+        REQUIRE(received.size() == 2u);
+        CHECK(received[0] != pipe_fds[0]);
+
+        const char out = 'x';
+        char in = 0;
+
+        REQUIRE(::write(received[1], &out, 1) == 1);
+        REQUIRE(::read(pipe_fds[0], &in, 1) == 1);
+        CHECK(in == out);
+
+        for (const auto fd : received) {
+          ::close(fd);
+        }
+      }
+    }
+
+    WHEN("a message without descriptors is received") {
+      const char byte = 1;
+      REQUIRE(::write(channel[0], &byte, 1) == 1);
+
+      THEN("it is rejected") {
+        CHECK_THROWS(handoff::receive_sockets(channel[1]));
+      }
+    }
+
+    ::close(pipe_fds[0]);
+    ::close(pipe_fds[1]);
+    ::close(channel[0]);
+    ::close(channel[1]);
+  }
+
+  GIVEN("a handoff server") {
+    const auto path = std::filesystem::temp_directory_path() / "handoff_tests.sock";
+
+    handoff::net::io_context io;
+
+    int pipe_fds[2];
+    REQUIRE(::pipe(pipe_fds) == 0);
+
+    bool handed_off = false;
+
+    auto server = std::make_shared<handoff::Server>(io, path, 
+      [&pipe_fds] { return std::vector<int>{ pipe_fds[1] }; }, 
+      [&handed_off] { handed_off = true; });
+
+    server->run();
+
+    WHEN("a new process takes the sockets over") {
+      std::vector<int> received;
+
+      // take_over ждёт закрытия соединения, которое происходит при уничтожении сервера
+      std::thread client([&received, &path] {
+        received = handoff::take_over(path);
+      });
+
+      while (!handed_off) {
+        io.run_one();
+      }
+
+      server.reset();
+      client.join();
+
+      THEN("it receives them after the server goes away") {
+        CHECK(handed_off);
+        REQUIRE(received.size() == 1u);
+
+        ::close(received[0]);
+      }
+    }
+
+    ::close(pipe_fds[0]);
+    ::close(pipe_fds[1]);
+    std::filesystem::remove(path);
+  }
+}
@@ -0,0 +1,73 @@
+#include "../src/content_type.hpp"
+#include "../src/http_methods.hpp"
+#include "../src/character.hpp"
+
+#include <catch2/catch_test_macros.hpp>
+
+using namespace std::literals;
+
+namespace ct = content_type;
+namespace http = common::http;
+
+using http_methods::Method;
+using Direction = model::Character::Direction;
+
+static_assert(ct::get_as_text(ct::get_ext_as_type(".JPEG"sv)) == "image/jpeg"sv);
+static_assert(http_methods::AllowedMethod(Method::get | Method::head).is_allowed("HEAD"sv));
+static_assert(http_methods::AllowedMethod(Method::put | Method::get | Method::post | Method::head).as_string_view() == "GET, HEAD, POST, PUT"sv);
+static_assert(http_methods::AllowedMethod().as_string_view().empty());
+static_assert(Direction::from_letter(Direction(Direction::east).as_letter()) == Direction::east);
+
+SCENARIO("Content type lookup") {
+  GIVEN("file extensions") {
+    THEN("they are matched regardless of case and leading dot") {
+      CHECK(ct::get_ext_as_type(".html"sv) == ct::text_html);
+      CHECK(ct::get_ext_as_type("HTM"sv) == ct::text_html);
+      CHECK(ct::get_ext_as_type(".SvGz"sv) == ct::img_svg);
+      CHECK(ct::get_ext_as_type(".mp3"sv) == ct::audio_mpeg);
+      CHECK(ct::get_ext_as_type(".js"sv) == ct::text_javascript);
+    }
+
+    THEN("unknown extensions are treated as binary data") {
+      CHECK(ct::get_ext_as_type(""sv) == ct::app_octet_stream);
+      CHECK(ct::get_ext_as_type("."sv) == ct::app_octet_stream);
+      CHECK(ct::get_ext_as_type(".tar"sv) == ct::app_octet_stream);
+      CHECK(ct::get_ext_as_type(".jsonl"sv) == ct::app_octet_stream);
+    }
+  }
+
+  GIVEN("content types") {
+    THEN("each type has a MIME string") {
+      CHECK(ct::get_as_text(ct::app_json) == "application/json"sv);
+      CHECK(ct::get_as_text(ct::img_ico) == "image/vnd.microsoft.icon"sv);
+      CHECK_THROWS_AS(ct::get_as_text(static_cast<ct::Type>(15)), std::invalid_argument);
+    }
+  }
+}
+
+SCENARIO("Allowed HTTP methods") {
+  GIVEN("a route accepting GET and POST") {
+    const http_methods::AllowedMethod allowed(Method::post | Method::get);
+
+    THEN("methods are checked by name and by verb") {
+      CHECK(allowed.is_allowed("GET"sv));
+      CHECK(allowed.is_allowed(http::verb::post));
+      CHECK_FALSE(allowed.is_allowed("PUT"sv));
+      CHECK_FALSE(allowed.is_allowed("get"sv));
+      CHECK_FALSE(allowed.is_allowed(http::verb::delete_));
+    }
+
+    THEN("the Allow list has a fixed order") {
+      CHECK(allowed.as_string() == "GET, POST"s);
+      CHECK(http_methods::AllowedMethod(Method::head).as_string_view() == "HEAD"sv);
+    }
+  }
+}
+
+SCENARIO("Direction letters") {
+  THEN("letters round-trip through the direction table") {
+    for (const auto direct : { Direction::nomove, Direction::north, Direction::south, Direction::west, Direction::east }) {
+      CHECK(Direction::from_letter(Direction(direct).as_letter()) == direct);
+    }
+  }
+}
@@ -0,0 +1,166 @@
+#include "../src/leaderboard.hpp"
+
+#include <fstream>
+#include <catch2/catch_test_macros.hpp>
+
+using namespace std::literals;
+
+namespace {
+
+struct Fixture {
+  Fixture() {
+    std::filesystem::remove(path);
+  }
+
+  ~Fixture() {
+    std::filesystem::remove(path);
+  }
+
+  const std::filesystem::path path { std::filesystem::temp_directory_path() / "leaderboard_tests.bin" };
+};
+
+} // namespace
+
+SCENARIO_METHOD(Fixture, "Leaderboard") {
+  GIVEN("a leaderboard backed by a file") {
+    WHEN("records are pushed and flushed") {
+      {
+        leaderboard::Leaderboard board(path);
+
+        board.push({"Rex"s, 10u, 5000ms});
+        board.push({"Tim"s, 30u, 7000ms});
+        board.push({"Bob"s, 10u, 3000ms});
+
+        CHECK(board.size() == 0u);
+
+        board.flush();
+        board.push({"Max"s, 20u, 1000ms});
+      }
+
+      THEN("they are restored in rank order after reopening") {
+        leaderboard::Leaderboard board(path);
+        const auto records = board.page(0u, 10u);
+
+        REQUIRE(records.size() == 4u);
+
+        CHECK(records[0].name == "Tim"s);
+        CHECK(records[1].name == "Max"s);
+        CHECK(records[2].name == "Bob"s);
+        CHECK(records[3].name == "Rex"s);
+        CHECK(records[3].play_time == 5000ms);
+      }
+
+      THEN("pages are served from the index") {
+        leaderboard::Leaderboard board(path);
+
+        const auto page = board.page(1u, 2u);
+
+        REQUIRE(page.size() == 2u);
+        CHECK(page[0].name == "Max"s);
+        CHECK(page[1].name == "Bob"s);
+
+        CHECK(board.page(4u, 10u).empty());
+      }
+    }
+  }
+
+  GIVEN("a file with a torn segment at the end") {
+    {
+      leaderboard::Leaderboard board(path);
+
+      board.push({"Rex"s, 10u, 5000ms});
+      board.flush();
+    }
+
+    {
+      std::ofstream file(path, std::ios::binary | std::ios::app);
+      file.write("SLBG\x05", 5);
+    }
+
+    WHEN("records are appended after reopening") {
+      {
+        leaderboard::Leaderboard board(path);
+
+        board.push({"Tim"s, 30u, 7000ms});
+        board.flush();
+      }
+
+      THEN("they are restored on the next start") {
+        leaderboard::Leaderboard board(path);
+        const auto records = board.page(0u, 10u);
+
+        REQUIRE(records.size() == 2u);
+
+        CHECK(records[0].name == "Tim"s);
+        CHECK(records[1].name == "Rex"s);
+      }
+    }
+  }
+
+  GIVEN("a file with a corrupted record inside a complete segment") {
+    {
+      leaderboard::Leaderboard board(path);
+
+      board.push({"Rex"s, 10u, 5000ms});
+      board.flush();
+    }
+
+    {
+      // Сегмент из одной записи, длина имени которой выходит за границу сегмента
+      const std::uint32_t magic = 0x4742'4C53;
+      const std::uint32_t count = 1u;
+      const std::uint64_t payload_size = 20u;
+      const std::uint64_t score = 50u;
+      const std::uint64_t play_time = 1000u;
+      const std::uint32_t name_size = 100u;
+
+      std::ofstream file(path, std::ios::binary | std::ios::app);
+
+      file.write(reinterpret_cast<const char*>(&magic), sizeof(magic));
+      file.write(reinterpret_cast<const char*>(&count), sizeof(count));
+      file.write(reinterpret_cast<const char*>(&payload_size), sizeof(payload_size));
+      file.write(reinterpret_cast<const char*>(&score), sizeof(score));
+      file.write(reinterpret_cast<const char*>(&play_time), sizeof(play_time));
+      file.write(reinterpret_cast<const char*>(&name_size), sizeof(name_size));
+    }
+
+    WHEN("the leaderboard is reopened and records are appended") {
+      {
+        leaderboard::Leaderboard board(path);
+
+        CHECK(board.size() == 1u);
+
+        board.push({"Tim"s, 30u, 7000ms});
+        board.flush();
+      }
+
+      THEN("the corrupted segment is dropped and the new records are restored") {
+        leaderboard::Leaderboard board(path);
+        const auto records = board.page(0u, 10u);
+
+        REQUIRE(records.size() == 2u);
+
+        CHECK(records[0].name == "Tim"s);
+        CHECK(records[1].name == "Rex"s);
+      }
+    }
+  }
+
+  GIVEN("an in-memory leaderboard with a small index") {
+    leaderboard::Leaderboard board(std::nullopt, 2u);
+
+    for (std::uint64_t score = 1; score <= 5; score++) {
+      board.push({"Dog"s + std::to_string(score), score, 1000ms});
+    }
+
+    board.flush();
+
+    THEN("only the best records are kept") {
+      const auto records = board.page(0u, 10u);
+
+      REQUIRE(records.size() == 2u);
+      CHECK(records[0].score == 5u);
+      CHECK(records[1].score == 4u);
+    }
+  }
+}
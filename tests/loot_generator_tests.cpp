@@ -12,7 +12,8 @@ SCENARIO("Loot generation") {
   using TimeInterval = LootGenerator::TimeInterval;
 
   GIVEN("a loot generator") {
-    LootGenerator::instance().config({.period = 1s, .probability = 1.0});
+    LootGenerator generator({.period = 1s, .probability = 1.0});
+    const auto slot = generator.add();
 
     constexpr TimeInterval TIME_INTERVAL = 1s;
 
@@ -21,7 +22,7 @@ SCENARIO("Loot generation") {
         for (unsigned looters = 0; looters < 10; ++looters) {
           for (unsigned loot = looters; loot < looters + 10; ++loot) {
             INFO("loot count: " << loot << ", looters: " << looters);
-            REQUIRE(LootGenerator::instance().generate(TIME_INTERVAL, loot, looters) == 0);
+            REQUIRE(generator.generate(slot, TIME_INTERVAL, loot, looters) == 0);
           }
         }
       }
@@ -32,7 +33,7 @@ SCENARIO("Loot generation") {
         for (unsigned loot = 0; loot < 10; ++loot) {
           for (unsigned looters = loot; looters < loot + 10; ++looters) {
             INFO("loot count: " << loot << ", looters: " << looters);
-            REQUIRE(LootGenerator::instance().generate(TIME_INTERVAL, loot, looters) == looters - loot);
+            REQUIRE(generator.generate(slot, TIME_INTERVAL, loot, looters) == looters - loot);
           }
         }
       }
@@ -42,11 +43,12 @@ SCENARIO("Loot generation") {
   GIVEN("a loot generator with some probability") {
     constexpr TimeInterval BASE_INTERVAL = 1s;
 
-    LootGenerator::instance().config({.period = BASE_INTERVAL, .probability = 0.5});
+    LootGenerator generator({.period = BASE_INTERVAL, .probability = 0.5});
+    const auto slot = generator.add();
 
     WHEN("time is greater than base interval") {
       THEN("number of generated loot is increased") {
-        CHECK(LootGenerator::instance().generate(BASE_INTERVAL * 2, 0, 4) == 3);
+        CHECK(generator.generate(slot, BASE_INTERVAL * 2, 0, 4) == 3);
       }
     }
 
@@ -56,14 +58,14 @@ SCENARIO("Loot generation") {
             = std::chrono::duration_cast<TimeInterval>(std::chrono::duration<double>{
               1.0 / (std::log(1 - 0.5) / std::log(1.0 - 0.25))});
         
-        CHECK(LootGenerator::instance().generate(time_interval, 0, 4) == 1);
+        CHECK(generator.generate(slot, time_interval, 0, 4) == 1);
       }
     }
   }
 
   GIVEN("a loot generator with custom random generator") {
-    LootGenerator::instance().config({.period = 1s, .probability = 0.5});
-    LootGenerator::instance().generator([] { return 0.5; });
+    LootGenerator generator({.period = 1s, .probability = 0.5}, [] { return 0.5; });
+    const auto slot = generator.add();
 
     WHEN("loot is generated") {
       THEN("number of loot is proportional to random generated values") {
@@ -71,8 +73,52 @@ SCENARIO("Loot generation") {
             = std::chrono::duration_cast<TimeInterval>(std::chrono::duration<double>{
               1.0 / (std::log(1 - 0.5) / std::log(1.0 - 0.25))});
 
-        CHECK(LootGenerator::instance().generate(time_interval, 0, 4) == 0);
-        CHECK(LootGenerator::instance().generate(time_interval, 0, 4) == 1);
+        CHECK(generator.generate(slot, time_interval, 0, 4) == 0);
+        CHECK(generator.generate(slot, time_interval, 0, 4) == 1);
+      }
+    }
+  }
+
+  GIVEN("a loot generator with several sessions") {
+    LootGenerator generator({.period = 1s, .probability = 0.5});
+
+    const auto busy = generator.add();
+    const auto idle = generator.add();
+    const auto full = generator.add();
+
+    generator.counts(busy, 0, 4);
+    generator.counts(idle, 0, 4);
+    generator.counts(full, 4, 4);
+
+    WHEN("loot is generated for all sessions at once") {
+      generator.generate(1s);
+
+      THEN("each session gets its own amount") {
+        CHECK(generator.generated(busy) == 2);
+        CHECK(generator.generated(idle) == 2);
+        CHECK(generator.generated(full) == 0);
+      }
+
+      AND_WHEN("only one session resets its time without loot") {
+        generator.counts(idle, 4, 4);
+        generator.generate(1s);
+
+        generator.counts(busy, 0, 4);
+        generator.counts(idle, 0, 4);
+        generator.generate(1s);
+
+        THEN("time of other sessions is not affected") {
+          CHECK(generator.generated(busy) == 2);
+          CHECK(generator.generated(idle) == 3);
+        }
+      }
+    }
+
+    WHEN("a slot is removed") {
+      generator.remove(idle);
+
+      THEN("it is reused by the next session") {
+        CHECK(generator.add() == idle);
       }
     }
   }
@@ -0,0 +1,159 @@
+#include "../src/loot.hpp"
+#include "../src/game.hpp"
+#include "../src/json_loader.hpp"
+
+#include <filesystem>
+#include <fstream>
+#include <vector>
+
+#include <boost/asio/io_context.hpp>
+#include <boost/asio/post.hpp>
+#include <catch2/catch_test_macros.hpp>
+
+namespace net = boost::asio;
+
+using namespace std::literals;
+
+SCENARIO("Loot pool") {
+  GIVEN("an empty loot pool") {
+    model::LootPool pool;
+
+    const auto make_loot = [](model::Loot::Id id) {
+      return model::Loot { .id = id, .type = 0, .value = 10, .position = {1.0, 2.0} };
+    };
+
+    WHEN("loot is added") {
+      const auto h1 = pool.add(make_loot(1));
+      const auto h2 = pool.add(make_loot(2));
+
+      THEN("it is accessible by handle") {
+        CHECK(pool.size() == 2u);
+        CHECK(pool.get(h1).id == 1u);
+        CHECK(pool.get(h2).id == 2u);
+      }
+
+      AND_WHEN("loot is removed") {
+        pool.remove(h1);
+
+        THEN("its handle becomes invalid") {
+          CHECK(pool.size() == 1u);
+          CHECK_FALSE(pool.contains(h1));
+          CHECK_THROWS_AS(pool.get(h1), std::out_of_range);
+        }
+
+        THEN("the freed slot is reused by the next loot") {
+          const auto h3 = pool.add(make_loot(3));
+
+          CHECK(h3 == h1);
+          CHECK(pool.get(h3).id == 3u);
+        }
+
+        THEN("only the remaining loot is visited") {
+          std::vector<model::Loot::Id> ids;
+
+          pool.for_each([&ids](model::LootPool::Handle, const model::Loot& loot) {
+            ids.push_back(loot.id);
+          });
+
+          CHECK(ids == std::vector<model::Loot::Id>{2u});
+        }
+      }
+    }
+  }
+}
+
+SCENARIO("Map loot types") {
+  GIVEN("a map with loot types") {
+    model::Map map { model::Map::Id("map1"s), "Map 1"s };
+
+    map.add_road(model::Road(model::Road::HORIZONTAL, { 0.0, 0.0 }, 10.0));
+    map.add_loot_type("key"s, 10u);
+    map.add_loot_type("wallet"s, 30u);
+    map.add_loot_type("coin"s, 5u);
+
+    THEN("each type is indexed by its position in the table") {
+      const auto& types = map.get_loot_types();
+
+      REQUIRE(types.size() == 3u);
+
+      for (std::size_t i = 0; i < types.size(); ++i) {
+        CHECK(types[i].index == i);
+      }
+
+      CHECK(types[1].name == "wallet"s);
+      CHECK(types[1].value == 30u);
+    }
+
+    WHEN("a session spawns loot") {
+      net::io_context io;
+
+      model::GameSessionConfig cfg;
+      cfg.randomize_spawn = false;
+      cfg.seed = 42u;
+      cfg.characters_speed = 1.0;
+
+      auto session = std::make_shared<model::GameSession>(1u, cfg, map, net::make_strand(io));
+
+      net::post(session->strand(), [session] {
+        session->tick(0, 100u);
+      });
+
+      io.run();
+
+      THEN("loot refers to types within the table and takes their values") {
+        const auto& types = map.get_loot_types();
+
+        CHECK(session->lost_objects().size() == 100u);
+
+        session->lost_objects().for_each([&types](model::LootPool::Handle, const model::Loot& loot) {
+          REQUIRE(loot.type < types.size());
+          CHECK(loot.value == types[loot.type].value);
+        });
+      }
+    }
+  }
+
+  GIVEN("a config file with loot types") {
+    const auto path = std::filesystem::temp_directory_path() / "loot_types_tests.json";
+
+    {
+      std::ofstream file(path);
+
+      file << R"({
+        "lootGeneratorConfig": {"period": 5.0, "probability": 0.5},
+        "maps": [
+          {
+            "id": "map1", "name": "Map 1",
+            "lootTypes": [{"name": "key", "value": 10}, {"name": "wallet", "value": 30}],
+            "roads": [{"x0": 0, "y0": 0, "x1": 40}], "buildings": [], "offices": []
+          },
+          {
+            "id": "map2", "name": "Map 2",
+            "lootTypes": [{"name": "coin", "value": 5}],
+            "roads": [{"x0": 0, "y0": 0, "y1": 40}], "buildings": [], "offices": []
+          }
+        ]
+      })"sv;
+    }
+
+    THEN("each map gets its own typed table in file order") {
+      const auto game = json_loader::load_game(path, false, 1u);
+
+      const auto& first = game.find_map(model::Map::Id("map1"s))->get_loot_types();
+      const auto& second = game.find_map(model::Map::Id("map2"s))->get_loot_types();
+
+      REQUIRE(first.size() == 2u);
+      CHECK(first[0].index == 0u);
+      CHECK(first[0].name == "key"s);
+      CHECK(first[1].index == 1u);
+      CHECK(first[1].value == 30u);
+
+      REQUIRE(second.size() == 1u);
+      CHECK(second[0].index == 0u);
+      CHECK(second[0].name == "coin"s);
+      CHECK(second[0].value == 5u);
+    }
+
+    std::filesystem::remove(path);
+  }
+}
@@ -0,0 +1,158 @@
+#include "../src/game.hpp"
+
+#include <boost/asio/io_context.hpp>
+#include <catch2/catch_test_macros.hpp>
+
+namespace net = boost::asio;
+
+using namespace std::literals;
+
+namespace {
+
+const model::Map::Id SMALL_MAP_ID { "small"s };
+const model::Map::Id DEFAULT_MAP_ID { "default"s };
+
+model::Map make_map(const model::Map::Id& id) {
+  model::Map map { id, *id };
+  map.add_road(model::Road(model::Road::HORIZONTAL, { 0.0, 0.0 }, 10.0));
+
+  return map;
+}
+
+// На карте small помещается два игрока, для карты default ограничение не задано
+model::GameConfig make_config() {
+  model::GameConfig cfg;
+
+  cfg.randomize_spawn = false;
+  cfg.loot_generator = { .period = 5s, .probability = 0.0 };
+  cfg.session_idle_timeout = 1s;
+
+  cfg.map_character_speed[SMALL_MAP_ID] = 1.0;
+  cfg.map_character_speed[DEFAULT_MAP_ID] = 1.0;
+  cfg.map_max_players[SMALL_MAP_ID] = 2u;
+
+  return cfg;
+}
+
+struct Fixture {
+  Fixture() {
+    game.add_map(make_map(SMALL_MAP_ID));
+    game.add_map(make_map(DEFAULT_MAP_ID));
+    game.io_context(io);
+  }
+
+  ~Fixture() {
+    // Задачи тиков удерживают сессии, которые ссылаются на карты игры
+    io.run();
+  }
+
+  model::GameSession* place(const model::Map::Id& id) {
+    return game.get_session(game.find_map(id));
+  }
+
+  net::io_context io;
+  model::Game game { make_config() };
+};
+
+} // namespace
+
+SCENARIO_METHOD(Fixture, "Players placement") {
+  GIVEN("a map limited to two players per session") {
+    const auto first = place(SMALL_MAP_ID);
+
+    THEN("the next player joins the same session until it is full") {
+      CHECK(place(SMALL_MAP_ID) == first);
+      CHECK(place(SMALL_MAP_ID) != first);
+    }
+
+    WHEN("all sessions of the map are full") {
+      place(SMALL_MAP_ID);
+
+      const auto second = place(SMALL_MAP_ID);
+      place(SMALL_MAP_ID);
+
+      const auto third = place(SMALL_MAP_ID);
+
+      THEN("a new session is created") {
+        CHECK(second != first);
+        CHECK(third != first);
+        CHECK(third != second);
+
+        const auto stats = game.placement_stats();
+
+        CHECK(stats.placements == 5u);
+        CHECK(stats.sessions_created == 3u);
+        CHECK(stats.sessions == 3u);
+        CHECK(stats.players == 5u);
+        CHECK(stats.maps.at(SMALL_MAP_ID).sessions == 3u);
+        CHECK(stats.maps.at(SMALL_MAP_ID).players == 5u);
+      }
+
+      AND_WHEN("players leave the first session") {
+        game.leave_session(*first);
+        game.leave_session(*first);
+
+        THEN("it becomes the least occupied one") {
+          CHECK(place(SMALL_MAP_ID) == first);
+          CHECK(game.placement_stats().maps.at(SMALL_MAP_ID).players == 4u);
+        }
+      }
+    }
+  }
+
+  GIVEN("a map without its own limit") {
+    const auto first = place(DEFAULT_MAP_ID);
+
+    THEN("sessions take the default number of players") {
+      const auto max_players = model::GameSessionConfig{}.max_players;
+
+      for (std::uint16_t i = 1; i < max_players; ++i) {
+        REQUIRE(place(DEFAULT_MAP_ID) == first);
+      }
+
+      CHECK(place(DEFAULT_MAP_ID) != first);
+      CHECK(first->config().max_players == max_players);
+    }
+
+    THEN("placement on another map does not use its sessions") {
+      CHECK(place(SMALL_MAP_ID) != first);
+      CHECK(game.placement_stats().maps.size() == 2u);
+    }
+  }
+
+  GIVEN("a session left by all its players") {
+    const auto session = place(SMALL_MAP_ID);
+    game.leave_session(*session);
+
+    WHEN("it stays empty shorter than session_idle_timeout") {
+      game.refresh_state(500);
+
+      THEN("it is kept") {
+        CHECK(game.placement_stats().sessions == 1u);
+        CHECK(place(SMALL_MAP_ID) == session);
+      }
+    }
+
+    WHEN("it stays empty for session_idle_timeout") {
+      game.refresh_state(500);
+      game.refresh_state(500);
+
+      THEN("it is reclaimed") {
+        const auto stats = game.placement_stats();
+
+        CHECK(stats.sessions_reclaimed == 1u);
+        CHECK(stats.sessions == 0u);
+        CHECK(stats.players == 0u);
+        CHECK(game.sessions().empty());
+      }
+
+      AND_WHEN("a player joins the map again") {
+        place(SMALL_MAP_ID);
+
+        THEN("a new session is created") {
+          CHECK(game.placement_stats().sessions_created == 2u);
+        }
+      }
+    }
+  }
+}
@@ -0,0 +1,75 @@
+#include "../src/profiler.hpp"
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <cmath>
+
+using namespace std::literals;
+
+namespace {
+
+[[gnu::noinline]] double burn_cpu(int iterations) {
+  double sum = 0.0;
+
+  for (int i = 0; i < iterations; ++i) {
+    sum += std::sqrt(static_cast<double>(i));
+  }
+
+  return sum;
+}
+
+} // namespace
+
+SCENARIO("Sampling profiler") {
+  auto& profiler = profiler::Profiler::instance();
+
+  GIVEN("invalid parameters") {
+    THEN("profiling is not started") {
+      CHECK_THROWS_AS(profiler.start(0s), std::invalid_argument);
+      CHECK_THROWS_AS(profiler.start(1s, 0u), std::invalid_argument);
+      CHECK_THROWS_AS(profiler.start(1h), std::invalid_argument);
+    }
+  }
+
+  GIVEN("a running profiler") {
+    REQUIRE(profiler.start(10s, profiler::Profiler::MAX_FREQUENCY));
+
+    THEN("it cannot be started twice and has no stacks yet") {
+      CHECK_FALSE(profiler.start(1s));
+      CHECK(profiler.status().state == profiler::Profiler::State::running);
+      CHECK_FALSE(profiler.folded());
+    }
+
+    WHEN("the process consumes CPU time") {
+      volatile double sink = 0.0;
+      const auto deadline = std::chrono::steady_clock::now() + 5s;
+
+      while (profiler.status().samples < 10u && std::chrono::steady_clock::now() < deadline) {
+        sink = sink + burn_cpu(10000);
+      }
+
+      profiler.stop();
+
+      THEN("samples are folded into stacks") {
+        const auto status = profiler.status();
+
+        CHECK(status.state == profiler::Profiler::State::finished);
+        CHECK(status.samples >= 10u);
+
+        const auto stacks = profiler.folded();
+
+        REQUIRE(stacks);
+        REQUIRE_FALSE(stacks->empty());
+
+        // Каждая строка: кадры через ';', пробел и число выборок
+        const auto line = std::string_view(*stacks).substr(0, stacks->find('\n'));
+        const auto space = line.rfind(' ');
+
+        REQUIRE(space != std::string_view::npos);
+        CHECK(std::stoul(std::string(line.substr(space + 1))) > 0u);
+      }
+    }
+
+    profiler.stop();
+  }
+}
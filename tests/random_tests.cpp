@@ -0,0 +1,154 @@
+#include "../src/game.hpp"
+#include "../src/random.hpp"
+
+#include <vector>
+
+#include <boost/asio/io_context.hpp>
+#include <boost/asio/post.hpp>
+#include <catch2/catch_test_macros.hpp>
+
+namespace net = boost::asio;
+
+using namespace std::literals;
+
+static_assert(util::derive_seed(42u, 1u) == util::derive_seed(42u, 1u));
+static_assert(util::derive_seed(42u, 1u) != util::derive_seed(42u, 2u));
+static_assert(util::derive_seed(42u, 1u) != util::derive_seed(43u, 1u));
+
+namespace {
+
+const model::Map::Id MAP_ID { "map1"s };
+
+model::Map make_map() {
+  model::Map map { MAP_ID, "Map 1"s };
+
+  map.add_road(model::Road(model::Road::HORIZONTAL, { 0.0, 0.0 }, 1000.0));
+  map.add_road(model::Road(model::Road::VERTICAL, { 0.0, 0.0 }, 1000.0));
+  map.add_loot_type("key", 10u);
+  map.add_loot_type("wallet", 30u);
+  map.add_loot_type("coin", 5u);
+
+  return map;
+}
+
+model::GameConfig make_config(std::uint64_t seed) {
+  model::GameConfig cfg;
+
+  cfg.randomize_spawn = true;
+  cfg.seed = seed;
+  cfg.loot_generator = { .period = 5s, .probability = 0.0 };
+  cfg.map_character_speed[MAP_ID] = 1.0;
+  cfg.map_max_players[MAP_ID] = 1u;
+
+  return cfg;
+}
+
+// Позиции персонажей и трофеев сессии, которые зависят от её генератора
+struct SessionOutcome {
+  std::uint64_t seed;
+  geom::Position spawn;
+  std::vector<std::pair<model::Loot::Type, geom::Position>> loot;
+
+  bool operator==(const SessionOutcome&) const = default;
+};
+
+// Игра с players сессиями по одному игроку. В каждой сессии появляется по 20 трофеев
+std::vector<SessionOutcome> play(std::uint64_t seed, std::size_t players) {
+  net::io_context io;
+
+  model::Game game(make_config(seed));
+  game.add_map(make_map());
+  game.io_context(io);
+
+  std::vector<std::pair<model::GameSession*, std::shared_ptr<model::Character>>> sessions;
+
+  for (std::size_t i = 0; i < players; ++i) {
+    const auto session = game.get_session(game.find_map(MAP_ID));
+    auto [_, dog] = session->add_character(model::create_character<model::Dog>("Rex"sv, 3u));
+
+    net::post(session->strand(), [session] {
+      session->tick(0, 20u);
+    });
+
+    sessions.emplace_back(session, std::move(dog));
+  }
+
+  io.run();
+
+  std::vector<SessionOutcome> outcomes;
+
+  for (const auto& [session, dog] : sessions) {
+    SessionOutcome outcome { .seed = session->seed(), .spawn = dog->position(), .loot = {} };
+
+    session->lost_objects().for_each([&outcome](model::LootPool::Handle, const model::Loot& loot) {
+      outcome.loot.emplace_back(loot.type, loot.position);
+    });
+
+    outcomes.push_back(std::move(outcome));
+  }
+
+  return outcomes;
+}
+
+} // namespace
+
+SCENARIO("Seeded random generators") {
+  GIVEN("xoshiro generators") {
+    THEN("the same seed gives the same sequence") {
+      util::Xoshiro256 l(42u), r(42u);
+
+      for (int i = 0; i < 100; ++i) {
+        REQUIRE(l() == r());
+      }
+    }
+
+    THEN("different seeds give different sequences") {
+      util::Xoshiro256 l(42u), r(43u);
+      CHECK(l() != r());
+    }
+  }
+
+  GIVEN("a game engine on a map") {
+    const auto map = make_map();
+    const core::GameEngine engine(map);
+
+    THEN("positions depend only on the generator state") {
+      util::Xoshiro256 l(7u), r(7u);
+
+      for (int i = 0; i < 100; ++i) {
+        const auto pos = engine.generate_object_position(l);
+
+        REQUIRE(pos == engine.generate_object_position(r));
+        REQUIRE(map.get_road_by_position(pos) != nullptr);
+      }
+    }
+  }
+
+  GIVEN("games with the same seed") {
+    const auto first = play(42u, 3u);
+    const auto second = play(42u, 3u);
+
+    THEN("spawn and loot positions repeat") {
+      REQUIRE(first.size() == 3u);
+      CHECK(first == second);
+    }
+
+    THEN("sessions derive different streams") {
+      CHECK(first[0].seed != first[1].seed);
+      CHECK(first[1].seed != first[2].seed);
+
+      CHECK(first[0].spawn != first[1].spawn);
+      CHECK(first[0].loot != first[1].loot);
+    }
+  }
+
+  GIVEN("games with different seeds") {
+    THEN("sessions with the same id differ") {
+      const auto first = play(42u, 1u);
+      const auto second = play(43u, 1u);
+
+      CHECK(first[0].seed != second[0].seed);
+      CHECK(first[0].spawn != second[0].spawn);
+    }
+  }
+}
@@ -0,0 +1,82 @@
+#include "../src/replay.hpp"
+
+#include <fstream>
+#include <catch2/catch_test_macros.hpp>
+
+using namespace std::literals;
+
+namespace {
+
+struct Fixture {
+  Fixture() {
+    std::filesystem::remove(path);
+  }
+
+  ~Fixture() {
+    std::filesystem::remove(path);
+  }
+
+  const std::filesystem::path path { std::filesystem::temp_directory_path() / "replay_tests.bin" };
+};
+
+} // namespace
+
+SCENARIO_METHOD(Fixture, "Replay journal") {
+  GIVEN("a journal with recorded events") {
+    {
+      replay::Recorder recorder(path, true);
+
+      recorder.session_created(1u, 42u, "map1"sv);
+      recorder.join(1u, 7u, "Rex"sv);
+      recorder.move(1u, 7u, 3u);
+      recorder.tick(1u, 100, 2u);
+    }
+
+    WHEN("the journal is read") {
+      replay::Reader reader(path);
+
+      THEN("events are restored in the recorded order") {
+        CHECK(reader.randomize_spawn());
+
+        const auto created = reader.next();
+        REQUIRE(created.has_value());
+        REQUIRE(std::holds_alternative<replay::SessionCreated>(*created));
+        CHECK(std::get<replay::SessionCreated>(*created).seed == 42u);
+        CHECK(std::get<replay::SessionCreated>(*created).map_id == "map1"s);
+
+        const auto join = reader.next();
+        REQUIRE(join.has_value());
+        REQUIRE(std::holds_alternative<replay::Join>(*join));
+        CHECK(std::get<replay::Join>(*join).character == 7u);
+        CHECK(std::get<replay::Join>(*join).name == "Rex"s);
+
+        const auto move = reader.next();
+        REQUIRE(move.has_value());
+        REQUIRE(std::holds_alternative<replay::Move>(*move));
+        CHECK(std::get<replay::Move>(*move).direction == 3u);
+
+        const auto tick = reader.next();
+        REQUIRE(tick.has_value());
+        REQUIRE(std::holds_alternative<replay::Tick>(*tick));
+        CHECK(std::get<replay::Tick>(*tick).delta == 100);
+        CHECK(std::get<replay::Tick>(*tick).spawned == 2u);
+
+        CHECK_FALSE(reader.next().has_value());
+      }
+    }
+
+    WHEN("the last event is truncated") {
+      const auto size = std::filesystem::file_size(path);
+      std::filesystem::resize_file(path, size - 2);
+
+      replay::Reader reader(path);
+
+      THEN("reading stops before it") {
+        CHECK(reader.next().has_value());
+        CHECK(reader.next().has_value());
+        CHECK(reader.next().has_value());
+        CHECK_FALSE(reader.next().has_value());
+      }
+    }
+  }
+}
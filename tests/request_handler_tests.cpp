@@ -0,0 +1,277 @@
+#include "../src/request_handler.hpp"
+
+#include <functional>
+#include <thread>
+
+#include <boost/asio/io_context.hpp>
+#include <boost/log/sinks/basic_sink_backend.hpp>
+#include <boost/log/sinks/sync_frontend.hpp>
+#include <catch2/catch_test_macros.hpp>
+
+namespace net = boost::asio;
+namespace json = boost::json;
+namespace http = common::http;
+namespace logging = boost::log;
+namespace sinks = boost::log::sinks;
+
+using common::http_response_t;
+using common::http_string_request_t;
+using common::http_string_response_t;
+
+using namespace std::literals;
+
+namespace {
+
+const model::Map::Id MAP_ID { "map1"s };
+const auto TOKEN = "0123456789abcdef0123456789abcdef"s;
+
+model::Map make_map() {
+  model::Map map { MAP_ID, "Map 1"s };
+  map.add_road(model::Road(model::Road::HORIZONTAL, { 0.0, 0.0 }, 10.0));
+
+  return map;
+}
+
+model::GameConfig make_config() {
+  model::GameConfig cfg;
+
+  cfg.randomize_spawn = false;
+  cfg.loot_generator = { .period = 5s, .probability = 0.0 };
+  cfg.map_character_speed[MAP_ID] = 1.0;
+
+  return cfg;
+}
+
+// Собирает данные записей журнала об отправленных ответах
+class ResponseLog : public sinks::basic_sink_backend<sinks::synchronized_feeding> {
+public:
+  void consume(const logging::record_view& rec) {
+    if (rec[logging::expressions::smessage].get() == "response sent"sv) {
+      records.push_back(rec[data].get().as_object());
+    }
+  }
+
+  std::vector<json::object> records;
+};
+
+// Подключает ResponseLog к ядру журнала на время теста
+struct LogCapture {
+  LogCapture()
+    : backend(boost::make_shared<ResponseLog>())
+    , sink(boost::make_shared<sinks::synchronous_sink<ResponseLog>>(backend)) {
+    logging::core::get()->add_sink(sink);
+  }
+
+  ~LogCapture() {
+    logging::core::get()->remove_sink(sink);
+  }
+
+  boost::shared_ptr<ResponseLog> backend;
+  boost::shared_ptr<sinks::synchronous_sink<ResponseLog>> sink;
+};
+
+// Контекст, на котором выполняются задачи, определяется по тому,
+// какой из контекстов запущен в момент выполнения
+struct Fixture {
+  Fixture() {
+    game.add_map(make_map());
+    game.io_contexts({ &contexts[0], &contexts[1] });
+
+    session = game.get_session(game.find_map(MAP_ID));
+    auto [id, dog] = session->add_character(model::create_character<model::Dog>("Rex"sv, 3u));
+
+    character = dog;
+    app::Players::instance().add_player(TOKEN, std::make_unique<app::Player>(id, dog, *session));
+
+    run_all();
+  }
+
+  ~Fixture() {
+    app::Players::instance().remove(*character);
+  }
+
+  void run_all() {
+    for (int k = 0; k < 2; ++k) {
+      running = k;
+      contexts[k].restart();
+      contexts[k].run();
+    }
+
+    running = -1;
+  }
+
+  // Маршрут, обработчик которого запоминает контекст и strand, на котором он выполнен
+  std::unique_ptr<mux::Route> make_route(std::string_view path, bool session_bound) {
+    auto route = std::make_unique<mux::Route>();
+
+    route->path(path);
+    route->methods(http_methods::Method::get);
+    route->session_bound(session_bound);
+    route->handler_func([this](http_string_request_t&& req) -> http_response_t {
+      handled_on = running;
+      on_session_strand = session->strand().running_in_this_thread();
+
+      return http_string_response_t { http::status::ok, req.version() };
+    });
+
+    return route;
+  }
+
+  std::shared_ptr<http_handler::RequestHandler> make_handler() {
+    mux::Router router;
+
+    router.set_route(make_route("^/api/v1/session$"sv, true));
+    router.set_route(make_route("^/api/v1/common$"sv, false));
+
+    return std::make_shared<http_handler::RequestHandler>(net::make_strand(contexts[0]), std::move(router));
+  }
+
+  unsigned get(http_handler::RequestHandler& handler, std::string_view target, bool authorized) {
+    http_string_request_t req { http::verb::get, target, 11 };
+
+    if (authorized) {
+      req.set(http::field::authorization, "Bearer "s + TOKEN);
+    }
+
+    unsigned status = 0u;
+
+    handler(std::move(req), span, [&status](auto&& response) {
+      status = response.result_int();
+    });
+
+    run_all();
+
+    return status;
+  }
+
+  net::io_context contexts[2];
+  model::Game game { make_config() };
+
+  model::GameSession* session { nullptr };
+  std::shared_ptr<model::Character> character;
+
+  tracing::Span span;
+
+  int running { -1 };
+  int handled_on { -1 };
+  bool on_session_strand { false };
+};
+
+} // namespace
+
+SCENARIO_METHOD(Fixture, "Request strands") {
+  GIVEN("a player whose session runs on the second io_context") {
+    REQUIRE(&game.io_context(session->id()) == &contexts[1]);
+
+    const auto handler = make_handler();
+
+    WHEN("a session-bound route is requested with the player's token") {
+      const auto status = get(*handler, "/api/v1/session"sv, true);
+
+      THEN("the handler runs on the session strand of the owning context") {
+        CHECK(status == 200u);
+        CHECK(handled_on == 1);
+        CHECK(on_session_strand);
+      }
+    }
+
+    WHEN("a session-bound route is requested without a token") {
+      get(*handler, "/api/v1/session"sv, false);
+
+      THEN("the handler runs on the API strand") {
+        CHECK(handled_on == 0);
+        CHECK_FALSE(on_session_strand);
+      }
+    }
+
+    WHEN("another API route is requested by the player") {
+      get(*handler, "/api/v1/common"sv, true);
+
+      THEN("the handler runs on the API strand") {
+        CHECK(handled_on == 0);
+        CHECK_FALSE(on_session_strand);
+      }
+    }
+  }
+}
+
+SCENARIO_METHOD(Fixture, "Response logging") {
+  GIVEN("a logging handler over the request handler") {
+    LogCapture log;
+
+    const auto handler = make_handler();
+
+    http_handler::LoggingRequestHandler logging_handler {
+      [handler](auto&& req, tracing::Span& span, auto&& send) {
+        (*handler)(std::forward<decltype(req)>(req), span, std::forward<decltype(send)>(send));
+      }
+    };
+
+    // Запись ответа завершается только по вызову complete_write, как после async_write
+    unsigned status = 0u;
+    std::string content_type;
+    std::function<void()> complete_write;
+
+    auto request = [&](std::string_view target) {
+      http_string_request_t req { http::verb::get, target, 11 };
+
+      logging_handler({}, std::move(req), span, [&](auto&& response, auto&& on_written) {
+        status = response.result_int();
+        content_type = response[http::field::content_type];
+
+        // Ответы с файлами не копируются, а std::function требует копируемой функции
+        auto written = std::make_shared<std::decay_t<decltype(response)>>(std::move(response));
+
+        complete_write = [written, on_written]() {
+          on_written(http_server::ResponseInfo {
+            .status = written->result_int(),
+            .content_type = (*written)[http::field::content_type],
+            .body_size = written->payload_size().value_or(0u),
+            .bytes_written = 0u
+          });
+        };
+      });
+
+      run_all();
+    };
+
+    WHEN("a response is formed") {
+      request("/api/v1/unknown"sv);
+
+      THEN("it is not logged before the write completes") {
+        REQUIRE(complete_write);
+        CHECK(log.backend->records.empty());
+      }
+
+      AND_WHEN("the write completes") {
+        std::this_thread::sleep_for(20ms);
+        complete_write();
+
+        THEN("the logged status and content type are those of the written response") {
+          REQUIRE(log.backend->records.size() == 1u);
+
+          const auto& record = log.backend->records.front();
+
+          CHECK(status == 400u);
+          CHECK(record.at("code"sv).to_number<unsigned>() == status);
+          CHECK(std::string_view(record.at("content_type"sv).as_string()) == content_type);
+        }
+
+        THEN("the response time includes the write") {
+          REQUIRE(log.backend->records.size() == 1u);
+          CHECK(log.backend->records.front().at("response_time"sv).to_number<std::int64_t>() >= 20);
+        }
+      }
+    }
+
+    WHEN("a session-bound response is written") {
+      request("/api/v1/session"sv);
+      complete_write();
+
+      THEN("it is logged once with its own status") {
+        REQUIRE(log.backend->records.size() == 1u);
+        CHECK(log.backend->records.front().at("code"sv).to_number<unsigned>() == 200u);
+      }
+    }
+  }
+}
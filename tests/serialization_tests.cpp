@@ -1,15 +1,8 @@
 #include "../src/serialization.hpp"
 
 #include <sstream>
-#include <boost/serialization/export.hpp>
 #include <catch2/catch_test_macros.hpp>
 
-// Для корректной (де-)сериализации абстрактного класса 
-// и его наследников нужно объявить следующие макросы
-BOOST_SERIALIZATION_ASSUME_ABSTRACT(model::Loot);
-BOOST_CLASS_EXPORT(model::Wallet);
-BOOST_CLASS_EXPORT(model::Key);
-
 using namespace std::literals;
 using namespace serialization;
 
@@ -77,22 +70,15 @@ SCENARIO_METHOD(Fixture, "Dog serialization") {
     constexpr auto BAGPACK_CAP = 3u;
     auto dog = model::create_character<model::Dog>("Tim"sv, BAGPACK_CAP);
 
-    auto loot1 = model::create_loot("key"sv, 0, 5);
-    loot1->position({1.0, -2.67});
-
-    auto loot2 = model::create_loot("key"sv, 0, 5);
-    loot2->position({-12.98, 4.11});
-
-    auto loot3 = model::create_loot("key"sv, 0, 5);
-    loot3->position({0.0, 0.0});
-
-    auto loot4 = model::create_loot("key"sv, 0, 5); // Не должен быть добавлен
-    loot4->position({22.13, -10.63});
+    const model::Loot loot1 { .id = 1, .type = 0, .value = 5, .position = {1.0, -2.67} };
+    const model::Loot loot2 { .id = 2, .type = 1, .value = 5, .position = {-12.98, 4.11} };
+    const model::Loot loot3 { .id = 3, .type = 0, .value = 10, .position = {0.0, 0.0} };
+    const model::Loot loot4 { .id = 4, .type = 0, .value = 5, .position = {22.13, -10.63} }; // Не должен быть добавлен
 
-    dog->bagpack.add(1, std::move(loot1));
-    dog->bagpack.add(2, std::move(loot2));
-    dog->bagpack.add(3, std::move(loot3));
-    dog->bagpack.add(4, std::move(loot4));
+    dog->bagpack.add(loot1);
+    dog->bagpack.add(loot2);
+    dog->bagpack.add(loot3);
+    dog->bagpack.add(loot4);
 
     CHECK(dog->bagpack.size() == BAGPACK_CAP);
 
@@ -116,16 +102,16 @@ SCENARIO_METHOD(Fixture, "Dog serialization") {
 
         const auto& bench_bagpack = dog->bagpack.get();
 
-        CHECK(bench_bagpack.size() == dogser.bagpack().size());
+        REQUIRE(bench_bagpack.size() == dogser.bagpack().size());
 
-        for (const auto& [id, loot] : dogser.bagpack().get()) {   
-          const auto it = bench_bagpack.find(id);
+        for (std::size_t i = 0; i < bench_bagpack.size(); i++) {   
+          const auto& bench_loot = bench_bagpack[i];
+          const auto& loot = dogser.bagpack().get()[i];
 
-          CHECK(it != bench_bagpack.cend());
-          CHECK(it->second->name() == loot->name());
-          CHECK(it->second->position() == loot->position());
-          CHECK(it->second->type() == loot->type());
-          CHECK(it->second->value() == loot->value());
+          CHECK(bench_loot.id == loot.id);
+          CHECK(bench_loot.position == loot.position);
+          CHECK(bench_loot.type == loot.type);
+          CHECK(bench_loot.value == loot.value);
         }
 
         CHECK(dog->score() == dogser.score());
@@ -0,0 +1,181 @@
+#include "../src/game.hpp"
+
+#include <atomic>
+#include <thread>
+#include <vector>
+
+#include <boost/asio/io_context.hpp>
+#include <boost/asio/post.hpp>
+#include <catch2/catch_test_macros.hpp>
+
+namespace net = boost::asio;
+
+using namespace std::literals;
+
+namespace {
+
+const model::Map::Id MAP_ID { "map1"s };
+
+constexpr std::size_t THREADS { 4u };
+constexpr std::size_t PLAYERS { 4u };
+constexpr std::size_t TASKS { 1000u };
+
+model::Map make_map() {
+  model::Map map { MAP_ID, "Map 1"s };
+  map.add_road(model::Road(model::Road::HORIZONTAL, { 0.0, 0.0 }, 10.0));
+
+  return map;
+}
+
+// В сессии помещается PLAYERS игроков, поэтому вторая сессия создаётся после заполнения первой
+model::GameConfig make_config() {
+  model::GameConfig cfg;
+
+  cfg.randomize_spawn = false;
+  cfg.loot_generator = { .period = 5s, .probability = 0.0 };
+  cfg.map_character_speed[MAP_ID] = 1.0;
+  cfg.map_max_players[MAP_ID] = PLAYERS;
+
+  return cfg;
+}
+
+// Задачи одной сессии, выполненные на её strand'е
+struct SessionLog {
+  std::vector<std::size_t> order;
+  std::vector<std::size_t> visible_characters;
+
+  std::atomic<bool> running { false };
+  std::atomic<bool> overlapped { false };
+};
+
+void run(net::io_context& io) {
+  std::vector<std::jthread> threads;
+
+  for (std::size_t i = 0; i < THREADS; ++i) {
+    threads.emplace_back([&io] { io.run(); });
+  }
+}
+
+} // namespace
+
+SCENARIO("Game session strands") {
+  GIVEN("two sessions on a multi-threaded io_context") {
+    net::io_context io;
+
+    model::Game game(make_config());
+    game.add_map(make_map());
+    game.io_context(io);
+
+    std::vector<model::GameSession*> sessions;
+    std::vector<model::Character::Id> joined;
+
+    for (std::size_t i = 0; i < 2 * PLAYERS; ++i) {
+      const auto session = game.get_session(game.find_map(MAP_ID));
+
+      if (sessions.empty() || sessions.back() != session) {
+        sessions.push_back(session);
+      }
+    }
+
+    REQUIRE(sessions.size() == 2u);
+
+    WHEN("characters join and tasks are posted to session strands") {
+      SessionLog logs[2];
+
+      for (std::size_t task = 0; task < TASKS; ++task) {
+        for (std::size_t s = 0; s < sessions.size(); ++s) {
+          const auto session = sessions[s];
+          auto& log = logs[s];
+
+          if (task < PLAYERS) {
+            session->add_character(model::create_character<model::Dog>("Rex"sv, 3u));
+          }
+
+          net::post(session->strand(), [session, &log, task] {
+            if (log.running.exchange(true)) {
+              log.overlapped = true;
+            }
+
+            log.order.push_back(task);
+            log.visible_characters.push_back(session->characters().size());
+
+            log.running = false;
+          });
+        }
+      }
+
+      run(io);
+
+      THEN("each session runs its tasks one at a time in the posted order") {
+        for (const auto& log : logs) {
+          CHECK_FALSE(log.overlapped);
+
+          REQUIRE(log.order.size() == TASKS);
+
+          for (std::size_t task = 0; task < TASKS; ++task) {
+            REQUIRE(log.order[task] == task);
+          }
+        }
+      }
+
+      THEN("a join is visible to tasks posted after add_character") {
+        for (const auto& log : logs) {
+          for (std::size_t task = 0; task < TASKS; ++task) {
+            REQUIRE(log.visible_characters[task] == std::min(task + 1, PLAYERS));
+          }
+        }
+
+        for (const auto session : sessions) {
+          CHECK(session->characters().size() == PLAYERS);
+        }
+      }
+    }
+  }
+}
+
+SCENARIO("Game sessions on several io_contexts") {
+  GIVEN("a game with three io_contexts") {
+    net::io_context contexts[3];
+
+    model::GameConfig cfg = make_config();
+    cfg.map_max_players[MAP_ID] = 1u;
+
+    model::Game game(std::move(cfg));
+    game.add_map(make_map());
+    game.io_contexts({ &contexts[0], &contexts[1], &contexts[2] });
+
+    std::vector<model::GameSession*> sessions;
+
+    for (int i = 0; i < 6; ++i) {
+      sessions.push_back(game.get_session(game.find_map(MAP_ID)));
+    }
+
+    THEN("sessions are spread over the contexts in id order") {
+      for (const auto session : sessions) {
+        CHECK(&session->strand().get_inner_executor().context() == &contexts[session->id() % 3]);
+        CHECK(&game.io_context(session->id()) == &contexts[session->id() % 3]);
+      }
+    }
+
+    THEN("session tasks run only on the owning context") {
+      std::vector<int> ran_on(sessions.size(), -1);
+      int running = -1;
+
+      for (std::size_t i = 0; i < sessions.size(); ++i) {
+        net::post(sessions[i]->strand(), [&ran_on, &running, i] {
+          ran_on[i] = running;
+        });
+      }
+
+      for (int k = 0; k < 3; ++k) {
+        running = k;
+        contexts[k].run();
+
+        for (std::size_t i = 0; i < sessions.size(); ++i) {
+          const auto owner = static_cast<int>(sessions[i]->id() % 3);
+          CHECK(ran_on[i] == (owner <= k ? owner : -1));
+        }
+      }
+    }
+  }
+}
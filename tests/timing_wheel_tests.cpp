@@ -0,0 +1,72 @@
+#include "../src/timing_wheel.hpp"
+
+#include <vector>
+#include <catch2/catch_test_macros.hpp>
+
+using namespace std::literals;
+
+SCENARIO("Timing wheel") {
+  using Wheel = util::TimingWheel<int>;
+
+  GIVEN("a timing wheel with 100ms resolution and 4 slots") {
+    Wheel wheel {100ms, 4u};
+    std::vector<int> fired;
+
+    const auto collect = [&fired](int value) {
+      fired.push_back(value);
+    };
+
+    WHEN("timer is shorter than one revolution") {
+      wheel.schedule(1, 250ms);
+
+      THEN("it fires once its delay has elapsed") {
+        wheel.advance(200ms, collect);
+        CHECK(fired.empty());
+
+        wheel.advance(100ms, collect);
+        CHECK(fired == std::vector{1});
+        CHECK(wheel.size() == 0u);
+      }
+    }
+
+    WHEN("timer is longer than one revolution") {
+      wheel.schedule(2, 1000ms);
+
+      THEN("it survives the full revolutions") {
+        wheel.advance(900ms, collect);
+        CHECK(fired.empty());
+
+        wheel.advance(100ms, collect);
+        CHECK(fired == std::vector{2});
+      }
+    }
+
+    WHEN("time is advanced by small deltas") {
+      wheel.advance(50ms, collect);
+      wheel.schedule(3, 100ms);
+
+      THEN("the partially elapsed slot is taken into account") {
+        wheel.advance(50ms, collect);
+        CHECK(fired.empty());
+
+        wheel.advance(50ms, collect);
+        CHECK(fired.empty());
+
+        wheel.advance(50ms, collect);
+        CHECK(fired == std::vector{3});
+      }
+    }
+
+    WHEN("several timers share a slot") {
+      wheel.schedule(4, 100ms);
+      wheel.schedule(5, 100ms);
+      wheel.schedule(6, 500ms);
+
+      THEN("only due timers fire") {
+        wheel.advance(100ms, collect);
+        CHECK(fired.size() == 2u);
+        CHECK(wheel.size() == 1u);
+      }
+    }
+  }
+}
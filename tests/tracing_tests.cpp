@@ -0,0 +1,125 @@
+#include "../src/tracing.hpp"
+
+#include <catch2/catch_test_macros.hpp>
+
+using namespace std::literals;
+
+SCENARIO("Stage histograms") {
+  GIVEN("a histogram") {
+    tracing::Histogram histogram;
+
+    WHEN("durations are added") {
+      histogram.add(500ns);
+      histogram.add(3us);
+      histogram.add(3us);
+      histogram.add(100ms);
+
+      THEN("they fall into power-of-two buckets") {
+        CHECK(tracing::Histogram::bucket(500ns) == 0u);
+        CHECK(tracing::Histogram::bucket(1us) == 1u);
+        CHECK(tracing::Histogram::bucket(3us) == 2u);
+        CHECK(tracing::Histogram::bucket(1h) == tracing::Histogram::BUCKETS - 1u);
+
+        const auto snapshot = histogram.snapshot();
+
+        CHECK(snapshot.count == 4u);
+        CHECK(snapshot.buckets[0] == 1u);
+        CHECK(snapshot.buckets[2] == 2u);
+        CHECK(snapshot.percentile(0.5) == 4us);
+        CHECK(snapshot.percentile(1.0) == 131072us);
+      }
+    }
+  }
+}
+
+SCENARIO("Request tracing") {
+  auto& tracer = tracing::Tracer::instance();
+
+  GIVEN("disabled tracing") {
+    tracer.disable();
+    tracer.reset();
+
+    tracing::Span span;
+    span.begin("/api/v1/maps"sv);
+    span.finish(200u);
+
+    THEN("nothing is recorded") {
+      CHECK_FALSE(span.active());
+      CHECK(tracer.stats().requests == 0u);
+    }
+  }
+
+  GIVEN("enabled tracing with a small buffer") {
+    tracer.enable(16u);
+    tracer.reset();
+
+    WHEN("a request passes all stages") {
+      tracing::Span span;
+
+      span.begin("/api/v1/game/state?x=1"sv);
+      span.mark(tracing::Stage::routed);
+      span.mark(tracing::Stage::strand);
+      span.mark(tracing::Stage::handled);
+      span.mark(tracing::Stage::write_start);
+
+      const auto id = span.record().id;
+      span.finish(200u);
+
+      THEN("its stages are aggregated and kept in the buffer") {
+        const auto stats = tracer.stats();
+
+        CHECK(stats.enabled);
+        CHECK(stats.requests == 1u);
+
+        for (const auto& interval : stats.intervals) {
+          CHECK(interval.count == 1u);
+        }
+
+        const auto records = tracer.recent();
+
+        REQUIRE(records.size() == 1u);
+        CHECK(records.front().id == id);
+        CHECK(records.front().status == 200u);
+        CHECK(records.front().target_view() == "/api/v1/game/state"sv);
+        CHECK(records.front().duration(tracing::Interval::total) >= records.front().duration(tracing::Interval::queue));
+      }
+    }
+
+    WHEN("a request skips routing") {
+      tracing::Span span;
+
+      span.begin("/api/v1/maps"sv);
+      span.mark(tracing::Stage::write_start);
+      span.finish(429u);
+
+      THEN("only the stages it passed are aggregated") {
+        const auto stats = tracer.stats();
+
+        CHECK(stats.intervals[static_cast<std::size_t>(tracing::Interval::queue)].count == 0u);
+        CHECK(stats.intervals[static_cast<std::size_t>(tracing::Interval::write)].count == 1u);
+        CHECK(stats.intervals[static_cast<std::size_t>(tracing::Interval::total)].count == 1u);
+      }
+    }
+
+    WHEN("more requests are traced than the buffer holds") {
+      for (int i = 0; i < 100; ++i) {
+        tracing::Span span;
+        span.begin("/"sv);
+        span.finish(200u);
+      }
+
+      THEN("only the most recent ones are kept") {
+        const auto records = tracer.recent();
+
+        CHECK(records.size() == 16u);
+        CHECK(tracer.stats().requests == 100u);
+
+        for (std::size_t i = 1; i < records.size(); ++i) {
+          CHECK(records[i - 1].id < records[i].id);
+        }
+      }
+    }
+
+    tracer.disable();
+  }
+}
@@ -0,0 +1,183 @@
+#include "../src/wal.hpp"
+
+#include <fstream>
+#include <future>
+#include <catch2/catch_test_macros.hpp>
+
+using namespace std::literals;
+
+namespace {
+
+struct Fixture {
+  Fixture() {
+    remove();
+  }
+
+  ~Fixture() {
+    remove();
+  }
+
+  void remove() const {
+    std::filesystem::remove(path);
+    std::filesystem::remove(wal::Journal::rotated_path(path));
+  }
+
+  std::vector<std::pair<wal::Journal::Seq, wal::Event>> read(const std::filesystem::path& file) const {
+    std::vector<std::pair<wal::Journal::Seq, wal::Event>> events;
+
+    wal::Journal::read(file, [&events](wal::Journal::Seq seq, const wal::Event& event) {
+      events.emplace_back(seq, event);
+    });
+
+    return events;
+  }
+
+  const std::filesystem::path path { std::filesystem::temp_directory_path() / "wal_tests.bin" };
+};
+
+} // namespace
+
+SCENARIO_METHOD(Fixture, "Write-ahead journal") {
+  GIVEN("a journal with appended events") {
+    {
+      wal::Journal journal(path, 0ms);
+      journal.next_seq(10u);
+
+      CHECK(journal.append(wal::SessionCreated{ 1u, 42u, "map1"s }) == 10u);
+      CHECK(journal.append(wal::Join{ 1u, 7u, "Rex"s, { 1.5, 2.5 } }) == 11u);
+      CHECK(journal.append(wal::Move{ 1u, 7u, 3u }) == 12u);
+      CHECK(journal.good());
+    }
+
+    WHEN("the journal is read") {
+      const auto events = read(path);
+
+      THEN("events are restored with their sequence numbers") {
+        REQUIRE(events.size() == 3u);
+
+        CHECK(events[0].first == 10u);
+        REQUIRE(std::holds_alternative<wal::SessionCreated>(events[0].second));
+        CHECK(std::get<wal::SessionCreated>(events[0].second).seed == 42u);
+        CHECK(std::get<wal::SessionCreated>(events[0].second).map_id == "map1"s);
+
+        REQUIRE(std::holds_alternative<wal::Join>(events[1].second));
+        CHECK(std::get<wal::Join>(events[1].second).name == "Rex"s);
+        CHECK(std::get<wal::Join>(events[1].second).position.y == 2.5);
+
+        CHECK(events[2].first == 12u);
+        REQUIRE(std::holds_alternative<wal::Move>(events[2].second));
+        CHECK(std::get<wal::Move>(events[2].second).direction == 3u);
+      }
+    }
+
+    WHEN("the last record is truncated") {
+      const auto size = std::filesystem::file_size(path);
+      std::filesystem::resize_file(path, size - 1);
+
+      THEN("only complete records are read") {
+        CHECK(read(path).size() == 2u);
+      }
+    }
+
+    WHEN("a record header with a huge size follows") {
+      {
+        std::ofstream file(path, std::ios::binary | std::ios::app);
+
+        const std::uint32_t header[] { 0xFFFF'FFF0u, 0u };
+        file.write(reinterpret_cast<const char*>(header), sizeof(header));
+      }
+
+      THEN("reading stops at that header") {
+        CHECK(read(path).size() == 3u);
+      }
+    }
+  }
+
+  GIVEN("a rotated journal") {
+    {
+      wal::Journal journal(path, 100ms);
+
+      journal.append(wal::Retire{ 1u, 2u });
+      journal.rotate();
+      journal.append(wal::Score{ 1u, 3u, 50u });
+    }
+
+    THEN("events before the rotation are in the rotated file") {
+      const auto rotated = read(wal::Journal::rotated_path(path));
+      const auto current = read(path);
+
+      REQUIRE(rotated.size() == 1u);
+      CHECK(std::holds_alternative<wal::Retire>(rotated[0].second));
+
+      REQUIRE(current.size() == 1u);
+      CHECK(current[0].first == 2u);
+      CHECK(std::get<wal::Score>(current[0].second).score == 50u);
+    }
+  }
+
+  GIVEN("a journal rotated asynchronously") {
+    {
+      wal::Journal journal(path, 100ms);
+      std::promise<void> rotated;
+
+      journal.append(wal::Retire{ 1u, 2u });
+      journal.rotate([&rotated] { rotated.set_value(); });
+
+      REQUIRE(rotated.get_future().wait_for(5s) == std::future_status::ready);
+      journal.append(wal::Score{ 1u, 3u, 50u });
+    }
+
+    THEN("the handler is called after the switch") {
+      CHECK(read(wal::Journal::rotated_path(path)).size() == 1u);
+      CHECK(read(path).size() == 1u);
+    }
+  }
+
+  GIVEN("a rotated file left by a failed save") {
+    {
+      wal::Journal journal(path, 100ms);
+
+      journal.append(wal::Retire{ 1u, 2u });
+      journal.rotate();
+      journal.append(wal::Retire{ 1u, 3u });
+
+      // Снимок не сохранён, поэтому файл .old не удалён
+      journal.rotate();
+      journal.append(wal::Retire{ 1u, 4u });
+    }
+
+    THEN("the next rotation keeps it and the current file continues") {
+      const auto rotated = read(wal::Journal::rotated_path(path));
+      const auto current = read(path);
+
+      REQUIRE(rotated.size() == 1u);
+      CHECK(rotated[0].first == 1u);
+
+      REQUIRE(current.size() == 2u);
+      CHECK(current[0].first == 2u);
+      CHECK(current[1].first == 3u);
+    }
+  }
+
+  // Запись в /dev/full всегда завершается ошибкой ENOSPC
+  if (std::filesystem::exists("/dev/full")) {
+    GIVEN("a journal on a full device") {
+      std::size_t failures = 0u;
+
+      {
+        wal::Journal journal("/dev/full", 0ms);
+
+        journal.error_handler([&failures](const std::exception&) {
+          failures++;
+        });
+
+        journal.append(wal::Retire{ 1u, 2u });
+        journal.append(wal::Retire{ 1u, 3u });
+      }
+
+      THEN("the failure is reported once") {
+        CHECK(failures == 1u);
+      }
+    }
+  }
+}
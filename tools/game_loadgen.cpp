@@ -0,0 +1,472 @@
+// Нагрузочный генератор: запускает N клиентов, которые входят в игру на случайных
+// картах, с заданной частотой отправляют команды движения и запрашивают состояние игры.
+// По окончании печатает перцентили задержек и количество ошибок по каждому маршруту.
+//
+// Для воспроизводимых запусков сервер запускается без --tick-period (тестовый режим),
+// а генератор сам продвигает время запросами /api/v1/game/tick (опция --tick-period)
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <iomanip>
+#include <iostream>
+#include <optional>
+#include <random>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include <boost/asio/co_spawn.hpp>
+#include <boost/asio/detached.hpp>
+#include <boost/asio/io_context.hpp>
+#include <boost/asio/ip/tcp.hpp>
+#include <boost/asio/steady_timer.hpp>
+#include <boost/asio/strand.hpp>
+#include <boost/asio/use_awaitable.hpp>
+#include <boost/beast/core.hpp>
+#include <boost/beast/http.hpp>
+#include <boost/json.hpp>
+#include <boost/program_options.hpp>
+
+namespace {
+
+namespace net = boost::asio;
+namespace beast = boost::beast;
+namespace http = beast::http;
+namespace json = boost::json;
+namespace sys = boost::system;
+
+using tcp = net::ip::tcp;
+using clock = std::chrono::steady_clock;
+
+using namespace std::literals;
+
+struct Options {
+  std::string host { "127.0.0.1"s };
+  std::string port { "8080"s };
+
+  std::size_t clients { 100u };
+  std::size_t threads { 1u };
+  std::uint64_t seed { 1u };
+
+  std::chrono::seconds duration { 10s };
+
+  // Частота запросов одного клиента, запросов в секунду
+  double move_rate { 5.0 };
+  double state_rate { 5.0 };
+
+  // Период запросов /api/v1/game/tick. Нулевое значение - сервер сам управляет временем
+  std::chrono::milliseconds tick_period { 0ms };
+};
+
+enum class Route : std::uint8_t {
+  maps,
+  join,
+  action,
+  state,
+  tick
+};
+
+constexpr std::array ROUTE_NAMES {
+  "/api/v1/maps"sv,
+  "/api/v1/game/join"sv,
+  "/api/v1/game/player/action"sv,
+  "/api/v1/game/state"sv,
+  "/api/v1/game/tick"sv
+};
+
+// Задержки и ошибки по маршрутам. Каждый клиент собирает свою статистику,
+// в конце статистика клиентов объединяется
+class Stats {
+public:
+  void add(Route route, clock::duration latency, bool ok) {
+    auto& s = routes_[static_cast<std::size_t>(route)];
+
+    s.latencies.push_back(std::chrono::duration_cast<std::chrono::microseconds>(latency).count());
+    s.errors += ok ? 0u : 1u;
+  }
+
+  void error(Route route) {
+    routes_[static_cast<std::size_t>(route)].errors++;
+  }
+
+  void merge(const Stats& other) {
+    for (std::size_t i = 0; i < routes_.size(); i++) {
+      auto& dst = routes_[i].latencies;
+      const auto& src = other.routes_[i].latencies;
+
+      dst.insert(dst.end(), src.begin(), src.end());
+      routes_[i].errors += other.routes_[i].errors;
+    }
+  }
+
+  void print(std::ostream& out, std::chrono::duration<double> elapsed) {
+    out << std::left << std::setw(30) << "route"sv
+        << std::right << std::setw(10) << "requests"sv << std::setw(10) << "errors"sv << std::setw(10) << "rps"sv
+        << std::setw(10) << "p50,us"sv << std::setw(10) << "p90,us"sv << std::setw(10) << "p99,us"sv << std::setw(10) << "max,us"sv
+        << '\n';
+
+    for (std::size_t i = 0; i < routes_.size(); i++) {
+      auto& latencies = routes_[i].latencies;
+
+      if (latencies.empty() && routes_[i].errors == 0) {
+        continue;
+      }
+
+      std::sort(latencies.begin(), latencies.end());
+
+      const auto percentile = [&latencies](double p) -> std::int64_t {
+        if (latencies.empty()) {
+          return 0;
+        }
+
+        return latencies[static_cast<std::size_t>(p * static_cast<double>(latencies.size() - 1))];
+      };
+
+      out << std::left << std::setw(30) << ROUTE_NAMES[i]
+          << std::right << std::setw(10) << latencies.size() << std::setw(10) << routes_[i].errors
+          << std::setw(10) << std::fixed << std::setprecision(0) << static_cast<double>(latencies.size()) / elapsed.count()
+          << std::setw(10) << percentile(0.5) << std::setw(10) << percentile(0.9) << std::setw(10) << percentile(0.99)
+          << std::setw(10) << percentile(1.0)
+          << '\n';
+    }
+  }
+
+private:
+  struct RouteStats {
+    std::vector<std::int64_t> latencies;
+    std::size_t errors { 0u };
+  };
+
+  std::array<RouteStats, ROUTE_NAMES.size()> routes_;
+};
+
+// HTTP/1.1 соединение с сервером. При ошибке соединение
+// закрывается и открывается заново при следующем запросе
+class Connection {
+public:
+  Connection(net::any_io_executor executor, const tcp::resolver::results_type& endpoints, const Options& options)
+    : stream_(executor)
+    , endpoints_(endpoints)
+    , options_(options) {
+  }
+
+  // Возвращает ответ или std::nullopt при ошибке сети. Время ответа учитывается в stats
+  net::awaitable<std::optional<http::response<http::string_body>>>
+  send(Route route, http::verb method, std::string_view target, std::string body, std::string_view token, Stats& stats) {
+    http::request<http::string_body> req { method, target, 11 };
+
+    req.set(http::field::host, options_.host);
+    req.keep_alive(true);
+
+    if (!token.empty()) {
+      req.set(http::field::authorization, "Bearer "s + std::string(token));
+    }
+
+    if (!body.empty()) {
+      req.set(http::field::content_type, "application/json"sv);
+      req.body() = std::move(body);
+      req.prepare_payload();
+    }
+
+    const auto start = clock::now();
+
+    try {
+      if (!connected_) {
+        co_await stream_.async_connect(endpoints_, net::use_awaitable);
+        connected_ = true;
+      }
+
+      co_await http::async_write(stream_, req, net::use_awaitable);
+
+      http::response<http::string_body> res;
+      co_await http::async_read(stream_, buffer_, res, net::use_awaitable);
+
+      stats.add(route, clock::now() - start, res.result() == http::status::ok);
+
+      if (!res.keep_alive()) {
+        close();
+      }
+
+      co_return res;
+    } catch (const sys::system_error&) {
+      stats.error(route);
+      close();
+    }
+
+    co_return std::nullopt;
+  }
+
+private:
+  void close() {
+    sys::error_code ec;
+
+    stream_.socket().shutdown(tcp::socket::shutdown_both, ec);
+    stream_.close();
+
+    buffer_.clear();
+    connected_ = false;
+  }
+
+private:
+  beast::tcp_stream stream_;
+  beast::flat_buffer buffer_;
+
+  const tcp::resolver::results_type& endpoints_;
+  const Options& options_;
+
+  bool connected_ { false };
+};
+
+std::chrono::nanoseconds period(double rate) {
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::duration<double>(1.0 / rate));
+}
+
+net::awaitable<void> run_client(std::size_t index, const std::vector<std::string>& maps,
+                                const tcp::resolver::results_type& endpoints, const Options& options,
+                                clock::time_point deadline, Stats& stats) {
+  constexpr std::array MOVES { "L"sv, "R"sv, "U"sv, "D"sv, ""sv };
+
+  auto executor = co_await net::this_coro::executor;
+
+  Connection connection(executor, endpoints, options);
+  net::steady_timer timer(executor);
+
+  std::mt19937_64 rng(options.seed + index);
+
+  const auto& map = maps[rng() % maps.size()];
+  const auto join_body = json::serialize(json::object{ { "userName"sv, "bot"s + std::to_string(index) }, { "mapId"sv, map } });
+
+  std::string token;
+
+  while (token.empty() && clock::now() < deadline) {
+    const auto res = co_await connection.send(Route::join, http::verb::post, "/api/v1/game/join"sv, join_body, {}, stats);
+
+    if (res && res->result() == http::status::ok) {
+      token = json::parse(res->body()).as_object().at("authToken"sv).as_string().c_str();
+    } else {
+      timer.expires_after(100ms);
+      co_await timer.async_wait(net::use_awaitable);
+    }
+  }
+
+  const auto move_period = period(options.move_rate);
+  const auto state_period = period(options.state_rate);
+
+  // Клиенты начинают со сдвигом, чтобы запросы не приходили пачками
+  const auto start = clock::now() + std::chrono::nanoseconds(rng() % static_cast<std::uint64_t>(std::min(move_period, state_period).count()));
+
+  auto next_move = start;
+  auto next_state = start;
+
+  while (!token.empty()) {
+    const bool move = next_move <= next_state;
+    const auto next = move ? next_move : next_state;
+
+    if (next >= deadline) {
+      break;
+    }
+
+    timer.expires_at(next);
+    co_await timer.async_wait(net::use_awaitable);
+
+    if (move) {
+      const auto body = R"({"move":")"s + std::string(MOVES[rng() % MOVES.size()]) + R"("})"s;
+      co_await connection.send(Route::action, http::verb::post, "/api/v1/game/player/action"sv, body, token, stats);
+
+      next_move += move_period;
+    } else {
+      co_await connection.send(Route::state, http::verb::get, "/api/v1/game/state"sv, {}, token, stats);
+
+      next_state += state_period;
+    }
+  }
+}
+
+net::awaitable<void> run_ticker(const tcp::resolver::results_type& endpoints, const Options& options,
+                                clock::time_point deadline, Stats& stats) {
+  auto executor = co_await net::this_coro::executor;
+
+  Connection connection(executor, endpoints, options);
+  net::steady_timer timer(executor);
+
+  const auto body = json::serialize(json::object{ { "timeDelta"sv, options.tick_period.count() } });
+
+  for (auto next = clock::now() + options.tick_period; next < deadline; next += options.tick_period) {
+    timer.expires_at(next);
+    co_await timer.async_wait(net::use_awaitable);
+
+    co_await connection.send(Route::tick, http::verb::post, "/api/v1/game/tick"sv, body, {}, stats);
+  }
+}
+
+std::vector<std::string> fetch_maps(net::io_context& io, const tcp::resolver::results_type& endpoints, const Options& options, Stats& stats) {
+  std::vector<std::string> maps;
+
+  net::co_spawn(io, [&]() -> net::awaitable<void> {
+    Connection connection(co_await net::this_coro::executor, endpoints, options);
+
+    const auto res = co_await connection.send(Route::maps, http::verb::get, "/api/v1/maps"sv, {}, {}, stats);
+
+    if (!res || res->result() != http::status::ok) {
+      co_return;
+    }
+
+    for (const auto& map : json::parse(res->body()).as_array()) {
+      maps.emplace_back(map.at("id"sv).as_string().c_str());
+    }
+  }, net::detached);
+
+  io.run();
+  io.restart();
+
+  return maps;
+}
+
+std::optional<Options> parse_options(int argc, char* argv[]) {
+  namespace po = boost::program_options;
+
+  Options options;
+
+  std::size_t duration, tick_period;
+
+  po::options_description desc { "Allowed options"s };
+
+  desc.add_options()
+    (
+      "help,h",
+      "show help"
+    )
+    (
+      "host",
+      po::value(&options.host)->value_name("address"),
+      "set server address"
+    )
+    (
+      "port",
+      po::value(&options.port)->value_name("port"),
+      "set server port"
+    )
+    (
+      "clients,n",
+      po::value(&options.clients)->value_name("count"),
+      "set number of simulated clients"
+    )
+    (
+      "threads",
+      po::value(&options.threads)->value_name("count"),
+      "set number of threads running the clients"
+    )
+    (
+      "duration,d",
+      po::value(&duration)->value_name("seconds"),
+      "set load duration"
+    )
+    (
+      "move-rate",
+      po::value(&options.move_rate)->value_name("requests per second"),
+      "set rate of move requests of a client"
+    )
+    (
+      "state-rate",
+      po::value(&options.state_rate)->value_name("requests per second"),
+      "set rate of game state requests of a client"
+    )
+    (
+      "tick-period,t",
+      po::value(&tick_period)->value_name("milliseconds"),
+      "drive game time with /api/v1/game/tick requests (server must run without --tick-period)"
+    )
+    (
+      "seed",
+      po::value(&options.seed)->value_name("seed"),
+      "set a seed for choice of maps and moves"
+    );
+
+  po::variables_map vm;
+  po::store(po::parse_command_line(argc, argv, desc), vm);
+  po::notify(vm);
+
+  if (vm.contains("help")) {
+    std::cout << desc;
+    return std::nullopt;
+  }
+
+  if (vm.contains("duration")) {
+    options.duration = std::chrono::seconds(duration);
+  }
+
+  if (vm.contains("tick-period")) {
+    options.tick_period = std::chrono::milliseconds(tick_period);
+  }
+
+  if (options.clients == 0 || options.threads == 0 || options.move_rate <= 0.0 || options.state_rate <= 0.0) {
+    throw std::invalid_argument("Clients, threads and request rates must be positive"s);
+  }
+
+  return options;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+  try {
+    const auto options = parse_options(argc, argv);
+
+    if (!options) {
+      return EXIT_SUCCESS;
+    }
+
+    net::io_context io { static_cast<int>(options->threads) };
+
+    const auto endpoints = tcp::resolver(io).resolve(options->host, options->port);
+
+    Stats total;
+    const auto maps = fetch_maps(io, endpoints, *options, total);
+
+    if (maps.empty()) {
+      throw std::runtime_error("Unable to get maps from the server"s);
+    }
+
+    std::vector<Stats> stats(options->clients + 1);
+
+    const auto start = clock::now();
+    const auto deadline = start + options->duration;
+
+    // Каждый клиент работает на своём strand'е, поэтому его статистика не требует синхронизации
+    for (std::size_t i = 0; i < options->clients; i++) {
+      net::co_spawn(net::make_strand(io), run_client(i, maps, endpoints, *options, deadline, stats[i]), net::detached);
+    }
+
+    if (options->tick_period > 0ms) {
+      net::co_spawn(net::make_strand(io), run_ticker(endpoints, *options, deadline, stats.back()), net::detached);
+    }
+
+    std::vector<std::jthread> threads;
+
+    for (std::size_t i = 1; i < options->threads; i++) {
+      threads.emplace_back([&io] { io.run(); });
+    }
+
+    io.run();
+    threads.clear();
+
+    const std::chrono::duration<double> elapsed = clock::now() - start;
+
+    for (const auto& s : stats) {
+      total.merge(s);
+    }
+
+    std::cout << "clients: "sv << options->clients << ", maps: "sv << maps.size()
+              << ", elapsed: "sv << std::fixed << std::setprecision(2) << elapsed.count() << "s\n"sv;
+
+    total.print(std::cout, elapsed);
+  } catch (const std::exception& e) {
+    std::cerr << e.what() << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  return EXIT_SUCCESS;
+}
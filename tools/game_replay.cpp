@@ -0,0 +1,214 @@
+// Воспроизводит журнал, записанный сервером с опцией --replay-journal.
+// Тики применяются без ожидания, поэтому воспроизведение идёт с максимальной скоростью.
+// В конце печатается контрольная сумма состояния сессий, по которой можно
+// сравнить результаты до и после изменений в коде движения и коллизий
+
+#include "../src/game.hpp"
+#include "../src/json_loader.hpp"
+#include "../src/replay.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <iostream>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+#include <boost/asio/io_context.hpp>
+#include <boost/asio/post.hpp>
+#include <boost/asio/strand.hpp>
+
+namespace {
+
+namespace net = boost::asio;
+
+using namespace std::literals;
+
+using Sessions = std::unordered_map<model::GameSession::Id, std::unique_ptr<model::GameSession>>;
+
+// Количество событий, после которого выполняются накопленные задачи сессий
+constexpr std::size_t EVENTS_PER_BATCH { 4096u };
+
+struct Stats {
+  std::size_t sessions { 0u };
+  std::size_t joins { 0u };
+  std::size_t moves { 0u };
+  std::size_t ticks { 0u };
+  std::size_t reconfigurations { 0u };
+};
+
+// FNV-1a
+class Digest {
+public:
+  template <typename T>
+  void add(const T& value) noexcept {
+    unsigned char bytes[sizeof(T)];
+    std::memcpy(bytes, &value, sizeof(T));
+
+    for (const auto byte : bytes) {
+      hash_ = (hash_ ^ byte) * 0x100'0000'01B3u;
+    }
+  }
+
+  [[nodiscard]] std::uint64_t value() const noexcept {
+    return hash_;
+  }
+
+private:
+  std::uint64_t hash_ { 0xCBF2'9CE4'8422'2325u };
+};
+
+model::GameSession& find_session(Sessions& sessions, model::GameSession::Id id) {
+  const auto it = sessions.find(id);
+
+  if (it == sessions.end()) {
+    throw std::runtime_error("Journal refers to an unknown session "s + std::to_string(id));
+  }
+
+  return *it->second;
+}
+
+std::uint64_t digest(const Sessions& sessions) {
+  std::vector<model::GameSession::Id> session_ids;
+
+  for (const auto& [id, _] : sessions) {
+    session_ids.push_back(id);
+  }
+
+  std::sort(session_ids.begin(), session_ids.end());
+
+  Digest digest;
+
+  for (const auto session_id : session_ids) {
+    const auto& session = *sessions.at(session_id);
+
+    std::vector<model::Character::Id> character_ids;
+
+    for (const auto& [id, _] : session.characters()) {
+      character_ids.push_back(id);
+    }
+
+    std::sort(character_ids.begin(), character_ids.end());
+
+    digest.add(session_id);
+
+    for (const auto id : character_ids) {
+      const auto& character = *session.characters().at(id);
+
+      digest.add(id);
+      digest.add(character.position().x);
+      digest.add(character.position().y);
+      digest.add(character.score());
+    }
+
+    session.lost_objects().for_each([&digest](model::LootPool::Handle, const model::Loot& loot) {
+      digest.add(loot.id);
+      digest.add(loot.position.x);
+      digest.add(loot.position.y);
+    });
+  }
+
+  return digest.value();
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+  if (argc != 3) {
+    std::cerr << "Usage: game_replay <config-file> <journal-file>"sv << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  try {
+    replay::Reader reader(argv[2]);
+
+    auto game = json_loader::load_game(argv[1], reader.randomize_spawn(), 0u);
+
+    net::io_context io;
+    game.io_context(io);
+
+    Sessions sessions;
+    Stats stats;
+
+    const auto start = std::chrono::steady_clock::now();
+
+    for (std::size_t events = 1; auto event = reader.next(); events++) {
+      if (const auto e = std::get_if<replay::SessionCreated>(&*event)) {
+        const auto map = game.find_map(model::Map::Id(e->map_id));
+
+        if (!map) {
+          throw std::runtime_error("Journal refers to an unknown map "s + e->map_id);
+        }
+
+        auto cfg = game.session_config(*map);
+        cfg.seed = e->seed;
+
+        sessions.emplace(e->session, std::make_unique<model::GameSession>(e->session, cfg, *map, net::make_strand(io)));
+        stats.sessions++;
+      } else if (const auto e = std::get_if<replay::Join>(&*event)) {
+        auto& session = find_session(sessions, e->session);
+        auto dog = model::create_character<model::Dog>(e->name, session.config().bag_capacity);
+
+        net::post(session.strand(), [&session, id = e->character, dog = std::move(dog)]() mutable {
+          session.join(id, std::move(dog));
+        });
+
+        stats.joins++;
+      } else if (const auto e = std::get_if<replay::Move>(&*event)) {
+        auto& session = find_session(sessions, e->session);
+        const auto direction = static_cast<model::Character::Direction::Direct>(e->direction);
+
+        net::post(session.strand(), [&session, id = e->character, direction] {
+          session.move_character(id, direction);
+        });
+
+        stats.moves++;
+      } else if (const auto e = std::get_if<replay::Tick>(&*event)) {
+        auto& session = find_session(sessions, e->session);
+
+        net::post(session.strand(), [&session, delta = e->delta, spawned = e->spawned] {
+          session.tick(delta, spawned);
+        });
+
+        stats.ticks++;
+      } else if (const auto e = std::get_if<replay::Reconfigure>(&*event)) {
+        auto& session = find_session(sessions, e->session);
+        auto cfg = session.config();
+
+        cfg.max_players = e->max_players;
+        cfg.bag_capacity = e->bag_capacity;
+        cfg.characters_speed = e->speed;
+        cfg.retirement_time = std::chrono::milliseconds(e->retirement_time);
+
+        net::post(session.strand(), [&session, cfg = std::move(cfg)]() mutable {
+          session.reconfigure(std::move(cfg));
+        });
+
+        stats.reconfigurations++;
+      }
+
+      if (events % EVENTS_PER_BATCH == 0) {
+        io.run();
+        io.restart();
+      }
+    }
+
+    io.run();
+
+    const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+    std::cout << "sessions: "sv << stats.sessions << '\n'
+              << "joins: "sv << stats.joins << '\n'
+              << "moves: "sv << stats.moves << '\n'
+              << "ticks: "sv << stats.ticks << '\n'
+              << "reconfigurations: "sv << stats.reconfigurations << '\n'
+              << "elapsed: "sv << elapsed.count() << "s\n"sv
+              << "digest: "sv << std::hex << digest(sessions) << std::endl;
+  } catch (const std::exception& e) {
+    std::cerr << e.what() << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  return EXIT_SUCCESS;
+}